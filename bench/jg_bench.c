@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+// Usage: jg_bench [section]...
+// Runs every section if none is named. Each timing is the best of BENCH_RUN_C
+// runs. To compare with an older revision, build this file against that
+// revision's libjgrandson.a (sections the older API lacks won't compile).
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime(), strdup()
+
+#include <jgrandson.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_RUN_C 5
+
+static double now_sec(
+    void
+) {
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_fail(
+    jg_t * jg,
+    char const * what
+) {
+    fprintf(stderr, "%s failed: %s\n", what, jg_get_err_str(jg, NULL, NULL));
+    exit(1);
+}
+
+// Lower *min_sec to the time elapsed since start if that is less
+static void set_min_sec(
+    double start,
+    double * min_sec
+) {
+    double sec = now_sec() - start;
+    if (sec < *min_sec) {
+        *min_sec = sec;
+    }
+}
+
+// A buffer that grows as text is appended to it
+struct bench_text {
+    char * str;
+    size_t byte_c;
+    size_t size;
+};
+
+static void append_text(
+    struct bench_text * text,
+    char const * str
+) {
+    size_t byte_c = strlen(str);
+    if (text->byte_c + byte_c + 1 > text->size) {
+        text->size = 2 * (text->size + byte_c + 1);
+        text->str = realloc(text->str, text->size);
+        if (!text->str) {
+            fprintf(stderr, "realloc() failed\n");
+            exit(1);
+        }
+    }
+    memcpy(text->str + text->byte_c, str, byte_c + 1);
+    text->byte_c += byte_c;
+}
+
+//##############################################################################
+//## depth: parse throughput by nesting depth ##################################
+
+#define BENCH_DEPTH_BYTE_C 8000000
+
+// A root array of chains of arrays nested depth deep, e.g., "[[[1]], [[1]]]"
+static void print_depth_json_text(
+    struct bench_text * text,
+    size_t depth
+) {
+    char chain[512];
+    memset(chain, '[', depth);
+    chain[depth] = '1';
+    memset(chain + depth + 1, ']', depth);
+    chain[2 * depth + 1] = '\0';
+    append_text(text, "[");
+    while (text->byte_c < BENCH_DEPTH_BYTE_C) {
+        append_text(text, text->byte_c > 1 ? ", " : "");
+        append_text(text, chain);
+    }
+    append_text(text, "]");
+}
+
+static void bench_depth(
+    jg_t * jg
+) {
+    printf("depth: a root array of %d bytes of nested arrays\n",
+        BENCH_DEPTH_BYTE_C);
+    jg_reinit(jg);
+    if (jg_parse_set_opt(jg, NULL)) {
+        bench_fail(jg, "jg_parse_set_opt()");
+    }
+    for (size_t depth = 1; depth <= 64; depth *= 2) {
+        struct bench_text text = {0};
+        print_depth_json_text(&text, depth);
+        double sec = 1e9;
+        for (size_t run = 0; run < BENCH_RUN_C; run++) {
+            jg_reinit(jg);
+            double start = now_sec();
+            if (jg_parse_callerstr(jg, text.str, text.byte_c)) {
+                bench_fail(jg, "jg_parse_callerstr()");
+            }
+            set_min_sec(start, &sec);
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "depth %zu", depth);
+        printf("  %-36s%8.1f ms %7.1f MB/s\n", label, sec * 1e3,
+            text.byte_c / sec / 1e6);
+        free(text.str);
+    }
+}
+
+//##############################################################################
+//## keys: jg_obj_get_int() by object size #####################################
+
+#define BENCH_KEYS_LOOKUP_C 2000000
+
+static size_t const bench_key_cs[] = {4, 16, 32, 64, 128, 1000};
+
+// Time getting every key of an object of key_c keys, in order, round after
+// round; of which the 1st also builds the key index (if any).
+static double get_key_ns(
+    jg_t * jg,
+    size_t key_c,
+    char (* keys)[16]
+) {
+    jg_obj_get_t * obj = NULL;
+    if (jg_root_get_obj(jg, NULL, &obj)) {
+        bench_fail(jg, "jg_root_get_obj()");
+    }
+    size_t round_c = BENCH_KEYS_LOOKUP_C / key_c;
+    double sec = 1e9;
+    for (size_t run = 0; run < BENCH_RUN_C; run++) {
+        double start = now_sec();
+        for (size_t round = 0; round < round_c; round++) {
+            for (size_t i = 0; i < key_c; i++) {
+                int v = 0;
+                if (jg_obj_get_int(jg, obj, keys[i], NULL, &v) ||
+                    v != (int) i) {
+                    bench_fail(jg, "jg_obj_get_int()");
+                }
+            }
+        }
+        set_min_sec(start, &sec);
+    }
+    return sec * 1e9 / (round_c * key_c);
+}
+
+static void bench_keys(
+    jg_t * jg
+) {
+    static char keys[1000][16];
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+    }
+    printf("keys: %d lookups of every key of an object\n",
+        BENCH_KEYS_LOOKUP_C);
+    for (size_t k = 0; k < sizeof(bench_key_cs) / sizeof(*bench_key_cs);
+        k++) {
+        size_t key_c = bench_key_cs[k];
+        struct bench_text text = {0};
+        append_text(&text, "{");
+        for (size_t i = 0; i < key_c; i++) {
+            char pair[32];
+            snprintf(pair, sizeof(pair), "%s\"%s\": %zu", i ? ", " : "",
+                keys[i], i);
+            append_text(&text, pair);
+        }
+        append_text(&text, "}");
+        for (size_t tape = 0; tape < 2; tape++) {
+            jg_reinit(jg);
+            if (jg_parse_set_opt(jg, &(jg_opt_parse){.tape = tape})) {
+                bench_fail(jg, "jg_parse_set_opt()");
+            }
+            if (jg_parse_callerstr(jg, text.str, text.byte_c)) {
+                bench_fail(jg, "jg_parse_callerstr()");
+            }
+            char label[64];
+            snprintf(label, sizeof(label), "%zu keys%s", key_c,
+                tape ? ", tape" : "");
+            printf("  %-36s%8.1f ns/get\n", label,
+                get_key_ns(jg, key_c, keys));
+        }
+        free(text.str);
+    }
+}
+
+//##############################################################################
+//## flo: jg_arr_get_double() vs strtod() ######################################
+
+#define BENCH_FLO_C 1000000
+
+// Geo-style coordinates with 6 to 15 significant digits
+static void print_flo_json_text(
+    struct bench_text * text,
+    char * * nums // Null-terminated copies, as strtod() needs them
+) {
+    srand(17);
+    append_text(text, "[");
+    for (size_t i = 0; i < BENCH_FLO_C; i++) {
+        char num[32];
+        snprintf(num, sizeof(num), "%.*f", 4 + rand() % 10,
+            (rand() - RAND_MAX / 2) / (double) RAND_MAX * 360.0);
+        nums[i] = strdup(num);
+        append_text(text, i ? ", " : "");
+        append_text(text, num);
+    }
+    append_text(text, "]");
+}
+
+static void bench_flo(
+    jg_t * jg
+) {
+    static char * nums[BENCH_FLO_C];
+    struct bench_text text = {0};
+    print_flo_json_text(&text, nums);
+    jg_opt_parse const opts[] = {{0}, {.decode_numbers = true}};
+    double sum = 0.0; // Keep the conversions from being optimized away.
+    double strtod_sec = 1e9;
+    double parse_sec[2] = {1e9, 1e9};
+    double get_sec[2] = {1e9, 1e9};
+    for (size_t run = 0; run < BENCH_RUN_C; run++) {
+        double start = now_sec();
+        for (size_t i = 0; i < BENCH_FLO_C; i++) {
+            sum += strtod(nums[i], NULL);
+        }
+        set_min_sec(start, &strtod_sec);
+        for (size_t o = 0; o < 2; o++) {
+            jg_reinit(jg);
+            if (jg_parse_set_opt(jg, opts + o)) {
+                bench_fail(jg, "jg_parse_set_opt()");
+            }
+            start = now_sec();
+            if (jg_parse_callerstr(jg, text.str, text.byte_c)) {
+                bench_fail(jg, "jg_parse_callerstr()");
+            }
+            set_min_sec(start, parse_sec + o);
+            jg_arr_get_t * arr = NULL;
+            size_t elem_c = 0;
+            if (jg_root_get_arr(jg, NULL, &arr, &elem_c)) {
+                bench_fail(jg, "jg_root_get_arr()");
+            }
+            start = now_sec();
+            for (size_t i = 0; i < elem_c; i++) {
+                double v = 0.0;
+                if (jg_arr_get_double(jg, arr, i, &v)) {
+                    bench_fail(jg, "jg_arr_get_double()");
+                }
+                sum += v;
+            }
+            set_min_sec(start, get_sec + o);
+        }
+    }
+    printf("flo: %d doubles (%zu bytes of JSON text)\n", BENCH_FLO_C,
+        text.byte_c);
+    printf("  %-36s%8.1f ms\n", "strtod()", strtod_sec * 1e3);
+    for (size_t o = 0; o < 2; o++) {
+        char const * mode = o ? ", decode_numbers" : "";
+        char label[64];
+        snprintf(label, sizeof(label), "parse%s", mode);
+        printf("  %-36s%8.1f ms\n", label, parse_sec[o] * 1e3);
+        snprintf(label, sizeof(label), "jg_arr_get_double()%s", mode);
+        printf("  %-36s%8.1f ms\n", label, get_sec[o] * 1e3);
+    }
+    printf("  (checksum %g)\n", sum);
+    for (size_t i = 0; i < BENCH_FLO_C; i++) {
+        free(nums[i]);
+    }
+    free(text.str);
+}
+
+//##############################################################################
+//## parallel: .thread_c 0 vs 4 ################################################
+
+#define BENCH_PARALLEL_RECORD_C 300000
+
+static void print_parallel_json_text(
+    struct bench_text * text
+) {
+    append_text(text, "[");
+    for (size_t i = 0; i < BENCH_PARALLEL_RECORD_C; i++) {
+        char record[256];
+        snprintf(record, sizeof(record), "%s{\"id\": %zu, \"name\": \"user "
+            "%zu\", \"active\": %s, \"score\": %zu.%zu, \"tags\": [\"a\", "
+            "\"b\\n\", null], \"pos\": {\"x\": %zu, \"y\": -%zu}}", i ? ",\n" :
+            "", i, i, i % 3 ? "true" : "false", i % 1000, i % 7, i % 360,
+            i % 180);
+        append_text(text, record);
+    }
+    append_text(text, "]");
+}
+
+// Without as many CPU cores as threads, this only shows the overhead.
+static void bench_parallel(
+    jg_t * jg
+) {
+    struct bench_text text = {0};
+    print_parallel_json_text(&text);
+    printf("parallel: a root array of %d objects (%zu bytes of JSON text)\n",
+        BENCH_PARALLEL_RECORD_C, text.byte_c);
+    for (size_t tape = 0; tape < 2; tape++) {
+        for (size_t thread_c = 0; thread_c <= 4; thread_c += 4) {
+            jg_opt_parse const opt = {.tape = tape, .thread_c = thread_c};
+            double sec = 1e9;
+            for (size_t run = 0; run < BENCH_RUN_C; run++) {
+                jg_reinit(jg);
+                if (jg_parse_set_opt(jg, &opt)) {
+                    bench_fail(jg, "jg_parse_set_opt()");
+                }
+                double start = now_sec();
+                if (jg_parse_callerstr(jg, text.str, text.byte_c)) {
+                    bench_fail(jg, "jg_parse_callerstr()");
+                }
+                set_min_sec(start, &sec);
+            }
+            char label[64];
+            snprintf(label, sizeof(label), "thread_c %zu%s", thread_c,
+                tape ? ", tape" : "");
+            printf("  %-36s%8.1f ms %7.1f MB/s\n", label, sec * 1e3,
+                text.byte_c / sec / 1e6);
+        }
+    }
+    free(text.str);
+}
+
+//##############################################################################
+//## main() ####################################################################
+
+static struct {
+    char const * name;
+    void (* func)(jg_t * jg);
+} const bench_sections[] = {
+    {"depth", bench_depth},
+    {"keys", bench_keys},
+    {"flo", bench_flo},
+    {"parallel", bench_parallel}
+};
+
+int main(
+    int argc,
+    char * * argv
+) {
+    jg_t * jg = jg_init();
+    if (!jg) {
+        fprintf(stderr, "jg_init() failed\n");
+        return 1;
+    }
+    size_t section_c = sizeof(bench_sections) / sizeof(*bench_sections);
+    for (size_t i = 0; i < section_c; i++) {
+        bool is_named = argc < 2;
+        for (int j = 1; j < argc; j++) {
+            is_named |= !strcmp(argv[j], bench_sections[i].name);
+        }
+        if (is_named) {
+            bench_sections[i].func(jg);
+        }
+    }
+    jg_free(jg);
+    return 0;
+}
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+struct jg_doc {
+    struct jg_atomic ref_c; // The document is freed when this drops to 0.
+    jg_t * owner; // The session that parsed the DOM, and now owns it
+};
+
+// Readers of a slot count themselves under the parity of the slot's epoch for
+// as long as they are between loading .doc and acquiring a reference to it.
+struct jg_doc_slot {
+    struct jg_atomic doc; // jg_doc_t *
+    struct jg_atomic epoch;
+    struct jg_atomic getter_cs[2];
+    struct jg_atomic is_publishing; // Publishers take turns.
+};
+
+// Hand the DOM of jg over to a new session that the document owns, which saves
+// having to copy anything; and leave jg as if it was jg_reinit(), except that
+// any buffers it retained for reuse belong to the document now.
+jg_ret jg_freeze(
+    jg_t * jg,
+    jg_doc_t * * doc
+) {
+    if (jg->state != JG_STATE_GET || jg->doc) {
+        return jg->ret = JG_E_STATE_NOT_GET;
+    }
+    JG_GUARD(complete_dom(jg));
+    *doc = malloc(sizeof(struct jg_doc));
+    if (!*doc) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    jg_t * owner = jg_init();
+    if (!owner) {
+        free(*doc);
+        *doc = NULL;
+        return jg->ret = JG_E_MALLOC;
+    }
+    *owner = *jg;
+    // Error strings stay with jg, as does its place in any pool.
+    owner->err_str = NULL;
+    owner->err_str_needs_free = false;
+    owner->custom_err_str = NULL;
+    owner->pool_next = NULL;
+    struct jg_opt_parse opt_parse = jg->opt_parse;
+    if (jg->tape_is_image) {
+        opt_parse.tape = jg->own_opt_tape;
+    }
+    char * err_str = jg->err_str;
+    bool err_str_needs_free = jg->err_str_needs_free;
+    char * custom_err_str = jg->custom_err_str;
+    jg_t * pool_next = jg->pool_next;
+    memset(jg, 0, sizeof(*jg));
+    jg->opt_parse = opt_parse;
+    jg->err_str = err_str;
+    jg->err_str_needs_free = err_str_needs_free;
+    jg->custom_err_str = custom_err_str;
+    jg->pool_next = pool_next;
+    init_atomic(&(*doc)->ref_c, 1);
+    (*doc)->owner = owner;
+    return jg->ret = JG_OK;
+}
+
+jg_doc_t * jg_doc_acquire(
+    jg_doc_t * doc
+) {
+    add_atomic(&doc->ref_c, 1);
+    return doc;
+}
+
+void jg_doc_release(
+    jg_doc_t * doc
+) {
+    if (doc && sub_atomic(&doc->ref_c, 1) == 1) {
+        jg_free(doc->owner);
+        free(doc);
+    }
+}
+
+// Share the DOM of the document, rather than parse anything: only the members
+// that getters read are copied, while error state stays the session's own.
+jg_ret jg_parse_doc(
+    jg_t * jg,
+    jg_doc_t * doc
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    // The tape and object index slots of the document take the place of those
+    // the session retained (if any), which would otherwise be lost.
+    free(jg->tape);
+    free(jg->obj_indexes);
+    jg_t const * owner = doc->owner;
+    jg->root_in = owner->root_in;
+    jg->json_callertext = owner->json_callertext;
+    jg->json_over = owner->json_over;
+    jg->tape = owner->tape;
+    jg->tape_c = owner->tape_c;
+    jg->tape_size = 0;
+    jg->obj_indexes = owner->obj_indexes;
+    jg->obj_index_c = owner->obj_index_c;
+    jg->obj_index_slot_c = owner->obj_index_slot_c;
+    jg->hash_seed = owner->hash_seed;
+    jg->decodes_nums = owner->decodes_nums;
+    jg->unescapes_strs = owner->unescapes_strs;
+    jg->own_opt_tape = jg->opt_parse.tape;
+    jg->opt_parse.tape = owner->opt_parse.tape;
+    jg->doc = jg_doc_acquire(doc);
+    jg->state = JG_STATE_GET;
+    return jg->ret = JG_OK;
+}
+
+void stop_reading_doc(
+    jg_t * jg
+) {
+    jg->json_callertext = NULL;
+    jg->tape = NULL;
+    jg->tape_c = 0;
+    jg->obj_indexes = NULL;
+    jg->obj_index_c = 0;
+    jg->obj_index_slot_c = 0;
+    jg->opt_parse.tape = jg->own_opt_tape;
+    jg_doc_release(jg->doc);
+    jg->doc = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_doc_slot_t: publishing documents read-copy-update (RCU) style
+
+jg_doc_slot_t * jg_doc_slot_init(
+    void
+) {
+    jg_doc_slot_t * slot = malloc(sizeof(struct jg_doc_slot));
+    if (!slot) {
+        return NULL;
+    }
+    init_atomic(&slot->doc, (uintptr_t) NULL);
+    init_atomic(&slot->epoch, 0);
+    init_atomic(slot->getter_cs, 0);
+    init_atomic(slot->getter_cs + 1, 0);
+    init_atomic(&slot->is_publishing, false);
+    return slot;
+}
+
+void jg_doc_slot_free(
+    jg_doc_slot_t * slot
+) {
+    jg_doc_release((jg_doc_t *) load_atomic(&slot->doc));
+    free(slot);
+}
+
+// Getters that loaded .doc before it was replaced are counted in either of
+// .getter_cs until they have acquired it: wait for both counts to drop to 0 at
+// least once. Flipping the epoch's parity before each wait keeps new getters
+// from being counted in the count waited for; so that the wait is short, even
+// if getters never let up.
+static void wait_for_getters(
+    jg_doc_slot_t * slot
+) {
+    for (size_t i = 0; i < 2; i++) {
+        uintptr_t parity = add_atomic(&slot->epoch, 1) % 2;
+        while (load_atomic(slot->getter_cs + parity)) {
+            yield_thread();
+        }
+    }
+}
+
+void jg_doc_slot_publish(
+    jg_doc_slot_t * slot,
+    jg_doc_t * doc
+) {
+    while (exchange_atomic(&slot->is_publishing, true)) {
+        yield_thread();
+    }
+    jg_doc_t * old_doc =
+        (jg_doc_t *) exchange_atomic(&slot->doc, (uintptr_t) doc);
+    if (old_doc) {
+        wait_for_getters(slot);
+    }
+    store_atomic(&slot->is_publishing, false);
+    jg_doc_release(old_doc);
+}
+
+jg_doc_t * jg_doc_slot_get(
+    jg_doc_slot_t * slot
+) {
+    struct jg_atomic * getter_c = slot->getter_cs +
+        load_atomic(&slot->epoch) % 2;
+    add_atomic(getter_c, 1);
+    jg_doc_t * doc = (jg_doc_t *) load_atomic(&slot->doc);
+    if (doc) {
+        jg_doc_acquire(doc);
+    }
+    sub_atomic(getter_c, 1);
+    return doc;
+}
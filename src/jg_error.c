@@ -125,7 +125,20 @@ static char const * err_strs[] = {
 /*71*/ "Expected a number that can be converted to a floating point type",
 /*72*/ "Expected a number within the range representable by type \"float",
 /*73*/ "Expected a number within the range representable by type \"double",
-/*74*/ "Expected a number within the range representable by type \"long double"
+/*74*/ "Expected a number within the range representable by type \"long double",
+// parsing errors (with JSON text context)
+/*75*/ "The JSON text or this value exceeds the size limits of the tape DOM "
+       "(see jg_opt_parse)",
+/*76*/ "Arrays and objects are nested deeper than the maximum depth allowed "
+       "(see jg_opt_parse)",
+// external errors with errno
+/*77*/ "Failed to fstat() the JSON file: ",
+/*78*/ "Failed to mmap() the JSON file: ",
+/*79*/ "Failed to set up a thread for parsing: ",
+/*80*/ "Failed to set up inotify to watch the JSON file: ",
+// image errors
+/*81*/ "jg_save_image() can only save a DOM parsed with the .tape parse option",
+/*82*/ "Not a Jgrandson image file (or saved on an incompatible platform)"
 };
 
 static jg_ret get_print_byte_c(
@@ -206,7 +219,18 @@ static char const * get_contextual_err_str(
     char const * err_mark_before,
     char const * err_mark_after
 ) {
-    size_t line_i = 1;
+    // Values parsed from JSON text fed by jg_parse_feed() may still refer to an
+    // older (but otherwise identical) buffer than the current one.
+    for (struct jg_feed_buf const * buf = jg->feed_buf; buf; buf = buf->prev) {
+        uintptr_t cur = (uintptr_t) jg->json_cur;
+        uintptr_t text = (uintptr_t) buf->text;
+        if (cur >= text && cur <= text + buf->byte_c) {
+            jg->json_cur = jg->json_text + (cur - text);
+            break;
+        }
+    }
+    // An NDJSON record is a single line of the NDJSON text.
+    size_t line_i = jg->ndjson.text ? jg->ndjson.line_i : 1;
     size_t char_i = 1;
     char const * err_line = jg->json_text;
     for (char const * c = err_line; c < jg->json_cur;) {
@@ -237,12 +261,15 @@ static char const * get_contextual_err_str(
     char err_char[4 + 1] = {0}; // Accomodate max 4 byte UTF-8 chars
     memcpy(err_char, jg->json_cur, err_char_size);
 
-    char const * newline_after = jg->json_cur + err_char_size;
-    while (*newline_after != '\r' && *newline_after != '\n' &&
-        ++newline_after < jg->json_over);
+    char const * context_after_start = jg->json_cur + err_char_size;
+    char const * newline_after = context_after_start;
+    while (newline_after < jg->json_over &&
+        *newline_after != '\r' && *newline_after != '\n') {
+        newline_after++;
+    }
     char context_after[JG_CONTEXT_AFTER_MAX_STRLEN + 1] = {0};
-    memcpy(context_after, jg->json_cur + err_char_size,
-        JG_MIN(JG_CONTEXT_AFTER_MAX_STRLEN, newline_after - jg->json_cur - 1));
+    memcpy(context_after, context_after_start, JG_MIN(
+        JG_CONTEXT_AFTER_MAX_STRLEN, newline_after - context_after_start));
 
     char err_mark_before_default[] = "\033[0;31m"; // ANSI escape code: red
     char err_mark_after_default[] = "\033[0m"; // ANSI escapse code: no color
@@ -316,11 +343,17 @@ char const * jg_get_err_str(
     case JG_E_NEWLOCALE:
     case JG_E_FREAD:
     case JG_E_FWRITE:
+    case JG_E_IMAGE_NOT_TAPE:
+    case JG_E_IMAGE_INVALID:
         return jg->static_err_str = err_strs[jg->ret];
     case JG_E_ERRNO_FOPEN:
     case JG_E_ERRNO_FCLOSE:
     case JG_E_ERRNO_FSEEKO:
     case JG_E_ERRNO_FTELLO:
+    case JG_E_ERRNO_FSTAT:
+    case JG_E_ERRNO_MMAP:
+    case JG_E_ERRNO_THREAD:
+    case JG_E_ERRNO_INOTIFY:
         return get_errno_str(jg);
     case JG_E_GET_ARR_INDEX_OVER:
     case JG_E_GET_ARR_TOO_SHORT:
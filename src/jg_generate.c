@@ -65,72 +65,102 @@ do { \
     JG_PUT_INDENT; \
 } while(0)
 
-static void generate_json_text(
-    struct jg_val_out const * v,
+#define JG_PUT_KEY(_key) \
+do { \
+    JG_PUT('"'); \
+    JG_PUT_STR(_key); \
+    JG_PUT('"'); \
+    JG_PUT(':'); \
+    JG_PUT_SPACE; \
+} while (0)
+
+// Generate the JSON text of jg->root_out without recursing: each array or
+// object that is still open is tracked as a frame on jg->frames instead.
+static jg_ret generate_json_text(
+    jg_t * jg,
     char * const json_text,
     size_t * json_i,
-    size_t * indent,
     jg_opt_whitespace * opt
 ) {
-    switch (v->type) {
-    case JG_TYPE_NULL:
-        JG_PUT('n'); JG_PUT('u'); JG_PUT('l'); JG_PUT('l');
-        return;
-    case JG_TYPE_BOOL:
-        if (v->bool_is_true) {
-            JG_PUT('t'); JG_PUT('r'); JG_PUT('u'); JG_PUT('e');
-        } else {
-            JG_PUT('f'); JG_PUT('a'); JG_PUT('l'); JG_PUT('s'); JG_PUT('e');
-        }
-        return;
-    case JG_TYPE_NUM:
-        JG_PUT_STR(v->str);
-        return;
-    case JG_TYPE_STR:
-        JG_PUT('"');
-        JG_PUT_STR(v->str);
-        JG_PUT('"');
-        return;
-    case JG_TYPE_ARR:
-        JG_PUT('[');
-        if (v->arr) {
-            struct jg_arr_node * node = v->arr;
-            generate_json_text(&node->elem, json_text, json_i, indent, opt);
-            while ((node = node->next)) {
-                JG_PUT(',');
-                JG_PUT_SPACE;
-                generate_json_text(&node->elem, json_text, json_i, indent, opt);
+    size_t * indent = (size_t []){0};
+    struct jg_val_out const * v = &jg->root_out;
+    jg->frame_c = 0;
+    for (;;) {
+        struct jg_frame * frame = NULL;
+        switch (v->type) {
+        case JG_TYPE_NULL:
+            JG_PUT('n'); JG_PUT('u'); JG_PUT('l'); JG_PUT('l');
+            break;
+        case JG_TYPE_BOOL:
+            if (v->bool_is_true) {
+                JG_PUT('t'); JG_PUT('r'); JG_PUT('u'); JG_PUT('e');
+            } else {
+                JG_PUT('f'); JG_PUT('a'); JG_PUT('l'); JG_PUT('s'); JG_PUT('e');
             }
-        }
-        JG_PUT(']');
-        return;
-    case JG_TYPE_OBJ: default:
-        JG_PUT('{');
-        if (v->obj) {
-            struct jg_obj_node * node = v->obj;
-            JG_PUT_NEWLINE;
-            JG_PUT_INDENT_INCR;
+            break;
+        case JG_TYPE_NUM:
+            JG_PUT_STR(v->str);
+            break;
+        case JG_TYPE_STR:
             JG_PUT('"');
-            JG_PUT_STR(node->key);
+            JG_PUT_STR(v->str);
             JG_PUT('"');
-            JG_PUT(':');
-            JG_PUT_SPACE;
-            generate_json_text(&node->val, json_text, json_i, indent, opt);
-            while ((node = node->next)) {
-                JG_PUT(',');
+            break;
+        case JG_TYPE_ARR:
+            JG_PUT('[');
+            if (v->arr) {
+                JG_GUARD(push_frame(jg, &frame));
+                frame->type = JG_TYPE_ARR;
+                frame->arr_node = v->arr;
+                v = &v->arr->elem;
+                continue; // Generate the 1st element
+            }
+            JG_PUT(']');
+            break;
+        case JG_TYPE_OBJ: default:
+            JG_PUT('{');
+            if (v->obj) {
+                JG_GUARD(push_frame(jg, &frame));
+                frame->type = JG_TYPE_OBJ;
+                frame->obj_node = v->obj;
+                JG_PUT_NEWLINE;
+                JG_PUT_INDENT_INCR;
+                JG_PUT_KEY(v->obj->key);
+                v = &v->obj->val;
+                continue; // Generate the 1st value
+            }
+            JG_PUT('}');
+        }
+        // Value v is complete: move on to its next sibling, or close as many
+        // arrays and objects as have no next sibling left.
+        for (;;) {
+            if (!jg->frame_c) {
+                return JG_OK;
+            }
+            frame = jg->frames + jg->frame_c - 1;
+            if (frame->type == JG_TYPE_ARR) {
+                if ((frame->arr_node = frame->arr_node->next)) {
+                    JG_PUT(',');
+                    JG_PUT_SPACE;
+                    v = &frame->arr_node->elem;
+                    break; // Generate the next element
+                }
+                JG_PUT(']');
+            } else {
+                if ((frame->obj_node = frame->obj_node->next)) {
+                    JG_PUT(',');
+                    JG_PUT_NEWLINE;
+                    JG_PUT_INDENT;
+                    JG_PUT_KEY(frame->obj_node->key);
+                    v = &frame->obj_node->val;
+                    break; // Generate the next value
+                }
                 JG_PUT_NEWLINE;
-                JG_PUT_INDENT;
-                JG_PUT('"');
-                JG_PUT_STR(node->key);
-                JG_PUT('"');
-                JG_PUT(':');
-                JG_PUT_SPACE;
-                generate_json_text(&node->val, json_text, json_i, indent, opt);
+                JG_PUT_INDENT_DECR;
+                JG_PUT('}');
             }
-            JG_PUT_NEWLINE;
-            JG_PUT_INDENT_DECR;
+            jg->frame_c--;
         }
-        JG_PUT('}');
     }
 }
 
@@ -157,7 +187,7 @@ jg_ret jg_generate_str(
         opt->indent = defa.indent;
     }
     size_t byte_c = 0;
-    generate_json_text(&jg->root_out, NULL, &byte_c, (size_t []){0}, opt);
+    JG_GUARD(generate_json_text(jg, NULL, &byte_c, opt));
     byte_c += !opt->no_newline_before_eof;
     if (_byte_c) {
         *_byte_c = byte_c;
@@ -170,8 +200,8 @@ jg_ret jg_generate_str(
         (*json_text)[byte_c - 1] = '\n';
     };
     (*json_text)[byte_c] = '\0';
-    generate_json_text(&jg->root_out, *json_text, (size_t []){0},
-        (size_t []){0}, opt);
+    // Can't fail: jg->frames already grew large enough during the 1st pass.
+    generate_json_text(jg, *json_text, (size_t []){0}, opt);
     return JG_OK;
 }
 
@@ -198,7 +228,7 @@ jg_ret jg_generate_callerstr(
         opt->indent = defa.indent;
     }
     size_t byte_c = 0;
-    generate_json_text(&jg->root_out, json_text, &byte_c, (size_t []){0}, opt);
+    JG_GUARD(generate_json_text(jg, json_text, &byte_c, opt));
     if (!opt->no_newline_before_eof) {
         if (json_text) {
             json_text[byte_c] = '\n';
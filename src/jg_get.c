@@ -25,6 +25,147 @@ static jg_ret check_state_get(
     }
 }
 
+// In tape mode (see jgrandson_internal.h), jg_arr and jg_obj pointers are tape
+// entry pointers in disguise. The following helpers abstract over that.
+
+static char const * get_arr_json(
+    jg_t * jg,
+    struct jg_arr const * arr
+) {
+    return jg->opt_parse.tape ?
+        tape_get_json(jg, (uint64_t const *) arr) : arr->json;
+}
+
+static size_t get_arr_elem_c(
+    jg_t * jg,
+    struct jg_arr const * arr
+) {
+    return jg->opt_parse.tape ?
+        JG_TAPE_AUX(*(uint64_t const *) arr) : arr->elem_c;
+}
+
+static struct jg_val_in const * get_arr_elem( // The caller checks arr_i first
+    jg_t * jg,
+    struct jg_arr const * arr,
+    size_t arr_i
+) {
+    if (!jg->opt_parse.tape) {
+        return arr->elems + arr_i;
+    }
+    tape_get_val(jg, tape_get_elem(jg, (uint64_t const *) arr, arr_i),
+        &jg->tape_val);
+    return &jg->tape_val;
+}
+
+static char const * get_obj_json(
+    jg_t * jg,
+    struct jg_obj const * obj
+) {
+    return jg->opt_parse.tape ?
+        tape_get_json(jg, (uint64_t const *) obj) : obj->json;
+}
+
+static size_t get_obj_pair_c(
+    jg_t * jg,
+    struct jg_obj const * obj
+) {
+    return jg->opt_parse.tape ?
+        JG_TAPE_AUX(*(uint64_t const *) obj) : obj->pair_c;
+}
+
+// Iterate over the keys of an object: start with *pair set to NULL, and repeat
+// until NULL is returned. (In tape mode, *pair actually iterates over keys.)
+static struct jg_pair const * get_next_pair(
+    jg_t * jg,
+    struct jg_obj const * obj,
+    struct jg_pair const * pair,
+    struct jg_val_in * key
+) {
+    if (!jg->opt_parse.tape) {
+        pair = pair ? pair + 1 : obj->pairs;
+        if (pair == obj->pairs + obj->pair_c) {
+            return NULL;
+        }
+        *key = pair->key;
+        return pair;
+    }
+    uint64_t const * entry = (uint64_t const *) pair;
+    entry = entry ? tape_get_next(entry + 1) : (uint64_t const *) obj + 2;
+    if (entry == (uint64_t const *) obj + ((uint64_t const *) obj)[1]) {
+        return NULL;
+    }
+    tape_get_val(jg, entry, key);
+    return (struct jg_pair const *) entry;
+}
+
+// The jg_val_get_t handle of a pair's value, which in tape mode is a tape entry
+// pointer in disguise too
+static struct jg_val_in const * get_pair_val_handle(
+    jg_t * jg,
+    struct jg_pair const * pair
+) {
+    return jg->opt_parse.tape ?
+        (struct jg_val_in const *) ((uint64_t const *) pair + 1) : &pair->val;
+}
+
+static struct jg_val_in const * get_val( // The value that val is a handle of
+    jg_t * jg,
+    struct jg_val_in const * val
+) {
+    if (!jg->opt_parse.tape) {
+        return val;
+    }
+    tape_get_val(jg, (uint64_t const *) val, &jg->tape_val);
+    return &jg->tape_val;
+}
+
+static struct jg_val_in const * get_pair_val(
+    jg_t * jg,
+    struct jg_pair const * pair
+) {
+    return get_val(jg, get_pair_val_handle(jg, pair));
+}
+
+// Whether child is an array or object that lazy mode left unparsed so far
+static bool is_unparsed(
+    jg_t * jg,
+    struct jg_val_in const * child
+) {
+    return jg->is_lazy &&
+        (child->type == JG_TYPE_ARR || child->type == JG_TYPE_OBJ) &&
+        child->is_unparsed;
+}
+
+// In lazy mode, parse the array or object child once it is gotten for the first
+// time. Children are always values within the arena (never jg->tape_val, since
+// tape mode isn't lazy), so they can be updated in place.
+static jg_ret parse_if_unparsed(
+    jg_t * jg,
+    struct jg_val_in const * child
+) {
+    if (!is_unparsed(jg, child)) {
+        return JG_OK;
+    }
+    return jg->ret = parse_lazy_container(jg, (struct jg_val_in *) child);
+}
+
+// The decoded number if child is a NUM and numbers are decoded, or else NULL
+static struct jg_num const * get_num(
+    jg_t * jg,
+    struct jg_val_in const * child
+) {
+    return jg->decodes_nums && child->type == JG_TYPE_NUM ? child->num : NULL;
+}
+
+// The .json of any child other than an ARR or OBJ
+static char const * get_val_json(
+    jg_t * jg,
+    struct jg_val_in const * child
+) {
+    struct jg_num const * num = get_num(jg, child);
+    return num ? num->json : child->json;
+}
+
 static jg_ret check_type(
     jg_t * jg,
     struct jg_val_in const * child,
@@ -33,13 +174,15 @@ static jg_ret check_type(
     if (child->type != type) {
         switch (child->type) {
         case JG_TYPE_ARR:
-            jg->json_cur = child->arr->json;
+            jg->json_cur = is_unparsed(jg, child) ?
+                child->json : get_arr_json(jg, child->arr);
             break;
         case JG_TYPE_OBJ:
-            jg->json_cur = child->obj->json;
+            jg->json_cur = is_unparsed(jg, child) ?
+                child->json : get_obj_json(jg, child->obj);
             break;
         default:
-            jg->json_cur = child->json;
+            jg->json_cur = get_val_json(jg, child);
         }
         switch (type) {
         case JG_TYPE_NULL: return jg->ret = JG_E_GET_NOT_NULL;
@@ -59,14 +202,108 @@ static jg_ret check_arr_index_over(
     size_t arr_i
 ) {
     JG_GUARD(check_null_arg(arr));
-    if (arr->elem_c <= arr_i) {
+    if (get_arr_elem_c(jg, arr) <= arr_i) {
         jg->err_val.s = arr_i;
-        jg->json_cur = arr->json;
+        jg->json_cur = get_arr_json(jg, arr);
         return jg->ret = JG_E_GET_ARR_INDEX_OVER;
     }
     return JG_OK;
 }
 
+// For the jg_arr_get_..._array() getters: check that arr has all *elem_c
+// elements from index arr_i onward. If not, no element gets gotten, so set
+// *elem_c to 0 accordingly.
+static jg_ret check_arr_elems(
+    jg_t * jg,
+    struct jg_arr const * arr,
+    size_t arr_i,
+    void const * v,
+    size_t * elem_c
+) {
+    JG_GUARD(check_null_arg(elem_c));
+    jg_ret ret = JG_OK;
+    if (!*elem_c) {
+        ret = check_null_arg(arr);
+    } else {
+        ret = check_null_arg(v);
+        if (ret == JG_OK) {
+            ret = check_arr_index_over(jg, arr, *elem_c > SIZE_MAX - arr_i ?
+                SIZE_MAX : arr_i + *elem_c - 1);
+        }
+    }
+    if (ret != JG_OK) {
+        *elem_c = 0;
+    }
+    return ret;
+}
+
+// Same as get_arr_elem(), except that in tape mode, *entry is the entry of the
+// element preceding arr_i (if not NULL), such that consecutive elements can be
+// gotten without searching the tape for each of them.
+static struct jg_val_in const * get_next_arr_elem(
+    jg_t * jg,
+    struct jg_arr const * arr,
+    size_t arr_i,
+    uint64_t const * * entry
+) {
+    if (!jg->opt_parse.tape) {
+        return arr->elems + arr_i;
+    }
+    *entry = *entry ? tape_get_next(*entry) :
+        tape_get_elem(jg, (uint64_t const *) arr, arr_i);
+    tape_get_val(jg, *entry, &jg->tape_val);
+    return &jg->tape_val;
+}
+
+// Fail a jg_arr_get_..._array() getter on the elem_i-th element it gets
+static jg_ret fail_arr_elem(
+    jg_t * jg,
+    struct jg_val_in const * child,
+    jg_ret ret,
+    size_t elem_i,
+    size_t * elem_c
+) {
+    if (child->type == JG_TYPE_NUM) {
+        jg->json_cur = get_val_json(jg, child);
+    }
+    *elem_c = elem_i;
+    return jg->ret = ret;
+}
+
+// The pair at position pos (see struct jg_index), and its key
+static struct jg_pair const * get_pair_by_pos(
+    jg_t * jg,
+    struct jg_obj const * obj,
+    uint32_t pos,
+    struct jg_val_in * key
+) {
+    if (!jg->opt_parse.tape) {
+        *key = obj->pairs[pos].key;
+        return obj->pairs + pos;
+    }
+    uint64_t const * entry = (uint64_t const *) obj + pos;
+    tape_get_val(jg, entry, key);
+    return (struct jg_pair const *) entry;
+}
+
+static jg_ret build_obj_index(
+    jg_t * jg,
+    struct jg_obj const * obj,
+    struct jg_index * * index
+) {
+    JG_GUARD(alloc_index(jg, get_obj_pair_c(jg, obj), index));
+    struct jg_val_in k = {0};
+    for (struct jg_pair const * p = get_next_pair(jg, obj, NULL, &k); p;
+        p = get_next_pair(jg, obj, p, &k)) {
+        uint32_t hash = 0;
+        JG_GUARD(hash_json_str(jg, (uint8_t const *) k.json, k.byte_c, &hash));
+        index_insert(*index, hash, jg->opt_parse.tape ?
+            (uint32_t) ((uint64_t const *) p - (uint64_t const *) obj) :
+            (uint32_t) (p - obj->pairs));
+    }
+    return set_obj_index(jg, get_obj_json(jg, obj), *index);
+}
+
 static jg_ret obj_get_val_by_key(
     jg_t * jg,
     struct jg_obj const * obj,
@@ -77,18 +314,48 @@ static jg_ret obj_get_val_by_key(
     JG_GUARD(check_null_arg(obj));
     JG_GUARD(check_null_arg(key));
     size_t byte_c = strlen(key);
-    for (struct jg_pair const * p = obj->pairs; p < obj->pairs + obj->pair_c;
-        p++) {
-        bool strings_are_equal = false;
-        JG_GUARD(unesc_str_and_json_str_are_equal((uint8_t const *) key, byte_c,
-            (uint8_t const *) p->key.json, p->key.byte_c, &strings_are_equal));
-        if (strings_are_equal) {
-            *val = &p->val;
-            return JG_OK;
+    struct jg_val_in k = {0};
+    struct jg_index * index = NULL;
+    if (get_obj_pair_c(jg, obj) >= JG_INDEX_MIN_KEY_C) {
+        index = get_obj_index(jg, get_obj_json(jg, obj));
+        // The obj_indexes of a jg_doc_t are shared by all its readers, so
+        // those must never add to them. (jg_freeze() indexes every large
+        // object anyway, so a reader never lacks an index to begin with.)
+        if (!index && !jg->doc) {
+            JG_GUARD(build_obj_index(jg, obj, &index));
+        }
+    }
+    if (index) {
+        uint32_t hash = hash_unesc_str(jg->hash_seed,
+            (uint8_t const *) key, byte_c);
+        size_t slot_i = hash & (index->slot_c - 1);
+        uint32_t pos = 0;
+        while (index_find_next(index, hash, &slot_i, &pos)) {
+            struct jg_pair const * p = get_pair_by_pos(jg, obj, pos, &k);
+            bool strings_are_equal = false;
+            JG_GUARD(unesc_str_and_json_str_are_equal((uint8_t const *) key,
+                byte_c, (uint8_t const *) k.json, k.byte_c,
+                &strings_are_equal));
+            if (strings_are_equal) {
+                *val = get_pair_val(jg, p);
+                return JG_OK;
+            }
+        }
+    } else {
+        for (struct jg_pair const * p = get_next_pair(jg, obj, NULL, &k); p;
+            p = get_next_pair(jg, obj, p, &k)) {
+            bool strings_are_equal = false;
+            JG_GUARD(unesc_str_and_json_str_are_equal((uint8_t const *) key,
+                byte_c, (uint8_t const *) k.json, k.byte_c,
+                &strings_are_equal));
+            if (strings_are_equal) {
+                *val = get_pair_val(jg, p);
+                return JG_OK;
+            }
         }
     }
     if (is_required) {
-        jg->json_cur = obj->json;
+        jg->json_cur = get_obj_json(jg, obj);
         // Not actually "custom" in this case, but use this anyway to save the
         // key string for jg_get_err_str().
         set_custom_err_str(jg, key);
@@ -98,6 +365,107 @@ static jg_ret obj_get_val_by_key(
     return JG_OK;
 }
 
+// Build the key index of obj if it is large enough to have one, but has none
+// yet (because of .opt_parse.trust_unique_keys).
+static jg_ret complete_obj_index(
+    jg_t * jg,
+    struct jg_obj const * obj
+) {
+    if (get_obj_pair_c(jg, obj) < JG_INDEX_MIN_KEY_C ||
+        get_obj_index(jg, get_obj_json(jg, obj))) {
+        return JG_OK;
+    }
+    struct jg_index * index = NULL;
+    return build_obj_index(jg, obj, &index);
+}
+
+// Push v onto the LIFO of values whose children complete_dom() is yet to visit
+static jg_ret push_incomplete(
+    jg_t * jg,
+    struct jg_val_in * * * lifo,
+    size_t * lifo_c,
+    size_t * lifo_size,
+    struct jg_val_in * v
+) {
+    if (*lifo_c == *lifo_size) {
+        size_t size = *lifo_size ? 2 * *lifo_size : 64;
+        struct jg_val_in * * vals = realloc(*lifo, size * sizeof(*vals));
+        if (!vals) {
+            return jg->ret = JG_E_REALLOC;
+        }
+        *lifo = vals;
+        *lifo_size = size;
+    }
+    (*lifo)[(*lifo_c)++] = v;
+    return JG_OK;
+}
+
+// Visit the arrays and objects of the DOM depth-first (without recursing),
+// parsing any that lazy mode left unparsed, and completing object indexes.
+static jg_ret complete_containers(
+    jg_t * jg,
+    struct jg_val_in * * * lifo,
+    size_t * lifo_c,
+    size_t * lifo_size
+) {
+    JG_GUARD(push_incomplete(jg, lifo, lifo_c, lifo_size, &jg->root_in));
+    while (*lifo_c) {
+        struct jg_val_in * v = (*lifo)[--*lifo_c];
+        JG_GUARD(parse_if_unparsed(jg, v));
+        size_t c = 0;
+        if (v->type == JG_TYPE_ARR) {
+            c = v->arr->elem_c;
+        } else {
+            JG_GUARD(complete_obj_index(jg, v->obj));
+            c = v->obj->pair_c;
+        }
+        for (size_t i = 0; i < c; i++) {
+            struct jg_val_in * child = v->type == JG_TYPE_ARR ?
+                v->arr->elems + i : &v->obj->pairs[i].val;
+            if (child->type == JG_TYPE_ARR || child->type == JG_TYPE_OBJ) {
+                JG_GUARD(push_incomplete(jg, lifo, lifo_c, lifo_size, child));
+            }
+        }
+    }
+    return JG_OK;
+}
+
+// Once this returns JG_OK, getters no longer modify the DOM, so any number of
+// sessions can then get from it concurrently. (Parsing already indexes all
+// large objects, unless .opt_parse.trust_unique_keys skipped that; whereas
+// jg_load_image() indexes none.)
+jg_ret complete_dom(
+    jg_t * jg
+) {
+    if (!jg->is_lazy && !jg->opt_parse.trust_unique_keys &&
+        !jg->tape_is_image) {
+        return JG_OK;
+    }
+    if (jg->opt_parse.tape) { // Tape mode is never lazy.
+        for (uint64_t const * entry = jg->tape;
+            entry < jg->tape + jg->tape_c; entry++) {
+            enum jg_type type = JG_TAPE_TYPE(*entry);
+            if (type == JG_TYPE_OBJ) {
+                JG_GUARD(complete_obj_index(jg,
+                    (struct jg_obj const *) entry));
+            }
+            if (type == JG_TYPE_ARR || type == JG_TYPE_OBJ) {
+                entry++; // Its skip entry
+            }
+        }
+        return JG_OK;
+    }
+    if (jg->root_in.type != JG_TYPE_ARR && jg->root_in.type != JG_TYPE_OBJ) {
+        return JG_OK;
+    }
+    struct jg_val_in * * lifo = NULL;
+    size_t lifo_c = 0;
+    size_t lifo_size = 0;
+    jg_ret ret = complete_containers(jg, &lifo, &lifo_c, &lifo_size);
+    free(lifo);
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ..._get_json_type() /////////////////////////////////////////////////////////
 
@@ -118,7 +486,7 @@ jg_ret jg_arr_get_json_type(
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    *type = arr->elems[arr_i].type;
+    *type = get_arr_elem(jg, arr, arr_i)->type;
     return jg->ret = JG_OK;
 }
 
@@ -135,8 +503,19 @@ jg_ret jg_obj_get_json_type(
     return jg->ret = JG_OK;
 }
 
+jg_ret jg_val_get_json_type(
+    jg_t * jg,
+    struct jg_val_in const * val,
+    enum jg_type * type
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    *type = get_val(jg, val)->type;
+    return jg->ret = JG_OK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_bool() ////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_bool() ////////////////////////////////////////////
 
 jg_ret jg_root_get_bool(
     jg_t * jg,
@@ -156,7 +535,7 @@ jg_ret jg_arr_get_bool(
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    struct jg_val_in const * child = arr->elems + arr_i;
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i);
     JG_GUARD(check_type(jg, child, JG_TYPE_BOOL));
     *v = child->bool_is_true;
     return jg->ret = JG_OK;
@@ -182,8 +561,21 @@ jg_ret jg_obj_get_bool(
     return jg->ret = JG_OK;
 }
 
+jg_ret jg_val_get_bool(
+    jg_t * jg,
+    struct jg_val_in const * val,
+    bool * v
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    struct jg_val_in const * child = get_val(jg, val);
+    JG_GUARD(check_type(jg, child, JG_TYPE_BOOL));
+    *v = child->bool_is_true;
+    return jg->ret = JG_OK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_null() ////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_null() ////////////////////////////////////////////
 
 jg_ret jg_root_get_null(
     jg_t * jg
@@ -200,7 +592,7 @@ jg_ret jg_arr_get_null(
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    JG_GUARD(check_type(jg, arr->elems + arr_i, JG_TYPE_NULL));
+    JG_GUARD(check_type(jg, get_arr_elem(jg, arr, arr_i), JG_TYPE_NULL));
     return jg->ret = JG_OK;
 }
 
@@ -216,6 +608,16 @@ jg_ret jg_obj_get_null(
     return jg->ret = JG_OK;
 }
 
+jg_ret jg_val_get_null(
+    jg_t * jg,
+    struct jg_val_in const * val
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    JG_GUARD(check_type(jg, get_val(jg, val), JG_TYPE_NULL));
+    return jg->ret = JG_OK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ..._get_arr...() ////////////////////////////////////////////////////////////
 
@@ -227,15 +629,16 @@ static jg_ret handle_arr_options(
     size_t min_c,
     size_t max_c
 ) {
-    if (arr->elem_c < min_c) {
+    size_t elem_c = get_arr_elem_c(jg, arr);
+    if (elem_c < min_c) {
         jg->err_val.s = min_c;
-        jg->json_cur = arr->json;
+        jg->json_cur = get_arr_json(jg, arr);
         set_custom_err_str(jg, min_c_reason);
         return jg->ret = JG_E_GET_ARR_TOO_SHORT;
     }
-    if (max_c && arr->elem_c > max_c) {
+    if (max_c && elem_c > max_c) {
         jg->err_val.s = max_c;
-        jg->json_cur = arr->json;
+        jg->json_cur = get_arr_json(jg, arr);
         set_custom_err_str(jg, max_c_reason);
         return jg->ret = JG_E_GET_ARR_TOO_LONG;
     }
@@ -256,7 +659,7 @@ jg_ret jg_root_get_arr(
     }
     *v = jg->root_in.arr;
     if (elem_c) {
-        *elem_c = jg->root_in.arr->elem_c;
+        *elem_c = get_arr_elem_c(jg, jg->root_in.arr);
     }
     return jg->ret = JG_OK;
 }
@@ -271,15 +674,16 @@ jg_ret jg_arr_get_arr(
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    struct jg_val_in const * child = arr->elems + arr_i;
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i);
     JG_GUARD(check_type(jg, child, JG_TYPE_ARR));
+    JG_GUARD(parse_if_unparsed(jg, child));
     if (opt) {
         JG_GUARD(handle_arr_options(jg, child->arr, opt->min_c_reason,
             opt->max_c_reason, opt->min_c, opt->max_c));
     }
     *v = child->arr;
     if (elem_c) {
-        *elem_c = child->arr->elem_c;
+        *elem_c = get_arr_elem_c(jg, child->arr);
     }
     return jg->ret = JG_OK;
 }
@@ -296,13 +700,14 @@ jg_ret jg_obj_get_arr(
     struct jg_val_in const * child = NULL;
     JG_GUARD(obj_get_val_by_key(jg, obj, key, true, &child));
     JG_GUARD(check_type(jg, child, JG_TYPE_ARR));
+    JG_GUARD(parse_if_unparsed(jg, child));
     if (opt) {
         JG_GUARD(handle_arr_options(jg, child->arr, opt->min_c_reason,
             opt->max_c_reason, opt->min_c, opt->max_c));
     }
     *v = child->arr;
     if (elem_c) {
-        *elem_c = child->arr->elem_c;
+        *elem_c = get_arr_elem_c(jg, child->arr);
     }
     return jg->ret = JG_OK;
 }
@@ -320,20 +725,48 @@ jg_ret jg_obj_get_arr_defa(
     JG_GUARD(obj_get_val_by_key(jg, obj, key, false, &child));
     if (child) {
         JG_GUARD(check_type(jg, child, JG_TYPE_ARR));
+        JG_GUARD(parse_if_unparsed(jg, child));
         if (opt) {
             JG_GUARD(handle_arr_options(jg, child->arr, NULL, opt->max_c_reason,
                 0, opt->max_c));
         }
         *v = child->arr;
-        *elem_c = child->arr->elem_c;
+        *elem_c = get_arr_elem_c(jg, child->arr);
     } else {
-        static struct jg_arr empty_arr = {0};
-        *v = &empty_arr;
+        static struct jg_arr const empty_arr = {0};
+        static uint64_t const empty_tape_arr[] = {
+            JG_TAPE_ENTRY(JG_TYPE_ARR, 0, 0), 2
+        };
+        *v = jg->opt_parse.tape ?
+            (struct jg_arr const *) empty_tape_arr : &empty_arr;
         *elem_c = 0;
     }
     return jg->ret = JG_OK;
 }
 
+jg_ret jg_val_get_arr(
+    jg_t * jg,
+    struct jg_val_in const * val,
+    jg_val_arr * opt,
+    struct jg_arr const * * v,
+    size_t * elem_c
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    struct jg_val_in const * child = get_val(jg, val);
+    JG_GUARD(check_type(jg, child, JG_TYPE_ARR));
+    JG_GUARD(parse_if_unparsed(jg, child));
+    if (opt) {
+        JG_GUARD(handle_arr_options(jg, child->arr, opt->min_c_reason,
+            opt->max_c_reason, opt->min_c, opt->max_c));
+    }
+    *v = child->arr;
+    if (elem_c) {
+        *elem_c = get_arr_elem_c(jg, child->arr);
+    }
+    return jg->ret = JG_OK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ..._get_obj...() ////////////////////////////////////////////////////////////
 
@@ -347,15 +780,16 @@ static jg_ret handle_obj_options(
     size_t min_c,
     size_t max_c
 ) {
-    if (obj->pair_c < min_c) {
+    size_t pair_c = get_obj_pair_c(jg, obj);
+    if (pair_c < min_c) {
         jg->err_val.s = min_c;
-        jg->json_cur = obj->json;
+        jg->json_cur = get_obj_json(jg, obj);
         set_custom_err_str(jg, min_c_reason);
         return jg->ret = JG_E_GET_OBJ_TOO_SHORT;
     }
-    if (max_c && obj->pair_c > max_c) {
+    if (max_c && pair_c > max_c) {
         jg->err_val.s = max_c;
-        jg->json_cur = obj->json;
+        jg->json_cur = get_obj_json(jg, obj);
         set_custom_err_str(jg, max_c_reason);
         return jg->ret = JG_E_GET_OBJ_TOO_LONG;
     }
@@ -366,23 +800,25 @@ static jg_ret handle_obj_options(
         // point to string locations within the tail of the same buffer). Aside
         // from being memory efficient, this causes the least work for the
         // calling side, given that only one free() cleanup action is required.
-        size_t byte_c = obj->pair_c * sizeof(char *);
-        for (struct jg_pair const * p = obj->pairs;
-            p < obj->pairs + obj->pair_c; p++) {
-            byte_c += p->key.byte_c + 1ULL; // null-terminated key string extent
+        size_t byte_c = pair_c * sizeof(char *);
+        struct jg_val_in k = {0};
+        for (struct jg_pair const * p = get_next_pair(jg, obj, NULL, &k); p;
+            p = get_next_pair(jg, obj, p, &k)) {
+            byte_c += k.byte_c + 1ULL; // null-terminated key string extent
         }
         *keys = calloc(byte_c, 1);
         if (!*keys) {
             return jg->ret = JG_E_CALLOC;
         }
-        char * str = (char *) (*keys + obj->pair_c);
-        for (size_t i = 0; i < obj->pair_c; i++) {
-            (*keys)[i] = str;
-            size_t strlen = obj->pairs[i].key.byte_c;
-            memcpy(str, obj->pairs[i].key.json, strlen);
-            str += strlen + 1; // null_terminate each key string
+        char * str = (char *) (*keys + pair_c);
+        size_t i = 0;
+        for (struct jg_pair const * p = get_next_pair(jg, obj, NULL, &k); p;
+            p = get_next_pair(jg, obj, p, &k)) {
+            (*keys)[i++] = str;
+            memcpy(str, k.json, k.byte_c);
+            str += k.byte_c + 1; // null_terminate each key string
         }
-        *key_c = obj->pair_c;
+        *key_c = pair_c;
     }
     return JG_OK;
 }
@@ -411,8 +847,9 @@ jg_ret jg_arr_get_obj(
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    struct jg_val_in const * child = arr->elems + arr_i;
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i);
     JG_GUARD(check_type(jg, child, JG_TYPE_OBJ));
+    JG_GUARD(parse_if_unparsed(jg, child));
     if (opt) {
         JG_GUARD(handle_obj_options(jg, child->obj, opt->keys, opt->key_c,
             opt->min_c_reason, opt->max_c_reason, opt->min_c, opt->max_c));
@@ -432,6 +869,7 @@ jg_ret jg_obj_get_obj(
     struct jg_val_in const * child = NULL;
     JG_GUARD(obj_get_val_by_key(jg, obj, key, true, &child));
     JG_GUARD(check_type(jg, child, JG_TYPE_OBJ));
+    JG_GUARD(parse_if_unparsed(jg, child));
     if (opt) {
         JG_GUARD(handle_obj_options(jg, child->obj, opt->keys, opt->key_c,
             opt->min_c_reason, opt->max_c_reason, opt->min_c, opt->max_c));
@@ -452,6 +890,7 @@ jg_ret jg_obj_get_obj_defa(
     JG_GUARD(obj_get_val_by_key(jg, obj, key, false, &child));
     if (child) {
         JG_GUARD(check_type(jg, child, JG_TYPE_OBJ));
+        JG_GUARD(parse_if_unparsed(jg, child));
         if (opt) {
             JG_GUARD(handle_obj_options(jg, child->obj, opt->keys, opt->key_c,
                 NULL, opt->max_c_reason, 0, opt->max_c));
@@ -459,17 +898,41 @@ jg_ret jg_obj_get_obj_defa(
         *v = child->obj;
     } else {
         static struct jg_obj const empty_obj = {0};
+        static uint64_t const empty_tape_obj[] = {
+            JG_TAPE_ENTRY(JG_TYPE_OBJ, 0, 0), 2
+        };
+        struct jg_obj const * empty = jg->opt_parse.tape ?
+            (struct jg_obj const *) empty_tape_obj : &empty_obj;
         if (opt) {
-            JG_GUARD(handle_obj_options(jg, &empty_obj, opt->keys, opt->key_c,
+            JG_GUARD(handle_obj_options(jg, empty, opt->keys, opt->key_c,
                 NULL, NULL, 0, 0));
         }
-        *v = &empty_obj;
+        *v = empty;
+    }
+    return jg->ret = JG_OK;
+}
+
+jg_ret jg_val_get_obj(
+    jg_t * jg,
+    struct jg_val_in const * val,
+    jg_val_obj * opt,
+    struct jg_obj const * * v
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    struct jg_val_in const * child = get_val(jg, val);
+    JG_GUARD(check_type(jg, child, JG_TYPE_OBJ));
+    JG_GUARD(parse_if_unparsed(jg, child));
+    if (opt) {
+        JG_GUARD(handle_obj_options(jg, child->obj, opt->keys, opt->key_c,
+            opt->min_c_reason, opt->max_c_reason, opt->min_c, opt->max_c));
     }
+    *v = child->obj;
     return jg->ret = JG_OK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_(caller)str() /////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_[(json)_(caller)str|strview]() ////////////////////
 
 static jg_ret handle_str_size_options(
     jg_t * jg,
@@ -501,7 +964,9 @@ static jg_ret handle_str_size_options(
     if (v_byte_c) {
         *v_byte_c = dst_byte_c;
     }
-    size_t cp_c = get_codepoint_c((uint8_t const *) child->json, child->byte_c);
+    size_t cp_c = jg->unescapes_strs ?
+        get_unesc_codepoint_c((uint8_t const *) child->json, child->byte_c) :
+        get_codepoint_c((uint8_t const *) child->json, child->byte_c);
     if (cp_c < min_cp_c) {
         jg->err_val.s = min_cp_c;
         jg->json_cur = child->json;
@@ -520,6 +985,23 @@ static jg_ret handle_str_size_options(
     return JG_OK;
 }
 
+// How a getter's string is to be derived from the string value's .json
+enum jg_str_conv {
+    JG_STR_COPY = 0, // As is
+    JG_STR_UNESC, // Unescaped
+    JG_STR_ESC // Escaped anew, because jg->unescapes_strs unescaped it already
+};
+
+static enum jg_str_conv get_str_conv(
+    jg_t * jg,
+    bool needs_unesc
+) {
+    if (jg->unescapes_strs) {
+        return needs_unesc ? JG_STR_COPY : JG_STR_ESC;
+    }
+    return needs_unesc ? JG_STR_UNESC : JG_STR_COPY;
+}
+
 static jg_ret get_str(
     jg_t * jg,
     char const * json_str,
@@ -527,7 +1009,7 @@ static jg_ret get_str(
     size_t dst_byte_c,
     bool nullify_empty_str,
     bool omit_null_terminator,
-    bool needs_unesc,
+    enum jg_str_conv conv,
     bool needs_alloc,
     char * * v
 ) {
@@ -544,11 +1026,14 @@ static jg_ret get_str(
         // Assume caller only wants to know dst_byte_c and/or codepoint_c).
         return jg->ret = JG_OK; // v is NULL, so return without copying.
     }
-    if (needs_unesc) {
+    if (dst_byte_c == json_byte_c) { // Nothing to (un)escape
+        memcpy(*v, json_str, json_byte_c);
+    } else if (conv == JG_STR_UNESC) {
         json_str_to_unesc_str((uint8_t const *) json_str, json_byte_c,
         (uint8_t *) *v);
     } else {
-        memcpy(*v, json_str, json_byte_c);
+        unesc_str_to_json_str((uint8_t const *) json_str, json_byte_c,
+        (uint8_t *) *v);
     }
     if (!omit_null_terminator) {
         (*v)[dst_byte_c] = '\0';
@@ -556,18 +1041,63 @@ static jg_ret get_str(
     return jg->ret = JG_OK;
 }
 
+// A view of the JSON string itself if unescaping would not change it (or did so
+// in place already), or else of its unescaped copy in the arena (which lives as
+// long as the DOM does).
+static jg_ret get_strview(
+    jg_t * jg,
+    char const * json_str,
+    size_t json_byte_c,
+    size_t dst_byte_c,
+    bool nullify_empty_str,
+    jg_strview * v
+) {
+    if (!json_byte_c && nullify_empty_str) {
+        *v = (jg_strview) {0};
+        return jg->ret = JG_OK;
+    }
+    if (dst_byte_c == json_byte_c) { // Every escape sequence is longer.
+        *v = (jg_strview) {.str = json_str, .byte_c = json_byte_c};
+        return jg->ret = JG_OK;
+    }
+    uint8_t * str = arena_alloc(jg, dst_byte_c + 1);
+    if (!str) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    json_str_to_unesc_str((uint8_t const *) json_str, json_byte_c, str);
+    *v = (jg_strview) {.str = (char const *) str, .byte_c = dst_byte_c};
+    return jg->ret = JG_OK;
+}
+
+// Strings without any '\\' (i.e., most) need not be scanned for unescaping.
+static size_t get_dst_byte_c(
+    struct jg_val_in const * child,
+    enum jg_str_conv conv
+) {
+    switch (conv) {
+    case JG_STR_UNESC:
+        return memchr(child->json, '\\', child->byte_c) ?
+            get_unesc_byte_c((uint8_t const *) child->json, child->byte_c) :
+            child->byte_c;
+    case JG_STR_ESC:
+        return get_json_byte_c((uint8_t const *) child->json, child->byte_c);
+    default:
+        return child->byte_c;
+    }
+}
+
 static jg_ret root_get_str(
     jg_t * jg,
     jg_root_str * opt,
     bool needs_unesc,
     bool needs_alloc,
-    char * * v
+    char * * v,
+    jg_strview * view // Set instead of v if not NULL
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_type(jg, &jg->root_in, JG_TYPE_STR));
-    size_t dst_byte_c = needs_unesc ?
-        get_unesc_byte_c((uint8_t const *) jg->root_in.json,
-        jg->root_in.byte_c) : jg->root_in.byte_c;
+    enum jg_str_conv conv = get_str_conv(jg, needs_unesc);
+    size_t dst_byte_c = get_dst_byte_c(&jg->root_in, conv);
     bool nullify_empty_str = false;
     bool omit_null_terminator = false;
     if (opt) {
@@ -579,24 +1109,32 @@ static jg_ret root_get_str(
         nullify_empty_str = opt->nullify_empty_str;
         omit_null_terminator = opt->omit_null_terminator;
     }
+    if (view) {
+        return get_strview(jg, jg->root_in.json, jg->root_in.byte_c,
+            dst_byte_c, nullify_empty_str, view);
+    }
     return get_str(jg, jg->root_in.json, jg->root_in.byte_c, dst_byte_c,
-        nullify_empty_str, omit_null_terminator, needs_unesc, needs_alloc, v);
+        nullify_empty_str, omit_null_terminator, conv, needs_alloc, v);
 }
 
 JG_ROOT_GET(_str, char *) {
-    return root_get_str(jg, opt, true, true, v);
+    return root_get_str(jg, opt, true, true, v, NULL);
 }
 
 JG_ROOT_GET(_callerstr, char) {
-    return root_get_str(jg, opt, true, false, &v);
+    return root_get_str(jg, opt, true, false, &v, NULL);
 }
 
 JG_ROOT_GET(_json_str, char *) {
-    return root_get_str(jg, opt, false, true, v);
+    return root_get_str(jg, opt, false, true, v, NULL);
 }
 
 JG_ROOT_GET(_json_callerstr, char) {
-    return root_get_str(jg, opt, false, false, &v);
+    return root_get_str(jg, opt, false, false, &v, NULL);
+}
+
+JG_ROOT_GET(_strview, jg_strview) {
+    return root_get_str(jg, opt, true, false, NULL, v);
 }
 
 static jg_ret arr_get_str(
@@ -606,15 +1144,15 @@ static jg_ret arr_get_str(
     jg_arr_str * opt,
     bool needs_unesc,
     bool needs_alloc,
-    char * * v
+    char * * v,
+    jg_strview * view // Set instead of v if not NULL
 ) {
     JG_GUARD(check_state_get(jg));
     JG_GUARD(check_arr_index_over(jg, arr, arr_i));
-    struct jg_val_in const * child = arr->elems + arr_i;
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i);
     JG_GUARD(check_type(jg, child, JG_TYPE_STR));
-    size_t dst_byte_c = needs_unesc ?
-        get_unesc_byte_c((uint8_t const *) child->json, child->byte_c) :
-        child->byte_c;
+    enum jg_str_conv conv = get_str_conv(jg, needs_unesc);
+    size_t dst_byte_c = get_dst_byte_c(child, conv);
     bool nullify_empty_str = false;
     bool omit_null_terminator = false;
     if (opt) {
@@ -626,24 +1164,32 @@ static jg_ret arr_get_str(
         nullify_empty_str = opt->nullify_empty_str;
         omit_null_terminator = opt->omit_null_terminator;
     }
+    if (view) {
+        return get_strview(jg, child->json, child->byte_c, dst_byte_c,
+            nullify_empty_str, view);
+    }
     return get_str(jg, child->json, child->byte_c, dst_byte_c,
-        nullify_empty_str, omit_null_terminator, needs_unesc, needs_alloc, v);
+        nullify_empty_str, omit_null_terminator, conv, needs_alloc, v);
 }
 
 JG_ARR_GET(_str, char *) {
-    return arr_get_str(jg, arr, arr_i, opt, true, true, v);
+    return arr_get_str(jg, arr, arr_i, opt, true, true, v, NULL);
 }
 
 JG_ARR_GET(_callerstr, char) {
-    return arr_get_str(jg, arr, arr_i, opt, true, false, &v);
+    return arr_get_str(jg, arr, arr_i, opt, true, false, &v, NULL);
 }
 
 JG_ARR_GET(_json_str, char *) {
-    return arr_get_str(jg, arr, arr_i, opt, false, true, v);
+    return arr_get_str(jg, arr, arr_i, opt, false, true, v, NULL);
 }
 
 JG_ARR_GET(_json_callerstr, char) {
-    return arr_get_str(jg, arr, arr_i, opt, false, false, &v);
+    return arr_get_str(jg, arr, arr_i, opt, false, false, &v, NULL);
+}
+
+JG_ARR_GET(_strview, jg_strview) {
+    return arr_get_str(jg, arr, arr_i, opt, true, false, NULL, v);
 }
 
 static jg_ret obj_get_str(
@@ -653,7 +1199,8 @@ static jg_ret obj_get_str(
     jg_obj_str * opt,
     bool needs_unesc,
     bool needs_alloc,
-    char * * v
+    char * * v,
+    jg_strview * view // Set instead of v if not NULL
 ) {
     JG_GUARD(check_state_get(jg));
     struct jg_val_in const * child = NULL;
@@ -671,13 +1218,16 @@ static jg_ret obj_get_str(
             *opt->codepoint_c = get_codepoint_c((uint8_t const *) opt->defa,
                 byte_c);
         }
+        if (view) {
+            return get_strview(jg, opt->defa, byte_c, byte_c,
+                opt->nullify_empty_str, view);
+        }
         return get_str(jg, opt->defa, byte_c, byte_c, opt->nullify_empty_str,
-            opt->omit_null_terminator, false, needs_alloc, v);
+            opt->omit_null_terminator, JG_STR_COPY, needs_alloc, v);
     }
     JG_GUARD(check_type(jg, child, JG_TYPE_STR));
-    size_t dst_byte_c = needs_unesc ?
-        get_unesc_byte_c((uint8_t const *) child->json, child->byte_c) :
-        child->byte_c;
+    enum jg_str_conv conv = get_str_conv(jg, needs_unesc);
+    size_t dst_byte_c = get_dst_byte_c(child, conv);
     bool nullify_empty_str = false;
     bool omit_null_terminator = false;
     if (opt) {
@@ -689,60 +1239,141 @@ static jg_ret obj_get_str(
         nullify_empty_str = opt->nullify_empty_str;
         omit_null_terminator = opt->omit_null_terminator;
     }
+    if (view) {
+        return get_strview(jg, child->json, child->byte_c, dst_byte_c,
+            nullify_empty_str, view);
+    }
     return get_str(jg, child->json, child->byte_c, dst_byte_c,
-        nullify_empty_str, omit_null_terminator, needs_unesc, needs_alloc, v);
+        nullify_empty_str, omit_null_terminator, conv, needs_alloc, v);
 }
 
 JG_OBJ_GET(_str, char *) {
-    return obj_get_str(jg, obj, key, opt, true, true, v);
+    return obj_get_str(jg, obj, key, opt, true, true, v, NULL);
 }
 
 JG_OBJ_GET(_callerstr, char) {
-    return obj_get_str(jg, obj, key, opt, true, false, &v);
+    return obj_get_str(jg, obj, key, opt, true, false, &v, NULL);
 }
 
 JG_OBJ_GET(_json_str, char *) {
-    return obj_get_str(jg, obj, key, opt, false, true, v);
+    return obj_get_str(jg, obj, key, opt, false, true, v, NULL);
 }
 
 JG_OBJ_GET(_json_callerstr, char) {
-    return obj_get_str(jg, obj, key, opt, false, false, &v);
+    return obj_get_str(jg, obj, key, opt, false, false, &v, NULL);
+}
+
+JG_OBJ_GET(_strview, jg_strview) {
+    return obj_get_str(jg, obj, key, opt, true, false, NULL, v);
+}
+
+static jg_ret val_get_str(
+    jg_t * jg,
+    struct jg_val_in const * val,
+    jg_val_str * opt,
+    bool needs_unesc,
+    bool needs_alloc,
+    char * * v,
+    jg_strview * view // Set instead of v if not NULL
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(val));
+    struct jg_val_in const * child = get_val(jg, val);
+    JG_GUARD(check_type(jg, child, JG_TYPE_STR));
+    enum jg_str_conv conv = get_str_conv(jg, needs_unesc);
+    size_t dst_byte_c = get_dst_byte_c(child, conv);
+    bool nullify_empty_str = false;
+    bool omit_null_terminator = false;
+    if (opt) {
+        JG_GUARD(handle_str_size_options(jg, child, dst_byte_c,
+            opt->min_byte_c_reason, opt->max_byte_c_reason,
+            opt->min_cp_c_reason, opt->max_cp_c_reason, opt->min_byte_c,
+            opt->max_byte_c, opt->min_cp_c, opt->max_cp_c, opt->byte_c,
+            opt->codepoint_c));
+        nullify_empty_str = opt->nullify_empty_str;
+        omit_null_terminator = opt->omit_null_terminator;
+    }
+    if (view) {
+        return get_strview(jg, child->json, child->byte_c, dst_byte_c,
+            nullify_empty_str, view);
+    }
+    return get_str(jg, child->json, child->byte_c, dst_byte_c,
+        nullify_empty_str, omit_null_terminator, conv, needs_alloc, v);
+}
+
+JG_VAL_GET(_str, char *) {
+    return val_get_str(jg, val, opt, true, true, v, NULL);
+}
+
+JG_VAL_GET(_callerstr, char) {
+    return val_get_str(jg, val, opt, true, false, &v, NULL);
+}
+
+JG_VAL_GET(_json_str, char *) {
+    return val_get_str(jg, val, opt, false, true, v, NULL);
+}
+
+JG_VAL_GET(_json_callerstr, char) {
+    return val_get_str(jg, val, opt, false, false, &v, NULL);
+}
+
+JG_VAL_GET(_strview, jg_strview) {
+    return val_get_str(jg, val, opt, true, false, NULL, v);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_<integer_type>() //////////////////////////////////////
+// jg_[root|arr|obj|val]_get_<integer_type>() //////////////////////////////////
+
+// Decode the number in the same way as decode_number() in jg_parse.c does,
+// unless it already has been, so that both take the same path from here on.
+static struct jg_num const * get_int_num(
+    jg_t * jg,
+    struct jg_val_in const * child,
+    struct jg_num * buf // Decoded into if child is not decoded already
+) {
+    struct jg_num const * num = get_num(jg, child);
+    if (num) {
+        return num;
+    }
+    char const * c = child->json;
+    char const * const c_over = c + child->byte_c;
+    *buf = (struct jg_num) {.json = c, .is_neg = *c == '-'};
+    buf->is_integer = skip_digits(c + buf->is_neg, c_over, &buf->mag) == c_over;
+    return buf;
+}
+
+// A decoded number saturates like strtoimax() would.
+static intmax_t num_to_intmax(
+    struct jg_num const * num
+) {
+    if (num->is_neg) {
+        return num->mag > INTMAX_MAX ? INTMAX_MIN : -(intmax_t) num->mag;
+    }
+    return num->mag > INTMAX_MAX ? INTMAX_MAX : (intmax_t) num->mag;
+}
 
 static jg_ret get_signed(
     jg_t * jg,
-    char const * str,
+    struct jg_num const * num,
     char const * min_reason,
     char const * max_reason,
     intmax_t min,
     intmax_t max,
     intmax_t * i
 ) {
-    // This str is already confirmed to be a valid JSON number by parse_number()
-    // in jg_parse.c. Now make sure it's a signed integer number.
-    char const * c = str;
-    if (*c == '-') {
-        c++;
-    }
-    while (*c >= '0' && *c <= '9') {
-        c++;
-    }
-    if (*c == '.' || *c == 'e' || *c == 'E') {
+    if (!num->is_integer) {
         return jg->ret = JG_E_GET_NUM_NOT_INTEGER;
     }
-    *i = strtoimax(str, NULL, 10);
+    *i = num_to_intmax(num);
     if (*i < min || *i == INTMAX_MIN) {
         jg->err_val.i = min;
-        jg->json_cur = str;
+        jg->json_cur = num->json;
         set_custom_err_str(jg, min_reason);
         return jg->ret = JG_E_GET_NUM_SIGNED_TOO_SMALL;
     }
     if (*i > max || *i == INTMAX_MAX) {
         jg->err_val.i = max;
-        jg->json_cur = str;
+        jg->json_cur = num->json;
         set_custom_err_str(jg, max_reason);
         return jg->ret = JG_E_GET_NUM_SIGNED_TOO_LARGE;
     }
@@ -751,35 +1382,29 @@ static jg_ret get_signed(
 
 static jg_ret get_unsigned(
     jg_t * jg,
-    char const * str,
+    struct jg_num const * num,
     char const * min_reason,
     char const * max_reason,
     uintmax_t min,
     uintmax_t max,
     uintmax_t * u
 ) {
-    // This str is already confirmed to be a valid JSON number by parse_number()
-    // in jg_parse.c. Now make sure it's an unsigned integer number.
-    char const * c = str;
-    if (*c == '-') {
+    if (num->is_neg) {
         return jg->ret = JG_E_GET_NUM_NOT_UNSIGNED;
     }
-    while (*c >= '0' && *c <= '9') {
-        c++;
-    }
-    if (*c == '.' || *c == 'e' || *c == 'E') {
+    if (!num->is_integer) {
         return jg->ret = JG_E_GET_NUM_NOT_INTEGER;
     }
-    *u = strtoumax(str, NULL, 10);
+    *u = num->mag;
     if (*u < min) {
         jg->err_val.i = min;
-        jg->json_cur = str;
+        jg->json_cur = num->json;
         set_custom_err_str(jg, min_reason);
         return jg->ret = JG_E_GET_NUM_UNSIGNED_TOO_SMALL;
     }
     if (*u > max || *u == UINTMAX_MAX) {
         jg->err_val.i = max;
-        jg->json_cur = str;
+        jg->json_cur = num->json;
         set_custom_err_str(jg, max_reason);
         return jg->ret = JG_E_GET_NUM_UNSIGNED_TOO_LARGE;
     }
@@ -791,14 +1416,17 @@ static jg_ret get_unsigned(
 do { \
     _max_type n = 0; \
     if (opt) { \
-        JG_GUARD((_str_to_int_func)(jg, str, opt->min_reason, opt->max_reason, \
+        ret = (_str_to_int_func)(jg, num, opt->min_reason, \
+            opt->max_reason, \
             opt->min ? *opt->min : (_type_min), \
-            opt->max ? *opt->max : (_type_max), &n)); \
+            opt->max ? *opt->max : (_type_max), &n); \
     } else { \
-        JG_GUARD((_str_to_int_func)(jg, str, NULL, NULL, (_type_min), \
-            (_type_max), &n)); \
+        ret = (_str_to_int_func)(jg, num, NULL, NULL, (_type_min), \
+            (_type_max), &n); \
+    } \
+    if (ret == JG_OK) { \
+        *v = (_type) n; \
     } \
-    *v = (_type) n; \
 } while (0)
 
 // This should be a NOP, but nonetheless undefine _ just in case; because
@@ -807,37 +1435,27 @@ do { \
 #undef _
 
 #define JG_GET_FUNC_INT(_suf, _type, _str_to_int) \
-/* JG_[ROOT|ARR|OBJ]_GET prototype macros are defined in jgrandson.h */ \
+/* JG_[ROOT|ARR|OBJ|VAL]_GET prototype macros are defined in jgrandson.h */ \
 JG_ROOT_GET(_suf, _type) { \
     JG_GUARD(check_state_get(jg)); \
     JG_GUARD(check_type(jg, &jg->root_in, JG_TYPE_NUM)); \
-    if (jg->json_over[-1] < '0' || jg->json_over[-1] > '9') { \
-        const char * str = jg->root_in.json; \
-        _##_str_to_int; \
-        return jg->ret = JG_OK; \
-    } \
-    /* Annoying corner case: given that jg->json_text is not required to be */ \
-    /* null-terminated, passing a root-level number type to strto(u)imax() */ \
-    /* as-is would be at risk of buffer overflow. */ \
-    char * str = malloc(jg->root_in.byte_c + 1ULL); \
-    if (!str) { \
-        return jg->ret = JG_E_MALLOC; \
-    } \
-    memcpy(str, jg->root_in.json, jg->root_in.byte_c); \
-    str[jg->root_in.byte_c] = '\0'; \
+    struct jg_num num_buf; \
+    struct jg_num const * num = get_int_num(jg, &jg->root_in, &num_buf); \
+    jg_ret ret = JG_OK; \
     _##_str_to_int; \
-    free(str); \
-    return jg->ret = JG_OK; \
+    return jg->ret = ret; \
 } \
 \
 JG_ARR_GET(_suf, _type) { \
     JG_GUARD(check_state_get(jg)); \
     JG_GUARD(check_arr_index_over(jg, arr, arr_i)); \
-    struct jg_val_in const * child = arr->elems + arr_i; \
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i); \
     JG_GUARD(check_type(jg, child, JG_TYPE_NUM)); \
-    const char * str = child->json; \
+    struct jg_num num_buf; \
+    struct jg_num const * num = get_int_num(jg, child, &num_buf); \
+    jg_ret ret = JG_OK; \
     _##_str_to_int; \
-    return jg->ret = JG_OK; \
+    return jg->ret = ret; \
 } \
 \
 JG_OBJ_GET(_suf, _type) { \
@@ -849,18 +1467,65 @@ JG_OBJ_GET(_suf, _type) { \
         return jg->ret = JG_OK; \
     } \
     JG_GUARD(check_type(jg, child, JG_TYPE_NUM)); \
-    const char * str = child->json; \
+    struct jg_num num_buf; \
+    struct jg_num const * num = get_int_num(jg, child, &num_buf); \
+    jg_ret ret = JG_OK; \
     _##_str_to_int; \
+    return jg->ret = ret; \
+} \
+\
+JG_VAL_GET(_suf, _type) { \
+    JG_GUARD(check_state_get(jg)); \
+    JG_GUARD(check_null_arg(val)); \
+    struct jg_val_in const * child = get_val(jg, val); \
+    JG_GUARD(check_type(jg, child, JG_TYPE_NUM)); \
+    struct jg_num num_buf; \
+    struct jg_num const * num = get_int_num(jg, child, &num_buf); \
+    jg_ret ret = JG_OK; \
+    _##_str_to_int; \
+    return jg->ret = ret; \
+}
+
+// The options are resolved once, rather than once per element.
+#define JG_GET_FUNC_INT_ARRAY( \
+    _suf, _type, _max_type, _get_int_func, _type_min, _type_max) \
+JG_ARR_GET_ARRAY(_suf, _type) { \
+    JG_GUARD(check_state_get(jg)); \
+    JG_GUARD(check_arr_elems(jg, arr, arr_i, v, elem_c)); \
+    char const * min_reason = opt ? opt->min_reason : NULL; \
+    char const * max_reason = opt ? opt->max_reason : NULL; \
+    _max_type min = opt && opt->min ? *opt->min : (_type_min); \
+    _max_type max = opt && opt->max ? *opt->max : (_type_max); \
+    uint64_t const * entry = NULL; \
+    for (size_t i = 0; i < *elem_c; i++) { \
+        struct jg_val_in const * child = \
+            get_next_arr_elem(jg, arr, arr_i + i, &entry); \
+        _max_type n = 0; \
+        jg_ret ret = check_type(jg, child, JG_TYPE_NUM); \
+        if (ret == JG_OK) { \
+            struct jg_num num_buf; \
+            ret = (_get_int_func)(jg, get_int_num(jg, child, &num_buf), \
+                min_reason, max_reason, min, max, &n); \
+        } \
+        if (ret != JG_OK) { \
+            return fail_arr_elem(jg, child, ret, i, elem_c); \
+        } \
+        v[i] = (_type) n; \
+    } \
     return jg->ret = JG_OK; \
 }
 
 #define JG_GET_FUNC_SIGNED(_suf, _type, _type_min, _type_max) \
     JG_GET_FUNC_INT(_suf, _type, \
-        JG_STR_TO_INT(_type, intmax_t, get_signed, _type_min, _type_max))
+        JG_STR_TO_INT(_type, intmax_t, get_signed, _type_min, _type_max)) \
+    JG_GET_FUNC_INT_ARRAY(_suf, _type, intmax_t, get_signed, _type_min, \
+        _type_max)
 
 #define JG_GET_FUNC_UNSIGNED(_suf, _type, _type_min, _type_max) \
     JG_GET_FUNC_INT(_suf, _type, \
-        JG_STR_TO_INT(_type, uintmax_t, get_unsigned, _type_min, _type_max))
+        JG_STR_TO_INT(_type, uintmax_t, get_unsigned, _type_min, _type_max)) \
+    JG_GET_FUNC_INT_ARRAY(_suf, _type, uintmax_t, get_unsigned, _type_min, \
+        _type_max)
 
 JG_GET_FUNC_SIGNED(_int8, int8_t, INT8_MIN, INT8_MAX)
 JG_GET_FUNC_SIGNED(_char, char, CHAR_MIN, CHAR_MAX)
@@ -887,55 +1552,37 @@ JG_GET_FUNC_UNSIGNED(_sizet, size_t, 0, SIZE_MAX)
 JG_GET_FUNC_UNSIGNED(_uintmax, uintmax_t, 0, UINTMAX_MAX)
 
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_[float|double|long_double]() //////////////////////////
+// jg_[root|arr|obj|val]_get_[float|double|long_double]() //////////////////////
+
+// Only a decoded double is used as-is: rounding it to a float again could
+// differ from the correctly rounded float, and a long double may be more
+// precise. Otherwise the number's JSON text is converted by jg_float.c, which
+// unlike strto[f|d|ld]() does not need it to be null-terminated.
+#define JG_JSON_TO_FLO(_json_to_flo_func, _use_dbl) \
+do { \
+    JG_GUARD(check_type(jg, child, JG_TYPE_NUM)); \
+    struct jg_num const * num = get_num(jg, child); \
+    if ((_use_dbl) && num && num->has_dbl) { \
+        *v = num->dbl; \
+        return jg->ret = JG_OK; \
+    } \
+    return jg->ret = (_json_to_flo_func)(get_val_json(jg, child), \
+        child->byte_c, v); \
+} while (0)
 
-#define JG_GET_FUNC_FLO(_suf, _type, _str_to_flo_func, _e_out_of_range) \
-/* JG_[ROOT|ARR|OBJ]_GET_FLO prototype macros are defined in jgrandson.h */ \
+#define JG_GET_FUNC_FLO(_suf, _type, _json_to_flo_func, _use_dbl) \
+/* JG_[ROOT|ARR|OBJ|VAL]_GET_FLO prototype macros are in jgrandson.h */ \
 JG_ROOT_GET_FLO(_suf, _type) { \
     JG_GUARD(check_state_get(jg)); \
-    JG_GUARD(check_type(jg, &jg->root_in, JG_TYPE_NUM)); \
-    if (jg->json_over[-1] < '0' || jg->json_over[-1] > '9') { \
-        char * end = NULL; \
-        errno = 0; \
-        *v = _str_to_flo_func(jg->root_in.json, &end); \
-        if (errno) { \
-            return jg->ret = _e_out_of_range; \
-        } \
-        return jg->ret = end < jg->root_in.json + jg->root_in.byte_c ? \
-            JG_E_GET_NUM_NOT_FLO : JG_OK; \
-    } \
-    /* Annoying corner case: given that jg->json_text is not required to be */ \
-    /* null-terminated, passing a root-level number type to strto(u)imax() */ \
-    /* as-is would be at risk of buffer overflow. */ \
-    char * str = malloc(jg->root_in.byte_c + 1ULL); \
-    if (!str) { \
-        return jg->ret = JG_E_MALLOC; \
-    } \
-    memcpy(str, jg->root_in.json, jg->root_in.byte_c); \
-    str[jg->root_in.byte_c] = '\0'; \
-    char * end = NULL; \
-    errno = 0; \
-    *v = _str_to_flo_func(str, &end); \
-    free(str); \
-    if (errno) { \
-        return jg->ret = _e_out_of_range; \
-    } \
-    return jg->ret = *end == '\0' ? JG_OK : JG_E_GET_NUM_NOT_FLO; \
+    struct jg_val_in const * child = &jg->root_in; \
+    JG_JSON_TO_FLO(_json_to_flo_func, _use_dbl); \
 } \
 \
 JG_ARR_GET_FLO(_suf, _type) { \
     JG_GUARD(check_state_get(jg)); \
     JG_GUARD(check_arr_index_over(jg, arr, arr_i)); \
-    struct jg_val_in const * child = arr->elems + arr_i; \
-    JG_GUARD(check_type(jg, child, JG_TYPE_NUM)); \
-    char * end = NULL; \
-    errno = 0; \
-    *v = _str_to_flo_func(child->json, &end); \
-    if (errno) { \
-        return jg->ret = _e_out_of_range; \
-    } \
-    return jg->ret = end < child->json + child->byte_c ? \
-        JG_E_GET_NUM_NOT_FLO : JG_OK; \
+    struct jg_val_in const * child = get_arr_elem(jg, arr, arr_i); \
+    JG_JSON_TO_FLO(_json_to_flo_func, _use_dbl); \
 } \
 \
 JG_OBJ_GET_FLO(_suf, _type) { \
@@ -946,17 +1593,107 @@ JG_OBJ_GET_FLO(_suf, _type) { \
         *v = *defa; \
         return jg->ret = JG_OK; \
     } \
-    char * end = NULL; \
-    errno = 0; \
-    *v = _str_to_flo_func(child->json, &end); \
-    if (errno) { \
-        return jg->ret = _e_out_of_range; \
+    JG_JSON_TO_FLO(_json_to_flo_func, _use_dbl); \
+} \
+\
+JG_VAL_GET_FLO(_suf, _type) { \
+    JG_GUARD(check_state_get(jg)); \
+    JG_GUARD(check_null_arg(val)); \
+    struct jg_val_in const * child = get_val(jg, val); \
+    JG_JSON_TO_FLO(_json_to_flo_func, _use_dbl); \
+} \
+\
+JG_ARR_GET_FLO_ARRAY(_suf, _type) { \
+    JG_GUARD(check_state_get(jg)); \
+    JG_GUARD(check_arr_elems(jg, arr, arr_i, v, elem_c)); \
+    uint64_t const * entry = NULL; \
+    for (size_t i = 0; i < *elem_c; i++) { \
+        struct jg_val_in const * child = \
+            get_next_arr_elem(jg, arr, arr_i + i, &entry); \
+        jg_ret ret = check_type(jg, child, JG_TYPE_NUM); \
+        if (ret == JG_OK) { \
+            struct jg_num const * num = get_num(jg, child); \
+            if ((_use_dbl) && num && num->has_dbl) { \
+                v[i] = num->dbl; \
+                continue; \
+            } \
+            ret = (_json_to_flo_func)(get_val_json(jg, child), \
+                child->byte_c, v + i); \
+        } \
+        if (ret != JG_OK) { \
+            return fail_arr_elem(jg, child, ret, i, elem_c); \
+        } \
     } \
-    return jg->ret = end < child->json + child->byte_c ? \
-        JG_E_GET_NUM_NOT_FLO : JG_OK; \
+    return jg->ret = JG_OK; \
 }
 
-JG_GET_FUNC_FLO(_float, float, strtof, JG_E_GET_NUM_FLOAT_OUT_OF_RANGE)
-JG_GET_FUNC_FLO(_double, double, strtod, JG_E_GET_NUM_DOUBLE_OUT_OF_RANGE)
-JG_GET_FUNC_FLO(_long_double, long double, strtold,
-    JG_E_GET_NUM_LONG_DOUBLE_OUT_OF_RANGE)
+JG_GET_FUNC_FLO(_float, float, json_to_float, false)
+JG_GET_FUNC_FLO(_double, double, json_to_double, true)
+JG_GET_FUNC_FLO(_long_double, long double, json_to_long_double, false)
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_obj_iter_[begin|next|get_key]() //////////////////////////////////////////
+
+// Point iter at pair and its key, or past the last pair if pair is NULL
+static jg_ret set_iter_pair(
+    jg_t * jg,
+    jg_obj_iter * iter,
+    struct jg_pair const * pair,
+    struct jg_val_in const * key
+) {
+    iter->pair = pair;
+    if (!pair) {
+        iter->key = (jg_strview) {0};
+        iter->val = NULL;
+        return jg->ret = JG_OK;
+    }
+    iter->key = (jg_strview) {.str = key->json, .byte_c = key->byte_c};
+    iter->val = get_pair_val_handle(jg, pair);
+    return jg->ret = JG_OK;
+}
+
+jg_ret jg_obj_iter_begin(
+    jg_t * jg,
+    struct jg_obj const * obj,
+    jg_obj_iter * iter
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(obj));
+    JG_GUARD(check_null_arg(iter));
+    iter->obj = obj;
+    iter->pair_c = get_obj_pair_c(jg, obj);
+    struct jg_val_in key = {0};
+    return set_iter_pair(jg, iter, get_next_pair(jg, obj, NULL, &key), &key);
+}
+
+jg_ret jg_obj_iter_next(
+    jg_t * jg,
+    jg_obj_iter * iter
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(iter));
+    if (!iter->pair) { // Past the last pair already
+        return jg->ret = JG_OK;
+    }
+    struct jg_val_in key = {0};
+    return set_iter_pair(jg, iter,
+        get_next_pair(jg, iter->obj, iter->pair, &key), &key);
+}
+
+jg_ret jg_obj_iter_get_key(
+    jg_t * jg,
+    jg_obj_iter const * iter,
+    jg_strview * key
+) {
+    JG_GUARD(check_state_get(jg));
+    JG_GUARD(check_null_arg(iter));
+    JG_GUARD(check_null_arg(iter->val)); // Past the last pair
+    JG_GUARD(check_null_arg(key));
+    // Keys are never unescaped in place (see .unescape_in_place).
+    struct jg_val_in const json_key = {
+        .json = iter->key.str,
+        .byte_c = iter->key.byte_c
+    };
+    return get_strview(jg, json_key.json, json_key.byte_c,
+        get_dst_byte_c(&json_key, JG_STR_UNESC), false, key);
+}
@@ -2,8 +2,14 @@
 // Copyright © 2021 MetaWord Inc
 // Copyright © 2019-2021 William Budd
 
+#define _POSIX_C_SOURCE 201112L // munmap()
+
 #include "jgrandson_internal.h"
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/mman.h>
+#endif
+
 jg_t * jg_init(
     void
 ) {
@@ -13,10 +19,41 @@ jg_t * jg_init(
 void free_json_text(
     jg_t * jg
 ) {
-    if (!jg->json_is_callertext && jg->json_text) {
-        free(jg->json_text);
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (jg->json_mmap_byte_c) {
+        munmap((void *) jg->json_callertext, jg->json_mmap_byte_c);
+        jg->json_callertext = NULL;
+        jg->json_mmap_byte_c = 0;
+        return;
+    }
+#endif
+    if (jg->feed_buf) { // The JSON text is in the newest jg_parse_feed() buffer
+        for (struct jg_feed_buf * buf = jg->feed_buf; buf;) {
+            struct jg_feed_buf * prev = buf->prev;
+            free(buf);
+            buf = prev;
+        }
+        jg->feed_buf = NULL;
         jg->json_text = NULL;
+        return;
+    }
+    // Otherwise, any copy of the JSON text is in jg->text_buf (which is kept).
+    jg->json_text = NULL;
+}
+
+static void free_ndjson_text(
+    jg_t * jg
+) {
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (jg->ndjson.mmap_byte_c) {
+        munmap((void *) jg->ndjson.text, jg->ndjson.mmap_byte_c);
+        jg->ndjson.text = NULL;
+        jg->ndjson.mmap_byte_c = 0;
+        return;
     }
+#endif
+    // Otherwise, any copy of the NDJSON text is in jg->text_buf.
+    jg->ndjson.text = NULL;
 }
 
 void free_err_str(
@@ -68,31 +105,91 @@ jg_ret alloc_strcpy(
     return JG_OK;
 }
 
-static void free_value_in(
-    struct jg_val_in * v
+// Point *text at jg->text_buf, after enlarging it to at least byte_c bytes if
+// need be. Copies of (ND)JSON text go there, so that jg_reinit() can keep its
+// capacity for the next one.
+jg_ret alloc_text_buf(
+    jg_t * jg,
+    size_t byte_c,
+    char * * text
 ) {
-    switch (v->type) {
-    case JG_TYPE_ARR:
-        for (struct jg_val_in * elem = v->arr->elems;
-            elem < v->arr->elems + v->arr->elem_c; elem++) {
-            free_value_in(elem);
+    if (jg->text_buf_byte_c < byte_c) {
+        // Its old contents are of no use, so realloc() would copy in vain.
+        free(jg->text_buf);
+        jg->text_buf = malloc(byte_c);
+        if (!jg->text_buf) {
+            jg->text_buf_byte_c = 0;
+            return jg->ret = JG_E_MALLOC;
         }
-        free(v->arr);
-        return;
-    case JG_TYPE_OBJ:
-        for (struct jg_pair * pair = v->obj->pairs;
-            pair < v->obj->pairs + v->obj->pair_c; pair++) {
-            free_value_in(&pair->val);
+        jg->text_buf_byte_c = byte_c;
+    }
+    *text = jg->text_buf;
+    return JG_OK;
+}
+
+// The size of the first arena chunk, and the size beyond which chunk sizes stop
+// doubling (unless a single allocation requires more).
+#define JG_ARENA_CHUNK_MIN_BYTE_C 0x10000 // 64 KiB
+#define JG_ARENA_CHUNK_MAX_BYTE_C 0x4000000 // 64 MiB
+
+void * arena_alloc(
+    jg_t * jg,
+    size_t byte_c
+) {
+    // Arena allocations only contain pointers and integers no wider than those.
+    byte_c = (byte_c + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    // Try the current chunk, followed by any chunks retained by jg_reinit().
+    struct jg_arena_chunk * * next = &jg->arena_head;
+    size_t chunk_byte_c = JG_ARENA_CHUNK_MIN_BYTE_C / 2;
+    for (struct jg_arena_chunk * chunk = jg->arena_cur; chunk;
+        chunk = chunk->next) {
+        if (chunk->byte_c - chunk->used_byte_c >= byte_c) {
+            jg->arena_cur = chunk;
+            void * bytes = chunk->bytes + chunk->used_byte_c;
+            chunk->used_byte_c += byte_c;
+            return bytes;
         }
-        free(v->obj);
-        return;
-    default:
-        return;
+        next = &chunk->next;
+        chunk_byte_c = chunk->byte_c;
     }
+    chunk_byte_c = JG_MAX(byte_c, JG_MIN(2 * chunk_byte_c,
+        (size_t) JG_ARENA_CHUNK_MAX_BYTE_C));
+    struct jg_arena_chunk * chunk =
+        malloc(sizeof(struct jg_arena_chunk) + chunk_byte_c);
+    if (!chunk) {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->byte_c = chunk_byte_c;
+    chunk->used_byte_c = byte_c;
+    *next = jg->arena_cur = chunk;
+    return chunk->bytes;
 }
 
-static void free_value_out(
-    struct jg_val_out * v
+jg_ret push_frame(
+    jg_t * jg,
+    struct jg_frame * * frame
+) {
+    if (jg->frame_c == jg->frame_size) {
+        size_t frame_size = jg->frame_size ? 2 * jg->frame_size : 32;
+        struct jg_frame * frames =
+            realloc(jg->frames, frame_size * sizeof(struct jg_frame));
+        if (!frames) {
+            return jg->ret = JG_E_REALLOC;
+        }
+        jg->frames = frames;
+        jg->frame_size = frame_size;
+    }
+    *frame = jg->frames + jg->frame_c++;
+    return JG_OK;
+}
+
+// Free any string owned by v; or if v is a non-empty array or object, prepend
+// its node list to *arr_nodes or *obj_nodes for free_value_out() to free.
+static void unlink_value_out(
+    struct jg_val_out * v,
+    struct jg_arr_node * * arr_nodes,
+    struct jg_obj_node * * obj_nodes
 ) {
     switch (v->type) {
     case JG_TYPE_STR:
@@ -104,20 +201,23 @@ static void free_value_out(
         free(v->str);
         return;
     case JG_TYPE_ARR:
-        for (struct jg_arr_node * node = v->arr; node;) {
-            free_value_out(&node->elem);
-            struct jg_arr_node * node_next = node->next;
-            free(node);
-            node = node_next;
+        if (v->arr) {
+            struct jg_arr_node * tail = v->arr;
+            while (tail->next) {
+                tail = tail->next;
+            }
+            tail->next = *arr_nodes;
+            *arr_nodes = v->arr;
         }
         return;
     case JG_TYPE_OBJ:
-        for (struct jg_obj_node * node = v->obj; node;) {
-            free(node->key);
-            free_value_out(&node->val);
-            struct jg_obj_node * node_next = node->next;
-            free(node);
-            node = node_next;
+        if (v->obj) {
+            struct jg_obj_node * tail = v->obj;
+            while (tail->next) {
+                tail = tail->next;
+            }
+            tail->next = *obj_nodes;
+            *obj_nodes = v->obj;
         }
         return;
     default:
@@ -125,44 +225,214 @@ static void free_value_out(
     }
 }
 
+// Free everything v owns without recursing, and without needing any memory to
+// keep track of nesting: the node lists of nested arrays and objects are simply
+// spliced into the lists of nodes that remain to be freed. Every node is walked
+// at most twice, so this is O(node count).
+static void free_value_out(
+    struct jg_val_out * v
+) {
+    struct jg_arr_node * arr_nodes = NULL;
+    struct jg_obj_node * obj_nodes = NULL;
+    unlink_value_out(v, &arr_nodes, &obj_nodes);
+    while (arr_nodes || obj_nodes) {
+        if (arr_nodes) {
+            struct jg_arr_node * node = arr_nodes;
+            arr_nodes = node->next;
+            unlink_value_out(&node->elem, &arr_nodes, &obj_nodes);
+            free(node);
+        } else {
+            struct jg_obj_node * node = obj_nodes;
+            obj_nodes = node->next;
+            free(node->key);
+            unlink_value_out(&node->val, &arr_nodes, &obj_nodes);
+            free(node);
+        }
+    }
+}
+
+static void free_arena_chunks(
+    struct jg_arena_chunk * chunk
+) {
+    while (chunk) {
+        struct jg_arena_chunk * chunk_next = chunk->next;
+        free(chunk);
+        chunk = chunk_next;
+    }
+}
+
+// Whether a buffer of byte_c bytes fits within the *budget that remains; and if
+// so, deduct it from the budget.
+static bool fits_budget(
+    size_t * budget,
+    size_t byte_c
+) {
+    if (byte_c > *budget) {
+        return false;
+    }
+    *budget -= byte_c;
+    return true;
+}
+
+// Free any buffers that jg_reinit() would otherwise retain in excess of
+// .opt_parse.max_retained_byte_c. Buffers that every parse needs get first dibs
+// on that budget; followed by the arena, which is kept in order of allocation.
+static void trim_retained(
+    jg_t * jg
+) {
+    size_t budget = jg->opt_parse.max_retained_byte_c;
+    if (!budget) {
+        return;
+    }
+    if (!fits_budget(&budget, jg->frame_size * sizeof(struct jg_frame))) {
+        free(jg->frames);
+        jg->frames = NULL;
+        jg->frame_size = 0;
+    }
+    if (!fits_budget(&budget, jg->stack_size * sizeof(struct jg_val_in))) {
+        free(jg->stack);
+        jg->stack = NULL;
+        jg->stack_size = 0;
+    }
+    // Not while it holds the NDJSON text kept by reinit_for_ndjson_record()
+    if (jg->ndjson.text != jg->text_buf &&
+        !fits_budget(&budget, jg->text_buf_byte_c)) {
+        free(jg->text_buf);
+        jg->text_buf = NULL;
+        jg->text_buf_byte_c = 0;
+    }
+    if (!fits_budget(&budget, jg->tape_size * sizeof(uint64_t))) {
+        free(jg->tape);
+        jg->tape = NULL;
+        jg->tape_size = 0;
+    }
+    if (!fits_budget(&budget,
+        jg->obj_index_slot_c * sizeof(struct jg_obj_index_slot))) {
+        free(jg->obj_indexes);
+        jg->obj_indexes = NULL;
+        jg->obj_index_slot_c = 0;
+    }
+    if (!fits_budget(&budget,
+        jg->lazy_skip_size * sizeof(struct jg_lazy_skip))) {
+        free(jg->lazy_skips);
+        jg->lazy_skips = NULL;
+        jg->lazy_skip_size = 0;
+    }
+    struct jg_arena_chunk * * chunk = &jg->arena_head;
+    while (*chunk && fits_budget(&budget,
+        sizeof(struct jg_arena_chunk) + (*chunk)->byte_c)) {
+        chunk = &(*chunk)->next;
+    }
+    free_arena_chunks(*chunk);
+    *chunk = NULL;
+}
+
 static void free_all(
     jg_t * jg,
-    bool free_jg
+    bool free_jg,
+    bool keep_ndjson // Keep the NDJSON text for the next record (if any)
 ) {
+    if (jg->doc) { // The DOM belongs to the document.
+        stop_reading_doc(jg);
+    }
+    if (jg->tape_is_image) { // The tape is unmapped along with the JSON text.
+        stop_reading_image(jg);
+    }
     switch (jg->state) {
     case JG_STATE_INIT:
-        if (free_jg) {
-            free(jg);
-        }
-        return;
     case JG_STATE_PARSE:
     case JG_STATE_GET:
-        free_value_in(&jg->root_in);
-        break;
+        break; // The parsed DOM (if any) resides entirely in the arena.
     case JG_STATE_SET:
     case JG_STATE_GENERATE: default:
         free_value_out(&jg->root_out);
     }
     free_json_text(jg);
+    if (!keep_ndjson) {
+        free_ndjson_text(jg);
+    }
     free_err_str(jg);
     if (jg->custom_err_str) {
         free(jg->custom_err_str);
     }
     if (free_jg) {
+        free_arena_chunks(jg->arena_head);
+        free(jg->stack);
+        free(jg->tape);
+        free(jg->frames);
+        free(jg->lazy_skips);
+        free(jg->obj_indexes); // The jg_index structs are in the arena.
+        free(jg->text_buf);
         free(jg);
-    } else {
-        memset(jg, 0, sizeof(*jg));
+        return;
+    }
+    // Retain the arena, the parse stack, the tape, the frames, the lazy skips,
+    // the object index slots, and the text buffer (up to .max_retained_byte_c),
+    // such that subsequent parses can reuse their capacity without having to
+    // malloc() anything. Parse options are retained too.
+    trim_retained(jg);
+    struct jg_arena_chunk * arena_head = jg->arena_head;
+    struct jg_val_in * stack = jg->stack;
+    size_t stack_size = jg->stack_size;
+    uint64_t * tape = jg->tape;
+    size_t tape_size = jg->tape_size;
+    struct jg_frame * frames = jg->frames;
+    size_t frame_size = jg->frame_size;
+    struct jg_lazy_skip * lazy_skips = jg->lazy_skips;
+    size_t lazy_skip_size = jg->lazy_skip_size;
+    struct jg_obj_index_slot * obj_indexes = jg->obj_indexes;
+    size_t obj_index_slot_c = jg->obj_index_slot_c;
+    char * text_buf = jg->text_buf;
+    size_t text_buf_byte_c = jg->text_buf_byte_c;
+    struct jg_opt_parse opt_parse = jg->opt_parse;
+    struct jg_ndjson ndjson = {0};
+    uint64_t hash_seed = 0;
+    if (keep_ndjson) {
+        // Keeping the seed saves having to generate a new one for every record.
+        ndjson = jg->ndjson;
+        hash_seed = jg->hash_seed;
+    }
+    memset(jg, 0, sizeof(*jg));
+    for (struct jg_arena_chunk * chunk = arena_head; chunk;
+        chunk = chunk->next) {
+        chunk->used_byte_c = 0;
     }
+    jg->arena_head = jg->arena_cur = arena_head;
+    jg->stack = stack;
+    jg->stack_size = stack_size;
+    jg->tape = tape;
+    jg->tape_size = tape_size;
+    jg->frames = frames;
+    jg->frame_size = frame_size;
+    jg->lazy_skips = lazy_skips;
+    jg->lazy_skip_size = lazy_skip_size;
+    if (obj_indexes) {
+        memset(obj_indexes, 0,
+            obj_index_slot_c * sizeof(struct jg_obj_index_slot));
+    }
+    jg->obj_indexes = obj_indexes;
+    jg->obj_index_slot_c = obj_index_slot_c;
+    jg->text_buf = text_buf;
+    jg->text_buf_byte_c = text_buf_byte_c;
+    jg->opt_parse = opt_parse;
+    jg->ndjson = ndjson;
+    jg->hash_seed = hash_seed;
 }
 
 void jg_free(
     jg_t * jg
 ) {
-    free_all(jg, true);
+    free_all(jg, true, false);
 }
 
 void jg_reinit(
     jg_t * jg
 ) {
-    free_all(jg, false);
+    free_all(jg, false, false);
+}
+
+void reinit_for_ndjson_record(
+    jg_t * jg
+) {
+    free_all(jg, false, true);
 }
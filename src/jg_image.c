@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+// An image is the JSON text (with its string values unescaped in place),
+// zero-padded to a multiple of 8 bytes, followed by the tape DOM, followed by
+// this trailer. Tape entries locate their values by offset into the JSON text,
+// so an image can be mapped at any address and read as-is.
+struct jg_image_trailer {
+    uint64_t text_byte_c;
+    uint64_t tape_c;
+    uint64_t magic; // Last, such that a truncated image is rejected
+};
+
+// "JGIMAGE\1" in little-endian byte order, such that an image saved on a
+// platform with the opposite byte order is rejected
+#define JG_IMAGE_MAGIC 0x014547414D49474AULL
+
+// The number of tape entries write_image_tape() buffers per fwrite()
+#define JG_IMAGE_TAPE_CHUNK_C 0x200
+
+static size_t get_pad_byte_c(
+    size_t text_byte_c
+) {
+    return (sizeof(uint64_t) - text_byte_c % sizeof(uint64_t)) %
+        sizeof(uint64_t);
+}
+
+static jg_ret write_bytes(
+    jg_t * jg,
+    FILE * f,
+    void const * bytes,
+    size_t byte_c
+) {
+    if (byte_c && fwrite(bytes, 1, byte_c, f) != byte_c) {
+        return jg->ret = JG_E_FWRITE;
+    }
+    return JG_OK;
+}
+
+// Whether the STR entry is a string value with escape sequences. Keys are
+// left escaped, the same as .unescape_in_place leaves them: a key is told
+// apart from a value by the ':' that follows it.
+static bool is_escaped_str_val(
+    jg_t const * jg,
+    uint64_t entry
+) {
+    if (JG_TAPE_TYPE(entry) != JG_TYPE_STR) {
+        return false;
+    }
+    char const * json = jg->json_callertext + JG_TAPE_OFFSET(entry);
+    size_t byte_c = JG_TAPE_AUX(entry);
+    if (!memchr(json, '\\', byte_c)) {
+        return false;
+    }
+    char const * c = json + byte_c + 1; // The char following the closing '"'
+    skip_any_whitespace_or_comments(&c, jg->json_over);
+    return c == jg->json_over || *c != ':';
+}
+
+// Write the JSON text as if .unescape_in_place unescaped it: each unescaped
+// string value is followed by the remainder of the original, such that the
+// offsets of all values stay the same.
+static jg_ret write_image_text(
+    jg_t * jg,
+    FILE * f,
+    size_t text_byte_c,
+    uint64_t const * tape,
+    size_t tape_c
+) {
+    char const * text = jg->json_callertext;
+    size_t written_byte_c = 0;
+    uint8_t * unesc_str = NULL;
+    size_t unesc_str_size = 0;
+    jg_ret ret = JG_OK;
+    bool is_skip_entry = false;
+    for (size_t i = 0; i < tape_c; i++) {
+        uint64_t entry = tape[i];
+        if (is_skip_entry) {
+            is_skip_entry = false;
+            continue;
+        }
+        enum jg_type type = JG_TAPE_TYPE(entry);
+        is_skip_entry = type == JG_TYPE_ARR || type == JG_TYPE_OBJ;
+        if (!is_escaped_str_val(jg, entry)) {
+            continue;
+        }
+        size_t offset = JG_TAPE_OFFSET(entry);
+        size_t json_byte_c = JG_TAPE_AUX(entry);
+        size_t unesc_byte_c =
+            get_unesc_byte_c((uint8_t const *) text + offset, json_byte_c);
+        if (unesc_byte_c > unesc_str_size) {
+            uint8_t * str = realloc(unesc_str, unesc_byte_c);
+            if (!str) {
+                ret = jg->ret = JG_E_REALLOC;
+                break;
+            }
+            unesc_str = str;
+            unesc_str_size = unesc_byte_c;
+        }
+        json_str_to_unesc_str((uint8_t const *) text + offset, json_byte_c,
+            unesc_str);
+        ret = write_bytes(jg, f, text + written_byte_c,
+            offset - written_byte_c);
+        if (ret != JG_OK) {
+            break;
+        }
+        ret = write_bytes(jg, f, unesc_str, unesc_byte_c);
+        if (ret != JG_OK) {
+            break;
+        }
+        written_byte_c = offset + unesc_byte_c;
+    }
+    free(unesc_str);
+    if (ret != JG_OK) {
+        return ret;
+    }
+    return write_bytes(jg, f, text + written_byte_c,
+        text_byte_c - written_byte_c);
+}
+
+// Write the tape with the byte_c of each string value written unescaped by
+// write_image_text() updated accordingly
+static jg_ret write_image_tape(
+    jg_t * jg,
+    FILE * f,
+    uint64_t const * tape,
+    size_t tape_c
+) {
+    uint64_t chunk[JG_IMAGE_TAPE_CHUNK_C];
+    size_t chunk_c = 0;
+    bool is_skip_entry = false;
+    for (size_t i = 0; i < tape_c; i++) {
+        uint64_t entry = tape[i];
+        if (is_skip_entry) {
+            is_skip_entry = false;
+        } else if (JG_TAPE_TYPE(entry) == JG_TYPE_ARR ||
+            JG_TAPE_TYPE(entry) == JG_TYPE_OBJ) {
+            is_skip_entry = true;
+        } else if (is_escaped_str_val(jg, entry)) {
+            size_t offset = JG_TAPE_OFFSET(entry);
+            entry = JG_TAPE_ENTRY(JG_TYPE_STR, get_unesc_byte_c(
+                (uint8_t const *) jg->json_callertext + offset,
+                JG_TAPE_AUX(entry)), offset);
+        }
+        chunk[chunk_c++] = entry;
+        if (chunk_c == JG_IMAGE_TAPE_CHUNK_C) {
+            JG_GUARD(write_bytes(jg, f, chunk, sizeof(chunk)));
+            chunk_c = 0;
+        }
+    }
+    return write_bytes(jg, f, chunk, chunk_c * sizeof(uint64_t));
+}
+
+// A root other than an array or object is not on the tape, so its image gets
+// a tape of its own.
+static uint64_t get_root_entry(
+    jg_t const * jg
+) {
+    struct jg_val_in const * v = &jg->root_in;
+    size_t offset = v->json ? (size_t) (v->json - jg->json_callertext) : 0;
+    switch (v->type) {
+    case JG_TYPE_NULL:
+        return JG_TAPE_ENTRY(JG_TYPE_NULL, 0, offset);
+    case JG_TYPE_BOOL:
+        return JG_TAPE_ENTRY(JG_TYPE_BOOL, v->bool_is_true, offset);
+    default:
+        return JG_TAPE_ENTRY(v->type, v->byte_c, offset);
+    }
+}
+
+static jg_ret write_image(
+    jg_t * jg,
+    FILE * f
+) {
+    uint64_t root_entry = 0;
+    uint64_t const * tape = jg->tape;
+    size_t tape_c = jg->tape_c;
+    if (!tape_c) {
+        root_entry = get_root_entry(jg);
+        tape = &root_entry;
+        tape_c = 1;
+    }
+    size_t text_byte_c = jg->json_over - jg->json_callertext;
+    if (jg->unescapes_strs) { // Nothing left to unescape
+        JG_GUARD(write_bytes(jg, f, jg->json_callertext, text_byte_c));
+    } else {
+        JG_GUARD(write_image_text(jg, f, text_byte_c, tape, tape_c));
+    }
+    static uint8_t const pad[sizeof(uint64_t)] = {0};
+    JG_GUARD(write_bytes(jg, f, pad, get_pad_byte_c(text_byte_c)));
+    if (jg->unescapes_strs) {
+        JG_GUARD(write_bytes(jg, f, tape, tape_c * sizeof(uint64_t)));
+    } else {
+        JG_GUARD(write_image_tape(jg, f, tape, tape_c));
+    }
+    struct jg_image_trailer trailer = {
+        .text_byte_c = text_byte_c,
+        .tape_c = tape_c,
+        .magic = JG_IMAGE_MAGIC
+    };
+    return write_bytes(jg, f, &trailer, sizeof(trailer));
+}
+
+jg_ret jg_save_image(
+    jg_t * jg,
+    char const * filepath
+) {
+    if (jg->state != JG_STATE_GET) {
+        return jg->ret = JG_E_STATE_NOT_GET;
+    }
+    if (!jg->opt_parse.tape) {
+        return jg->ret = JG_E_IMAGE_NOT_TAPE;
+    }
+    FILE * f = fopen(filepath, "wb");
+    if (!f) {
+        jg->err_val.errn = errno;
+        return jg->ret = JG_E_ERRNO_FOPEN;
+    }
+    jg_ret ret = write_image(jg, f);
+    if (fclose(f) && ret == JG_OK) {
+        jg->err_val.errn = errno;
+        ret = JG_E_ERRNO_FCLOSE;
+    }
+    return jg->ret = ret;
+}
+
+// Whether the root entry (the first on the tape) lies within the image: a
+// container must span the whole tape, and a scalar root must lie within the
+// JSON text (being the only tape entry).
+static bool is_valid_root_entry(
+    uint64_t const * tape,
+    size_t tape_c,
+    size_t text_byte_c
+) {
+    switch (JG_TAPE_TYPE(tape[0])) {
+    case JG_TYPE_ARR:
+    case JG_TYPE_OBJ:
+        return tape_c >= 2 && tape[1] == tape_c &&
+            JG_TAPE_OFFSET(tape[0]) < text_byte_c;
+    case JG_TYPE_NULL:
+    case JG_TYPE_BOOL:
+        return tape_c == 1 && JG_TAPE_OFFSET(tape[0]) <= text_byte_c;
+    case JG_TYPE_NUM:
+    case JG_TYPE_STR:
+        return tape_c == 1 && JG_TAPE_OFFSET(tape[0]) <= text_byte_c &&
+            JG_TAPE_AUX(tape[0]) <= text_byte_c - JG_TAPE_OFFSET(tape[0]);
+    default:
+        return false;
+    }
+}
+
+// Only the trailer and the root entry are checked, so this takes O(1) time
+// regardless of the size of the image (the rest of the tape is trusted). Every
+// size is checked against byte_c before anything else is read from the image.
+static jg_ret check_image(
+    jg_t * jg,
+    size_t byte_c,
+    struct jg_image_trailer * trailer
+) {
+    if (byte_c < sizeof(*trailer) || byte_c % sizeof(uint64_t)) {
+        return jg->ret = JG_E_IMAGE_INVALID;
+    }
+    size_t body_byte_c = byte_c - sizeof(*trailer);
+    memcpy(trailer, jg->json_callertext + body_byte_c, sizeof(*trailer));
+    if (trailer->magic != JG_IMAGE_MAGIC ||
+        trailer->text_byte_c > body_byte_c) {
+        return jg->ret = JG_E_IMAGE_INVALID;
+    }
+    // body_byte_c being a multiple of 8, so is the remainder.
+    size_t text_byte_c = trailer->text_byte_c;
+    size_t tape_byte_c = body_byte_c - text_byte_c -
+        get_pad_byte_c(text_byte_c);
+    if (!trailer->tape_c || trailer->tape_c != tape_byte_c / sizeof(uint64_t) ||
+        !is_valid_root_entry((uint64_t const *) (jg->json_callertext +
+        text_byte_c + get_pad_byte_c(text_byte_c)), trailer->tape_c,
+        text_byte_c)) {
+        return jg->ret = JG_E_IMAGE_INVALID;
+    }
+    return JG_OK;
+}
+
+// Map the image into memory read-only (or on Windows, copy it to a malloc-ed
+// char buffer), then point the tape and JSON text of jg into it as-is.
+jg_ret jg_load_image(
+    jg_t * jg,
+    char const * filepath
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->state = JG_STATE_PARSE;
+    size_t byte_c = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    JG_GUARD(read_file(jg, filepath, &jg->json_text, &byte_c));
+    byte_c--; // The newline appended by read_file()
+#else
+    // Getters access the image randomly, so no read-ahead is asked for.
+    JG_GUARD(map_file(jg, filepath, false, &jg->json_callertext, &byte_c));
+    jg->json_is_callertext = true;
+    jg->json_mmap_byte_c = byte_c;
+#endif
+    struct jg_image_trailer trailer;
+    JG_GUARD(check_image(jg, byte_c, &trailer));
+    size_t text_byte_c = trailer.text_byte_c;
+    // The tape jg retained (if any) would otherwise be lost.
+    free(jg->tape);
+    // Getters never write to the tape, so casting away its const is fine.
+    jg->tape = (uint64_t *) (jg->json_callertext + text_byte_c +
+        get_pad_byte_c(text_byte_c));
+    jg->tape_c = trailer.tape_c;
+    jg->tape_size = 0;
+    jg->tape_is_image = true;
+    jg->json_over = jg->json_callertext + text_byte_c;
+    jg->decodes_nums = false;
+    jg->unescapes_strs = true;
+    jg->own_opt_tape = jg->opt_parse.tape;
+    jg->opt_parse.tape = true;
+    if (!jg->hash_seed) {
+        jg->hash_seed = new_hash_seed(jg);
+    }
+    tape_get_val(jg, jg->tape, &jg->root_in);
+    jg->state = JG_STATE_GET;
+    return jg->ret = JG_OK;
+}
+
+void stop_reading_image(
+    jg_t * jg
+) {
+    jg->tape = NULL;
+    jg->tape_c = 0;
+    jg->tape_is_image = false;
+    jg->opt_parse.tape = jg->own_opt_tape;
+}
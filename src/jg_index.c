@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+#include <time.h>
+
+static uint64_t mix64( // The splitmix64 finalizer
+    uint64_t h
+) {
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+uint64_t new_hash_seed(
+    jg_t const * jg
+) {
+    // Keys come from the JSON text, so an unseeded hash would let whoever
+    // writes that text pick keys that all collide, degrading every index to a
+    // linear scan. Addresses (if randomized) and time make for a seed that is
+    // not cryptographically strong, but without requiring any OS-specific API.
+    uint64_t h = mix64((uintptr_t) jg ^ (uint64_t) time(NULL));
+    h = mix64(h ^ (uintptr_t) jg->json_text);
+    h = mix64(h ^ (uintptr_t) &h);
+    return mix64(h ^ (uint64_t) clock());
+}
+
+uint64_t hash_bytes(
+    uint64_t seed,
+    uint8_t const * bytes,
+    size_t byte_c
+) {
+    // A simple word-at-a-time multiply-xorshift hash: the word loads are
+    // endianness-dependent, but hashes never leave the process anyway.
+    uint64_t h = seed ^ byte_c;
+    for (; byte_c >= sizeof(uint64_t); byte_c -= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, bytes, sizeof(uint64_t));
+        bytes += sizeof(uint64_t);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    uint64_t word = 0;
+    memcpy(&word, bytes, byte_c);
+    h = (h ^ word) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 29);
+}
+
+uint32_t hash_unesc_str(
+    uint64_t seed,
+    uint8_t const * str,
+    size_t byte_c
+) {
+    uint64_t h = hash_bytes(seed, str, byte_c);
+    return (uint32_t) (h ^ (h >> 32));
+}
+
+jg_ret hash_json_str(
+    jg_t * jg,
+    uint8_t const * json_str,
+    size_t json_byte_c,
+    uint32_t * hash
+) {
+    if (!memchr(json_str, '\\', json_byte_c)) {
+        *hash = hash_unesc_str(jg->hash_seed, json_str, json_byte_c);
+        return JG_OK;
+    }
+    size_t unesc_byte_c = get_unesc_byte_c(json_str, json_byte_c);
+    uint8_t stack_buf[128];
+    uint8_t * unesc_str = stack_buf;
+    if (unesc_byte_c > sizeof(stack_buf)) {
+        unesc_str = malloc(unesc_byte_c);
+        if (!unesc_str) {
+            return jg->ret = JG_E_MALLOC;
+        }
+    }
+    json_str_to_unesc_str(json_str, json_byte_c, unesc_str);
+    *hash = hash_unesc_str(jg->hash_seed, unesc_str, unesc_byte_c);
+    if (unesc_str != stack_buf) {
+        free(unesc_str);
+    }
+    return JG_OK;
+}
+
+jg_ret alloc_index(
+    jg_t * jg,
+    size_t key_c,
+    struct jg_index * * index
+) {
+    // Keep the load factor at or below 1/2 to keep probe sequences short.
+    size_t slot_c = 8;
+    while (slot_c < 2 * key_c) {
+        slot_c *= 2;
+    }
+    *index = arena_alloc(jg,
+        sizeof(struct jg_index) + slot_c * sizeof(struct jg_index_slot));
+    if (!*index) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    (*index)->slot_c = slot_c;
+    (*index)->key_c = 0;
+    memset((*index)->slots, 0, slot_c * sizeof(struct jg_index_slot));
+    return JG_OK;
+}
+
+jg_ret reserve_index_key(
+    jg_t * jg,
+    struct jg_index * * index
+) {
+    if (2 * ((*index)->key_c + 1) <= (*index)->slot_c) {
+        return JG_OK;
+    }
+    // The old index is simply abandoned to the arena: because slot_c doubles
+    // each time, all copies together take less room than the final index.
+    struct jg_index const * old = *index;
+    JG_GUARD(alloc_index(jg, old->key_c + 1, index));
+    for (size_t i = 0; i < old->slot_c; i++) {
+        if (old->slots[i].pos_plus_1) {
+            index_insert(*index, old->slots[i].hash,
+                old->slots[i].pos_plus_1 - 1);
+        }
+    }
+    return JG_OK;
+}
+
+void index_insert(
+    struct jg_index * index,
+    uint32_t hash,
+    uint32_t pos
+) {
+    size_t mask = index->slot_c - 1;
+    size_t slot_i = hash & mask;
+    while (index->slots[slot_i].pos_plus_1) {
+        slot_i = (slot_i + 1) & mask; // linear probing
+    }
+    index->slots[slot_i].hash = hash;
+    index->slots[slot_i].pos_plus_1 = pos + 1;
+    index->key_c++;
+}
+
+bool index_find_next(
+    struct jg_index const * index,
+    uint32_t hash,
+    size_t * slot_i,
+    uint32_t * pos
+) {
+    size_t mask = index->slot_c - 1;
+    for (;; *slot_i = (*slot_i + 1) & mask) {
+        struct jg_index_slot const * slot = index->slots + *slot_i;
+        if (!slot->pos_plus_1) {
+            return false;
+        }
+        if (slot->hash == hash) {
+            *pos = slot->pos_plus_1 - 1;
+            *slot_i = (*slot_i + 1) & mask; // Resume after this slot next time
+            return true;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// jg->obj_indexes: object indexes by the location of the object's opening '{'
+
+struct jg_index * get_obj_index(
+    jg_t * jg,
+    char const * obj_json
+) {
+    if (!jg->obj_index_c) {
+        return NULL;
+    }
+    size_t mask = jg->obj_index_slot_c - 1;
+    for (size_t i = ((uintptr_t) obj_json >> 1) & mask;; i = (i + 1) & mask) {
+        if (jg->obj_indexes[i].obj_json == obj_json) {
+            return jg->obj_indexes[i].index;
+        }
+        if (!jg->obj_indexes[i].obj_json) {
+            return NULL;
+        }
+    }
+}
+
+static void put_obj_index(
+    struct jg_obj_index_slot * slots,
+    size_t slot_c,
+    char const * obj_json,
+    struct jg_index * index
+) {
+    size_t mask = slot_c - 1;
+    size_t i = ((uintptr_t) obj_json >> 1) & mask;
+    while (slots[i].obj_json) {
+        i = (i + 1) & mask;
+    }
+    slots[i].obj_json = obj_json;
+    slots[i].index = index;
+}
+
+jg_ret set_obj_index(
+    jg_t * jg,
+    char const * obj_json,
+    struct jg_index * index
+) {
+    if (2 * (jg->obj_index_c + 1) > jg->obj_index_slot_c) {
+        size_t slot_c = jg->obj_index_slot_c ? 2 * jg->obj_index_slot_c : 16;
+        struct jg_obj_index_slot * slots =
+            calloc(slot_c, sizeof(struct jg_obj_index_slot));
+        if (!slots) {
+            return jg->ret = JG_E_CALLOC;
+        }
+        for (size_t i = 0; i < jg->obj_index_slot_c; i++) {
+            if (jg->obj_indexes[i].obj_json) {
+                put_obj_index(slots, slot_c, jg->obj_indexes[i].obj_json,
+                    jg->obj_indexes[i].index);
+            }
+        }
+        free(jg->obj_indexes);
+        jg->obj_indexes = slots;
+        jg->obj_index_slot_c = slot_c;
+    }
+    put_obj_index(jg->obj_indexes, jg->obj_index_slot_c, obj_json, index);
+    jg->obj_index_c++;
+    return JG_OK;
+}
+
+// In tape mode, the '{' of a tape object is located relative to jg->json_text,
+// so when jg_parse_feed() moves the JSON text to a larger buffer, the indexes
+// already set must be moved to the '{' in that new buffer along with it.
+jg_ret rebase_obj_indexes(
+    jg_t * jg,
+    char const * old_text,
+    char const * new_text
+) {
+    if (!jg->obj_index_c) {
+        return JG_OK;
+    }
+    struct jg_obj_index_slot * slots =
+        calloc(jg->obj_index_slot_c, sizeof(struct jg_obj_index_slot));
+    if (!slots) {
+        return jg->ret = JG_E_CALLOC;
+    }
+    for (size_t i = 0; i < jg->obj_index_slot_c; i++) {
+        if (jg->obj_indexes[i].obj_json) {
+            put_obj_index(slots, jg->obj_index_slot_c,
+                new_text + (jg->obj_indexes[i].obj_json - old_text),
+                jg->obj_indexes[i].index);
+        }
+    }
+    free(jg->obj_indexes);
+    jg->obj_indexes = slots;
+    return JG_OK;
+}
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+// The number of lines a thread claims at a time. Claims are made under a mutex,
+// so they must be large enough for contention to be rare. In ordered mode each
+// line of a claim gets a jg_t of its own, because the thread must hold on to
+// all of its records until it is their turn to be delivered; so claims are
+// smaller there, to limit both memory use and the time spent waiting.
+#define JG_NDJSON_BATCH_LINE_C 256
+#define JG_NDJSON_ORDERED_BATCH_LINE_C 32
+
+struct jg_ndjson_pool {
+    jg_t * jg; // The jg_t given to jg_parse_ndjson_parallel()
+    jg_ndjson_cb cb;
+    void * cb_arg;
+    size_t batch_line_c;
+    bool is_ordered;
+    // Protects all members below, and is signalled whenever .deliver_seq or
+    // .stop changes
+    struct jg_lock lock;
+    char const * cur; // The start of the first line not yet claimed
+    size_t line_i; // The number of lines claimed so far
+    size_t claim_seq; // The sequence number of the next batch to be claimed
+    size_t deliver_seq; // The batch whose records are next in line (if ordered)
+    bool stop; // Set once a callback returns false
+};
+
+// A range of consecutive lines claimed by a thread
+struct jg_ndjson_batch {
+    char const * cur;
+    char const * over;
+    size_t line_i; // The number of lines preceding .cur
+    size_t seq;
+};
+
+struct jg_ndjson_rec {
+    jg_t * jg;
+    size_t line_i;
+    jg_ret ret;
+};
+
+struct jg_ndjson_worker {
+    struct jg_ndjson_pool * pool;
+    struct jg_ndjson_rec * recs; // 1 (unordered) or .batch_line_c (ordered)
+};
+
+// Must be called with the pool locked.
+static bool claim_batch(
+    struct jg_ndjson_pool * pool,
+    struct jg_ndjson_batch * batch
+) {
+    char const * over = pool->jg->ndjson.over;
+    if (pool->stop || pool->cur == over) {
+        return false;
+    }
+    batch->cur = pool->cur;
+    batch->line_i = pool->line_i;
+    batch->seq = pool->claim_seq++;
+    for (size_t i = pool->batch_line_c; i--;) {
+        pool->line_i++;
+        char const * line_over = memchr(pool->cur, '\n', over - pool->cur);
+        if (!line_over) {
+            pool->cur = over;
+            break;
+        }
+        pool->cur = line_over + 1;
+        if (pool->cur == over) {
+            break;
+        }
+    }
+    batch->over = pool->cur;
+    return true;
+}
+
+// Point the worker's jg_t at the lines from cur to over, as if the NDJSON text
+// consisted of only those, such that jg_parse_ndjson_next() parses them as
+// usual (albeit with line numbers starting at line_i + 1).
+static void set_ndjson_range(
+    jg_t * jg,
+    char const * cur,
+    char const * over,
+    size_t line_i
+) {
+    jg->ndjson.cur = cur;
+    jg->ndjson.over = over;
+    jg->ndjson.line_i = line_i;
+}
+
+// Deliver each record as soon as it is parsed.
+static void parse_batch_unordered(
+    struct jg_ndjson_worker * worker,
+    struct jg_ndjson_batch * batch
+) {
+    struct jg_ndjson_pool * pool = worker->pool;
+    jg_t * jg = worker->recs->jg;
+    set_ndjson_range(jg, batch->cur, batch->over, batch->line_i);
+    for (;;) {
+        size_t line_i = 0;
+        jg_ret ret = jg_parse_ndjson_next(jg, &line_i);
+        if (!line_i) {
+            return;
+        }
+        if (!pool->cb(jg, line_i, ret, pool->cb_arg)) {
+            acquire_lock(&pool->lock);
+            pool->stop = true;
+            release_lock(&pool->lock);
+            return;
+        }
+    }
+}
+
+// Parse all records of the batch, then wait for the batch's turn to deliver
+// them: the first line of each record follows the last line of the previous
+// one, so a jg_t per line is always enough.
+static void parse_batch_ordered(
+    struct jg_ndjson_worker * worker,
+    struct jg_ndjson_batch * batch
+) {
+    struct jg_ndjson_pool * pool = worker->pool;
+    char const * cur = batch->cur;
+    size_t line_i = batch->line_i;
+    size_t rec_c = 0;
+    for (; rec_c < pool->batch_line_c; rec_c++) {
+        struct jg_ndjson_rec * rec = worker->recs + rec_c;
+        set_ndjson_range(rec->jg, cur, batch->over, line_i);
+        rec->ret = jg_parse_ndjson_next(rec->jg, &rec->line_i);
+        if (!rec->line_i) {
+            break;
+        }
+        cur = rec->jg->ndjson.cur;
+        line_i = rec->line_i;
+    }
+    acquire_lock(&pool->lock);
+    while (pool->deliver_seq != batch->seq && !pool->stop) {
+        wait_for_lock_signal(&pool->lock);
+    }
+    bool stop = pool->stop;
+    release_lock(&pool->lock);
+    // Only this thread can deliver now, so the callbacks are made unlocked.
+    for (size_t i = 0; !stop && i < rec_c; i++) {
+        struct jg_ndjson_rec * rec = worker->recs + i;
+        stop = !pool->cb(rec->jg, rec->line_i, rec->ret, pool->cb_arg);
+    }
+    acquire_lock(&pool->lock);
+    pool->deliver_seq++;
+    pool->stop |= stop;
+    signal_lock(&pool->lock);
+    release_lock(&pool->lock);
+}
+
+static void * run_worker(
+    void * arg
+) {
+    struct jg_ndjson_worker * worker = arg;
+    struct jg_ndjson_pool * pool = worker->pool;
+    for (;;) {
+        struct jg_ndjson_batch batch;
+        acquire_lock(&pool->lock);
+        bool is_claimed = claim_batch(pool, &batch);
+        release_lock(&pool->lock);
+        if (!is_claimed) {
+            return NULL;
+        }
+        if (pool->is_ordered) {
+            parse_batch_ordered(worker, &batch);
+        } else {
+            parse_batch_unordered(worker, &batch);
+        }
+    }
+}
+
+static void free_workers(
+    struct jg_ndjson_worker * workers,
+    size_t worker_c,
+    size_t rec_c
+) {
+    for (size_t i = 0; i < worker_c; i++) {
+        if (workers[i].recs) {
+            for (size_t j = 0; j < rec_c; j++) {
+                if (workers[i].recs[j].jg) {
+                    jg_free(workers[i].recs[j].jg);
+                }
+            }
+            free(workers[i].recs);
+        }
+    }
+    free(workers);
+}
+
+// Each worker's jg_t parses the driver's NDJSON text in place, with the same
+// parse options and hash seed.
+static jg_ret init_workers(
+    jg_t * jg,
+    struct jg_ndjson_pool * pool,
+    struct jg_ndjson_worker * workers,
+    size_t worker_c,
+    size_t rec_c
+) {
+    for (size_t i = 0; i < worker_c; i++) {
+        workers[i].pool = pool;
+        workers[i].recs = calloc(rec_c, sizeof(struct jg_ndjson_rec));
+        if (!workers[i].recs) {
+            return jg->ret = JG_E_CALLOC;
+        }
+        for (size_t j = 0; j < rec_c; j++) {
+            jg_t * rec_jg = workers[i].recs[j].jg = jg_init();
+            if (!rec_jg) {
+                return jg->ret = JG_E_CALLOC;
+            }
+            rec_jg->opt_parse = jg->opt_parse;
+            rec_jg->hash_seed = jg->hash_seed;
+            rec_jg->ndjson.text = jg->ndjson.text;
+            rec_jg->ndjson.is_callertext = true;
+        }
+    }
+    return JG_OK;
+}
+
+jg_ret jg_parse_ndjson_parallel(
+    jg_t * jg,
+    jg_opt_ndjson const * opt,
+    jg_ndjson_cb cb,
+    void * cb_arg
+) {
+    if (!jg->ndjson.text) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    if (!cb) { // Rather than have every worker thread call NULL
+        return jg->ret = JG_E_GET_ARG_IS_NULL;
+    }
+    reinit_for_ndjson_record(jg); // Discard the previous record (if any)
+    struct jg_ndjson_pool pool = {
+        .jg = jg,
+        .cb = cb,
+        .cb_arg = cb_arg,
+        .is_ordered = opt && opt->is_ordered,
+        .cur = jg->ndjson.cur,
+        .line_i = jg->ndjson.line_i
+    };
+    pool.batch_line_c = pool.is_ordered ?
+        JG_NDJSON_ORDERED_BATCH_LINE_C : JG_NDJSON_BATCH_LINE_C;
+    size_t rec_c = pool.is_ordered ? pool.batch_line_c : 1;
+    size_t worker_c = get_thread_c(opt ? opt->thread_c : 0);
+    struct jg_ndjson_worker * workers =
+        calloc(worker_c, sizeof(struct jg_ndjson_worker));
+    if (!workers) {
+        return jg->ret = JG_E_CALLOC;
+    }
+    if (init_workers(jg, &pool, workers, worker_c, rec_c)) {
+        free_workers(workers, worker_c, rec_c);
+        return jg->ret;
+    }
+    if (init_lock(jg, &pool.lock)) {
+        free_workers(workers, worker_c, rec_c);
+        return jg->ret;
+    }
+    // The calling thread is the first worker.
+    run_threads(worker_c, run_worker, workers, sizeof(struct jg_ndjson_worker));
+    free_lock(&pool.lock);
+    free_workers(workers, worker_c, rec_c);
+    // Records claimed but left unparsed due to a stop are skipped all the same.
+    jg->ndjson.cur = pool.cur;
+    jg->ndjson.line_i = pool.line_i;
+    return jg->ret = JG_OK;
+}
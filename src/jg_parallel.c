@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+// Parallel parsing only pays off for JSON text of at least this size. The
+// elements of the root array are then split up into chunks of about the
+// latter size, which threads claim one at a time until none are left.
+#define JG_PARALLEL_MIN_BYTE_C 0x100000 // 1 MiB
+#define JG_PARALLEL_CHUNK_BYTE_C 0x10000 // 64 KiB
+
+// A run of consecutive elements of the root array
+struct jg_chunk {
+    char const * json; // The 1st element (or whitespace or comments before it)
+    char const * json_over; // The ',' or ']' following its last element
+    size_t worker_i; // The worker that parsed it
+    // Its elements on the worker's jg->stack (or entries on its jg->tape)
+    size_t val_i;
+    size_t val_over;
+    size_t elem_c;
+};
+
+struct jg_parallel_pool {
+    jg_t * jg; // The jg_t given to the jg_parse_...() function
+    char const * open; // The root array's opening '['
+    struct jg_chunk * chunks;
+    size_t chunk_c;
+    struct jg_lock lock; // Protects the members below
+    size_t chunk_i; // The next chunk to be claimed
+    bool has_failed; // Set once any chunk fails to parse
+};
+
+struct jg_parallel_worker {
+    struct jg_parallel_pool * pool;
+    jg_t * jg;
+    size_t i;
+};
+
+static bool add_chunk(
+    struct jg_parallel_pool * pool,
+    size_t * chunk_size,
+    char const * json,
+    char const * json_over
+) {
+    if (pool->chunk_c == *chunk_size) {
+        *chunk_size = *chunk_size ? 2 * *chunk_size : 64;
+        struct jg_chunk * chunks =
+            realloc(pool->chunks, *chunk_size * sizeof(struct jg_chunk));
+        if (!chunks) {
+            return false;
+        }
+        pool->chunks = chunks;
+    }
+    pool->chunks[pool->chunk_c++] = (struct jg_chunk) {
+        .json = json,
+        .json_over = json_over
+    };
+    return true;
+}
+
+// Split the elements of the root array into chunks, each of which ends at the
+// first ',' between two elements after its first JG_PARALLEL_CHUNK_BYTE_C
+// bytes. This quick scan only keeps track of strings, comments, and nesting
+// depth: the elements themselves are validated once each chunk is parsed. Any
+// JSON text that this scan does not make sense of (e.g., if it isn't a root
+// array at all) is left to the regular parse, by returning false.
+static bool index_chunks(
+    struct jg_parallel_pool * pool
+) {
+    jg_t * jg = pool->jg;
+    char const * c = jg->json_text;
+    skip_any_whitespace_or_comments(&c, jg->json_over);
+    if (c == jg->json_over || *c != '[') {
+        return false;
+    }
+    pool->open = c++;
+    char const * chunk_json = c;
+    size_t chunk_size = 0;
+    size_t depth = 0;
+    while (c < jg->json_over) {
+        switch (*c) {
+        case '"':
+            c = skip_string(c, jg->json_over);
+            continue;
+        case '/': case '#':
+            {
+                // The same function as the parser's, so that the two are sure
+                // to agree on where each comment ends
+                char const * comment = c;
+                skip_any_whitespace_or_comments(&c, jg->json_over);
+                c += c == comment; // A lone '/' is for the parser to report.
+            }
+            continue;
+        case '[': case '{':
+            depth++;
+            break;
+        case ']': case '}':
+            if (depth) {
+                depth--;
+                break;
+            }
+            if (*c != ']' || !add_chunk(pool, &chunk_size, chunk_json, c)) {
+                return false;
+            }
+            // The root array must be followed by nothing but whitespace or
+            // comments, and be large enough to have been split at least once.
+            c++;
+            skip_any_whitespace_or_comments(&c, jg->json_over);
+            return c == jg->json_over && pool->chunk_c > 1;
+        case ',':
+            if (!depth && c - chunk_json >= JG_PARALLEL_CHUNK_BYTE_C) {
+                if (!add_chunk(pool, &chunk_size, chunk_json, c)) {
+                    return false;
+                }
+                chunk_json = c + 1;
+            }
+            break;
+        default:
+            break;
+        }
+        c++;
+    }
+    return false; // Unterminated
+}
+
+static void * run_worker(
+    void * arg
+) {
+    struct jg_parallel_worker * worker = arg;
+    struct jg_parallel_pool * pool = worker->pool;
+    jg_t * jg = worker->jg;
+    for (;;) {
+        acquire_lock(&pool->lock);
+        struct jg_chunk * chunk = NULL;
+        if (!pool->has_failed && pool->chunk_i < pool->chunk_c) {
+            chunk = pool->chunks + pool->chunk_i++;
+        }
+        release_lock(&pool->lock);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->worker_i = worker->i;
+        chunk->val_i = jg->opt_parse.tape ? jg->tape_c : jg->stack_c;
+        if (parse_elements(jg, chunk->json, chunk->json_over, &chunk->elem_c)) {
+            acquire_lock(&pool->lock);
+            pool->has_failed = true;
+            release_lock(&pool->lock);
+            return NULL;
+        }
+        chunk->val_over = jg->opt_parse.tape ? jg->tape_c : jg->stack_c;
+    }
+}
+
+// Each worker's jg_t parses the JSON text in place, with the same options and
+// hash seed, except that its nesting depth starts within the root array.
+static bool init_workers(
+    struct jg_parallel_pool * pool,
+    struct jg_parallel_worker * workers,
+    size_t worker_c
+) {
+    for (size_t i = 0; i < worker_c; i++) {
+        jg_t * jg = workers[i].jg = jg_init();
+        if (!jg) {
+            return false;
+        }
+        workers[i].pool = pool;
+        workers[i].i = i;
+        jg->opt_parse = pool->jg->opt_parse;
+        jg->opt_parse.thread_c = 0;
+        if (jg->opt_parse.max_depth) {
+            jg->opt_parse.max_depth--;
+        }
+        jg->hash_seed = pool->jg->hash_seed;
+        jg->decodes_nums = pool->jg->decodes_nums;
+        jg->unescapes_strs = pool->jg->unescapes_strs;
+        jg->json_callertext = pool->jg->json_callertext;
+        jg->json_is_callertext = true;
+    }
+    return true;
+}
+
+static void free_workers(
+    struct jg_parallel_worker * workers,
+    size_t worker_c
+) {
+    for (size_t i = 0; i < worker_c; i++) {
+        if (workers[i].jg) {
+            jg_free(workers[i].jg);
+        }
+    }
+    free(workers);
+}
+
+// Hand the workers' arenas, object indexes, and strings yet to be unescaped
+// (which live in those arenas) over to jg, and make jg's root the array of all
+// chunks' elements (in the exact same form as parse_more() would produce).
+static jg_ret merge_workers(
+    struct jg_parallel_pool * pool,
+    struct jg_parallel_worker * workers,
+    size_t worker_c
+) {
+    jg_t * jg = pool->jg;
+    struct jg_arena_chunk * * arena_tail = &jg->arena_head;
+    while (*arena_tail) {
+        arena_tail = &(*arena_tail)->next;
+    }
+    for (size_t i = 0; i < worker_c; i++) {
+        jg_t * w = workers[i].jg;
+        *arena_tail = w->arena_head;
+        while (*arena_tail) {
+            arena_tail = &(*arena_tail)->next;
+        }
+        w->arena_head = w->arena_cur = NULL;
+        if (w->unescs) {
+            struct jg_unesc * unesc = w->unescs;
+            while (unesc->next) {
+                unesc = unesc->next;
+            }
+            unesc->next = jg->unescs;
+            jg->unescs = w->unescs;
+        }
+        for (size_t j = 0; j < w->obj_index_slot_c; j++) {
+            if (w->obj_indexes[j].obj_json) {
+                JG_GUARD(set_obj_index(jg, w->obj_indexes[j].obj_json,
+                    w->obj_indexes[j].index));
+            }
+        }
+    }
+    if (!jg->arena_cur) { // Otherwise arena_alloc() would skip them.
+        jg->arena_cur = jg->arena_head;
+    }
+    size_t elem_c = 0;
+    for (size_t i = 0; i < pool->chunk_c; i++) {
+        elem_c += pool->chunks[i].elem_c;
+    }
+    if (jg->opt_parse.tape) {
+        size_t tape_i = 0;
+        JG_GUARD(tape_push_container(jg, &tape_i));
+        for (struct jg_chunk * ch = pool->chunks;
+            ch < pool->chunks + pool->chunk_c; ch++) {
+            JG_GUARD(tape_append(jg, workers[ch->worker_i].jg->tape +
+                ch->val_i, ch->val_over - ch->val_i));
+        }
+        JG_GUARD(tape_set_container(jg, tape_i, JG_TYPE_ARR, pool->open,
+            elem_c));
+        tape_get_val(jg, jg->tape, &jg->root_in);
+        return JG_OK;
+    }
+    struct jg_arr * arr = arena_alloc(jg,
+        sizeof(struct jg_arr) + elem_c * sizeof(struct jg_val_in));
+    if (!arr) {
+        return JG_E_MALLOC;
+    }
+    arr->json = pool->open;
+    arr->elem_c = elem_c;
+    struct jg_val_in * elem = arr->elems;
+    for (struct jg_chunk * ch = pool->chunks;
+        ch < pool->chunks + pool->chunk_c; ch++) {
+        memcpy(elem, workers[ch->worker_i].jg->stack + ch->val_i,
+            ch->elem_c * sizeof(struct jg_val_in));
+        elem += ch->elem_c;
+    }
+    jg->root_in = (struct jg_val_in) {.arr = arr, .type = JG_TYPE_ARR};
+    return JG_OK;
+}
+
+// Split up the elements of a large root array between threads, and merge their
+// DOMs into one. If any chunk fails to parse, *is_parsed is left false, so that
+// parse_root() parses the whole JSON text anew with a single thread: parse
+// errors are rare enough that reporting them exactly as usual (i.e., the first
+// error in the JSON text, with the same context) is worth the extra time.
+jg_ret parse_in_parallel(
+    jg_t * jg,
+    bool * is_parsed
+) {
+    size_t byte_c = jg->json_over - jg->json_text;
+    if (byte_c < JG_PARALLEL_MIN_BYTE_C || jg->opt_parse.max_depth == 1 ||
+        (jg->opt_parse.tape && byte_c > JG_TAPE_OFFSET_MAX)) {
+        return JG_OK;
+    }
+    size_t worker_c = get_thread_c(jg->opt_parse.thread_c);
+    if (worker_c < 2) {
+        return JG_OK;
+    }
+    struct jg_parallel_pool pool = {.jg = jg};
+    if (!index_chunks(&pool)) {
+        free(pool.chunks);
+        return JG_OK;
+    }
+    worker_c = JG_MIN(worker_c, pool.chunk_c);
+    struct jg_parallel_worker * workers =
+        calloc(worker_c, sizeof(struct jg_parallel_worker));
+    if (!workers) {
+        free(pool.chunks);
+        return JG_E_CALLOC;
+    }
+    jg_ret ret = JG_OK;
+    if (!init_workers(&pool, workers, worker_c)) {
+        ret = JG_E_CALLOC;
+    } else if (!(ret = init_lock(jg, &pool.lock))) {
+        run_threads(worker_c, run_worker, workers,
+            sizeof(struct jg_parallel_worker));
+        free_lock(&pool.lock);
+        if (!pool.has_failed) {
+            ret = merge_workers(&pool, workers, worker_c);
+            *is_parsed = ret == JG_OK;
+        }
+    }
+    free_workers(workers, worker_c);
+    free(pool.chunks);
+    if (*is_parsed) {
+        jg->json_cur = jg->json_over;
+        jg->state = JG_STATE_GET;
+    }
+    return ret;
+}
@@ -7,14 +7,22 @@
 
 #include "jgrandson_internal.h"
 
-static void skip_any_whitespace_or_comments(
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap(), posix_madvise()
+#include <sys/stat.h> // fstat()
+#include <unistd.h> // close()
+#endif
+
+void skip_any_whitespace_or_comments(
     char const * * c,
     char const * const c_over
 ) {
     while (*c < c_over) {
         switch (**c) {
         case ' ': case '\n': case '\t': case '\r': // valid whitespace
-            break;
+            *c = skip_whitespace(*c + 1, c_over);
+            continue;
         case '/':
             if (*c + 1 >= c_over) {
                 return;
@@ -33,6 +41,7 @@ static void skip_any_whitespace_or_comments(
                 break;
             }
             if (**c != '/') {
+                (*c)--; // Not a comment after all: point to the '/' instead
                 return;
             }
             // C++ style comment:
@@ -51,197 +60,38 @@ static void skip_any_whitespace_or_comments(
     }
 }
 
-// For cases where it's already known that the JSON string buffer is long enough
-static void reskip_any_whitespace_or_comments(
-    char const * * c
-) {
-    for (;;) {
-        switch (**c) {
-        case ' ': case '\n': case '\t': case '\r': // valid whitespace
-            break;
-        case '/':
-            if (*++(*c) == '*') { // C style comment
-                do {
-                    while (*++(*c) != '*');
-                } while (*++(*c) != '/');
-                break;
-            }
-            if (**c != '/') {
-                return;
-            }
-            // C++ style comment:
-            // fall through
-        case '#': // Python style comment
-            while (*++(*c) != '\n' && **c != '\r');
-            break;
-        default:
-            return;
-        }
-        (*c)++;
-    }
-}
-
-// Try to go to set *c to the char after the string's closing quotation mark,
-// but return an error if c_over was reached before that mark was found.
-static jg_ret skip_string(
-    char const * * c,
-    char const * const c_over
-) {
-    // *c assumed to point to the opening quotation mark.
-    char const * const c_backup = *c;
-    while (++(*c) < c_over) {
-        if (**c == '"') {
-            (*c)++;
-            return JG_OK;
-        }
-        if (**c == '\\') {
-            if (++(*c) >= c_over) {
-                break;
-            }
-        }
-    }
-    *c = c_backup; // Set c to the opening " to provide it as error context.
-    return JG_E_PARSE_UNTERM_STR;
-}
-
-// For strings that have previously gone through skip_string() successfully
-static void reskip_string(
-    char const * * c
-) {
-    // *c assumed to point to the opening quotation mark.
-    while (*++(*c) != '"') {
-        if (**c == '\\') {
-            (*c)++;
-        }
-    }
-    (*c)++;
-}
-
-// Try to go to set *c to the char after the array's closing bracket (']'),
-// but return an error if c_over was reached before that bracket was found.
-static jg_ret skip_array(
-    char const * * c,
+// Return the char following the closing '"' of the string that starts at c
+// (or c_over if it is unterminated) without validating it. A '"' is escaped if
+// (and only if) it is preceded by an odd number of consecutive backslashes.
+char const * skip_string(
+    char const * c,
     char const * const c_over
 ) {
-    // *c assumed to point to the opening bracket ('[').
-    char const * const c_backup = (*c)++;
-    while (*c < c_over) {
-        switch (**c) {
-        case '"':
-            JG_GUARD(skip_string(c, c_over));
-            continue;
-        case '[':
-            JG_GUARD(skip_array(c, c_over));
-            continue;
-        case ']':
-            (*c)++;
-            return JG_OK;
-        default:
-            (*c)++;
-            skip_any_whitespace_or_comments(c, c_over);
-            continue;
-        }
-    }
-    *c = c_backup; // Set c to the opening [ to provide it as error context.
-    return JG_E_PARSE_UNTERM_ARR;
-}
-
-// For arrays that have previously been successfully skipped
-static void reskip_array(
-    char const * * c
-) {
-    // *c assumed to point to the opening bracket ('[').
-    (*c)++;
-    while (**c != ']') {
-        switch (**c) {
-        case '"':
-            reskip_string(c);
-            continue;
-        case '[':
-            reskip_array(c);
-            continue;
-        default:
-            (*c)++;
-            reskip_any_whitespace_or_comments(c);
-            continue;
+    for (;;) {
+        char const * quote = memchr(c + 1, '"', c_over - c - 1);
+        if (!quote) {
+            return c_over;
         }
-    }
-    (*c)++;
-}
-
-// Try to go to set *c to the char after the object's closing brace ('}'),
-// but return an error if c_over was reached before that brace was found.
-static jg_ret skip_object(
-    char const * * c,
-    char const * const c_over
-) {
-    // *c assumed to point to the opening brace ('{').
-    char const * const c_backup = (*c)++;
-    while (*c < c_over) {
-        switch (**c) {
-        case '"':
-            JG_GUARD(skip_string(c, c_over));
-            continue;
-        case '{':
-            JG_GUARD(skip_object(c, c_over));
-            continue;
-        case '}':
-            (*c)++;
-            return JG_OK;
-        default:
-            (*c)++;
-            skip_any_whitespace_or_comments(c, c_over);
-            continue;
+        char const * backslash = quote;
+        while (backslash[-1] == '\\') { // Can't go past the opening '"'
+            backslash--;
         }
-    }
-    *c = c_backup; // Set c to the opening { to provide it as error context.
-    return JG_E_PARSE_UNTERM_OBJ;
-}
-
-// For objects that have previously been successfully skipped
-static void reskip_object(
-    char const * * c
-) {
-    // *c assumed to point to the opening brace ('{').
-    (*c)++;
-    while (**c != '}') {
-        switch (**c) {
-        case '"':
-            reskip_string(c);
-            continue;
-        case '{':
-            reskip_object(c);
-            continue;
-        default:
-            (*c)++;
-            reskip_any_whitespace_or_comments(c);
-            continue;
+        if (!((quote - backslash) & 1)) {
+            return quote + 1;
         }
+        c = quote;
     }
-    (*c)++;
 }
 
-// For elements that have previously been successfully skipped
-static void reskip_element(
-    char const * * c
+// Whether the JSON text (fed so far) ends at c. Whitespace skipping stops at a
+// final '/', but while more JSON text can still be fed, that '/' may yet turn
+// out to be the start of a comment.
+static bool is_json_over(
+    jg_t const * jg,
+    char const * c
 ) {
-    reskip_any_whitespace_or_comments(c);
-    switch (**c) {
-    case '"':
-        reskip_string(c);
-        return;
-    case '[':
-        reskip_array(c);
-        return;
-    case '{':
-        reskip_object(c);
-        return;
-    default:
-        while (**c != ',' && **c != ']' && **c != '}') {
-            (*c)++; // reskip number/true/false/null
-            reskip_any_whitespace_or_comments(c);
-        }
-    }
+    return c == jg->json_over ||
+        (jg->json_is_partial && c + 1 == jg->json_over && *c == '/');
 }
 
 static jg_ret parse_null(
@@ -307,7 +157,10 @@ static jg_ret parse_number(
         return JG_E_PARSE_NUM_LEAD_ZERO;
     }
     bool has_decimal_point = false;
-    do {
+    // (Not a do-while loop: a number may end at c_over right after a leading 0,
+    // in which case no byte remains to be read, because the JSON text of
+    // jg_parse_callerstr() or jg_parse_file_mmap() has no trailing newline.)
+    for (; *c != c_over; (*c)++) {
         switch (**c) {
         case '\n': case '\t': case '\r': case ' ': case ',': case ']': case '}':
             goto number_parsed;
@@ -342,7 +195,7 @@ static jg_ret parse_number(
         default:
             return JG_E_PARSE_NUM_INVALID;
         }
-    } while (++(*c) != c_over);
+    }
     number_parsed:
     v->type = JG_TYPE_NUM;
     size_t byte_c = *c - v->json;
@@ -353,88 +206,112 @@ static jg_ret parse_number(
     return JG_OK;
 }
 
-static jg_ret parse_utf8(
-    uint8_t const * * u
+// Decode the JSON number v just parsed by parse_number() into a jg_num, which v
+// then points to instead of to its JSON text.
+static jg_ret decode_number(
+    jg_t * jg,
+    struct jg_val_in * v
 ) {
-    uint8_t const * const u_backup = *u;
-    if (**u >= 0xC2 && **u <= 0xDF) { // 2-byte UTF-8 char
-        if (*++(*u) >= 0x80 || **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u == 0xE0) { // 3-byte UTF-8 char type 1 of 4
-        if (*++(*u) >= 0xA0 && **u <= 0xBF && *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u >= 0xE1 && **u <= 0xEC) { // 3-byte UTF-8 char type 2 of 4
-        if (*++(*u) >= 0x80 && **u <= 0xBF && *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u == 0xED) { // 3-byte UTF-8 char type 3 of 4
-        if (*++(*u) >= 0x80 && **u <= 0x9F && *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u == 0xEE || **u == 0xEF) { // 3-byte UTF-8 char type 4 of 4
-        if (*++(*u) >= 0x80 && **u <= 0xBF && *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u == 0xF0) { // 4-byte UTF-8 char type 1 of 3
-        if (*++(*u) >= 0x90 && **u <= 0xBF && *++(*u) >= 0x80 && **u <= 0xBF &&
-            *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u >= 0xF1 && **u <= 0xF3) { // 4-byte UTF-8 char type 2 of 3
-        if (*++(*u) >= 0x80 && **u <= 0xBF && *++(*u) >= 0x80 && **u <= 0xBF &&
-            *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
-    } else if (**u == 0xF4) { // 4-byte UTF-8 char type 3 of 3
-        if (*++(*u) >= 0x80 && **u <= 0x8F && *++(*u) >= 0x80 && **u <= 0xBF &&
-            *++(*u) >= 0x80 && **u <= 0xBF) {
-            return JG_OK;
-        }
+    struct jg_num * num = arena_alloc(jg, sizeof(struct jg_num));
+    if (!num) {
+        return JG_E_MALLOC;
     }
-    *u = u_backup; // Point to 1st byte as expected when printing error context
-    return JG_E_PARSE_STR_UTF8_INVALID;
+    char const * c = v->json;
+    char const * const c_over = c + v->byte_c;
+    *num = (struct jg_num) {.json = c, .is_neg = *c == '-'};
+    num->is_integer = skip_digits(c + num->is_neg, c_over, &num->mag) == c_over;
+    struct jg_decimal dec = {0};
+    scan_decimal(v->json, v->byte_c, &dec);
+    num->has_dbl = decimal_to_double(&dec, &num->dbl);
+    v->num = num;
+    return JG_OK;
+}
+
+static bool is_hex_digit(
+    char c
+) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') ||
+        (c >= 'a' && c <= 'f');
+}
+
+// Whether no closing quotation mark can follow c, given that the JSON text is
+// complete. The final byte of such a text may be the '\n' appended by
+// jg_parse_str(), jg_parse_file() and jg_parse_end(), so any string error found
+// there must be reported as JG_E_PARSE_UNTERM_STR instead, to keep the error
+// independent of the jg_parse_...() function called. (Only on the error path.)
+static bool is_unterminated(
+    jg_t const * jg,
+    char const * c
+) {
+    return !jg->json_is_partial && !memchr(c, '"', jg->json_over - c);
 }
 
 static jg_ret parse_string(
+    jg_t * jg,
     char const * * c,
     struct jg_val_in * v
 ) {
+    char const * const c_over = jg->json_over;
     // *c assumed to point to the opening quotation mark.
-    v->json = ++(*c);
-    for (;; (*c)++) {
+    char const * const open_quote = *c;
+    v->json = open_quote + 1;
+    // If the JSON text fed so far ended within this string, resume scanning
+    // where that left off rather than from the start of the string.
+    *c = open_quote == jg->feed_str_open ? jg->feed_str_resume : v->json;
+    char const * resume = *c; // Everything before this was scanned already
+    jg_ret ret = JG_OK;
+    for (; *c < c_over; (*c)++) {
+        // Non-ASCII bytes can only be skipped in bulk if they were validated.
+        if (*c < jg->utf8_valid_over) {
+            *c = skip_str_chars(*c, jg->utf8_valid_over, true);
+        }
+        *c = skip_str_chars(*c, c_over, false);
+        resume = *c;
+        if (*c == c_over) {
+            break;
+        }
         if ((signed char) **c < 0) {
-            JG_GUARD(parse_utf8((uint8_t const * *) c));
+            // Rather than validating UTF-8 char by char, validate everything
+            // from here up to the first invalid char (if any) in one go.
+            jg->utf8_valid_over = skip_valid_utf8(*c, c_over);
+            if (*c == jg->utf8_valid_over) {
+                if (jg->json_is_partial && c_over - *c < 4) {
+                    goto unterminated; // The rest of the char may follow.
+                }
+                return JG_E_PARSE_STR_UTF8_INVALID;
+            }
             continue;
         }
         if (**c < ' ') {
+            if (is_unterminated(jg, *c)) {
+                goto unterminated;
+            }
             return JG_E_PARSE_STR_UNESC_CONTROL;
         }
         switch (**c) {
         case '"':
-            v->type = JG_TYPE_STR;
-            v->byte_c = *c - v->json;
-            if (v->byte_c > UINT32_MAX) {
+            if ((size_t) (*c - v->json) > UINT32_MAX) {
                 return JG_E_PARSE_STR_TOO_LARGE; // 4 billion chars is too much
             }
+            v->type = JG_TYPE_STR;
+            v->byte_c = *c - v->json;
             (*c)++;
             return JG_OK;
         case '\\':
-            switch (*++(*c)) {
+            if (++(*c) == c_over) {
+                goto unterminated;
+            }
+            switch (**c) {
             case 'b': case 't': case 'n': case 'f': case 'r': case '"':
             case '/': case '\\':
                 continue;
             case 'u': // 4 UTF-16 code point encoding hex chars (e.g., "\uE90F")
-                if (*++(*c) < '0' || **c > 'f' ||
-                    (**c > '9' && **c < 'A') || (**c > 'F' && **c < 'a') ||
-                    *++(*c) < '0' || **c > 'f' ||
-                    (**c > '9' && **c < 'A') || (**c > 'F' && **c < 'a') ||
-                    *++(*c) < '0' || **c > 'f' ||
-                    (**c > '9' && **c < 'A') || (**c > 'F' && **c < 'a') ||
-                    *++(*c) < '0' || **c > 'f' ||
-                    (**c > '9' && **c < 'A') || (**c > 'F' && **c < 'a')) {
-                    return JG_E_PARSE_STR_UTF16_INVALID;
+                if (++(*c) == c_over || !is_hex_digit(**c) ||
+                    ++(*c) == c_over || !is_hex_digit(**c) ||
+                    ++(*c) == c_over || !is_hex_digit(**c) ||
+                    ++(*c) == c_over || !is_hex_digit(**c)) {
+                    ret = JG_E_PARSE_STR_UTF16_INVALID;
+                    break;
                 }
                 // Check surrogate pair range: \uD800 through \uDFFF
                 if (((*c)[-3] == 'D' || (*c)[-3] == 'd') && (*c)[-2] > '7') {
@@ -443,286 +320,793 @@ static jg_ret parse_string(
                         return JG_E_PARSE_STR_UTF16_UNPAIRED_LOW;
                     }
                     // Verify that the high surrogate is followed by a low one.
-                    if (*++(*c) != '\\' ||
-                        *++(*c) != 'u' ||
-                        (*++(*c) != 'D' && **c != 'd') ||
-                        *++(*c) < 'C' ||
-                            **c > 'f' ||
+                    if (++(*c) == c_over || **c != '\\' ||
+                        ++(*c) == c_over || **c != 'u' ||
+                        ++(*c) == c_over || (**c != 'D' && **c != 'd') ||
+                        ++(*c) == c_over || **c < 'C' || **c > 'f' ||
                             (**c > 'F' && **c < 'c') ||
-                        *++(*c) < '0' ||
-                            **c > 'f' ||
-                            (**c > '9' && **c < 'A') ||
-                            (**c > 'F' && **c < 'a') ||
-                        *++(*c) < '0' ||
-                            **c > 'f' ||
-                            (**c > '9' && **c < 'A') ||
-                            (**c > 'F' && **c < 'a')) {
-                        return JG_E_PARSE_STR_UTF16_UNPAIRED_HIGH;
+                        ++(*c) == c_over || !is_hex_digit(**c) ||
+                        ++(*c) == c_over || !is_hex_digit(**c)) {
+                        ret = JG_E_PARSE_STR_UTF16_UNPAIRED_HIGH;
+                        break;
                     }
                 }
                 // If none of the above 3 errors were returned, the escape
                 // sequence encodes a valid unicode code point.
                 continue;
             default:
+                if (is_unterminated(jg, *c)) {
+                    goto unterminated;
+                }
                 return JG_E_PARSE_STR_ESC_INVALID;
             }
+            if (*c < c_over && !is_unterminated(jg, *c)) {
+                return ret;
+            }
+            goto unterminated;
         default:
             continue;
         }
     }
+    unterminated:
+    if (jg->json_is_partial) {
+        jg->feed_str_open = open_quote;
+        jg->feed_str_resume = resume;
+    }
+    *c = open_quote; // Set c to the opening " to provide it as error context.
+    return JG_E_PARSE_UNTERM_STR;
 }
 
-// parse_element() prototype needed here due to mutual recursion
-static jg_ret parse_element(
-    char const * * c,
-    struct jg_val_in * v
-);
-
-static jg_ret parse_array(
-    char const * * c,
-    struct jg_val_in * v
+// Push a parsed value onto jg->stack, where it remains until the array or
+// object to which it belongs is packed by close_container().
+static jg_ret push_value(
+    jg_t * jg,
+    struct jg_val_in const * v
 ) {
-    char const * const open_bracket = (*c)++; // '['
-    reskip_any_whitespace_or_comments(c);
-    if (**c == ']') {
-        (*c)++;
-        v->type = JG_TYPE_ARR;
-        struct jg_arr * arr = malloc(sizeof(struct jg_arr));
-        if (!arr) {
-            return JG_E_MALLOC;
+    if (jg->stack_c == jg->stack_size) {
+        size_t stack_size = jg->stack_size ? 2 * jg->stack_size : 64;
+        struct jg_val_in * stack =
+            realloc(jg->stack, stack_size * sizeof(struct jg_val_in));
+        if (!stack) {
+            return JG_E_REALLOC;
         }
-        arr->json = open_bracket; 
-        arr->elem_c = 0;
-        v->arr = arr;
+        jg->stack = stack;
+        jg->stack_size = stack_size;
+    }
+    jg->stack[jg->stack_c++] = *v;
+    return JG_OK;
+}
+
+// Add a parsed array element or object key/value to the DOM: push it onto
+// jg->stack, or append it to jg->tape if .opt_parse.tape is set (in which case
+// arrays and objects have already appended themselves while being parsed). In
+// lazy mode, nothing is added until parse_lazy_container() is called.
+static jg_ret add_value(
+    jg_t * jg,
+    struct jg_val_in const * v
+) {
+    if (jg->is_lazy) {
         return JG_OK;
     }
-    size_t elem_c = 0;
-    for (;;) {
-        reskip_element(c);
-        elem_c++;
-        reskip_any_whitespace_or_comments(c);
-        switch (**c) {
-        case ']':
-            break;
-        case ',':
-            (*c)++;
-            continue;
-        default:
-            return JG_E_PARSE_ARR_INVALID_SEP;
-        }
-        break;
+    if (!jg->opt_parse.tape) {
+        return push_value(jg, v);
     }
-    v->type = JG_TYPE_ARR;
-    struct jg_arr * arr = calloc(1,
-        sizeof(struct jg_arr) + elem_c * sizeof(struct jg_val_in));
-    if (!arr) {
-        return JG_E_CALLOC;
-    }
-    arr->json = open_bracket;
-    arr->elem_c = elem_c;
-    v->arr = arr;
-    *c = open_bracket + 1;
-    for (struct jg_val_in * elem = arr->elems;
-        elem < arr->elems + arr->elem_c; elem++) {
-        JG_GUARD(parse_element(c, elem));
-        reskip_any_whitespace_or_comments(c);
-        // Check needed here because the reskip_element() call above is actually
-        // a little too greedy when the element type is number/true/false/null.
-        if (**c != ',' && **c != ']') {
-            return JG_E_PARSE_ARR_INVALID_SEP;
-        }
-        (*c)++; // skip the ',' or ']'
+    if (v->type == JG_TYPE_ARR || v->type == JG_TYPE_OBJ) {
+        return JG_OK;
     }
-    return JG_OK;
+    return tape_push_value(jg, v);
 }
 
-static jg_ret check_key_is_unique(
-    struct jg_pair const * pairs,
-    struct jg_pair const * pair,
-    char const * key,
-    uint32_t byte_c
+static jg_ret unterminated( // Error for the innermost open array or object
+    jg_t * jg,
+    char const * * c
 ) {
-    // Technically, the JSON spec inexplicably allows duplicate keys; but
-    // Jgrandson does not, primarily because pairs with duplicate keys would be
-    // inaccessible with Jgrandson's getter API.
-    for (struct jg_pair const * p = pairs; p < pair; p++) {
-        bool strings_are_equal = false;
-        JG_GUARD(json_strings_are_equal((uint8_t const *) p->key.json,
-            p->key.byte_c, (uint8_t const *) key, byte_c, &strings_are_equal));
-        if (strings_are_equal) {
-            return JG_E_PARSE_OBJ_DUPLICATE_KEY;
-        }
+    struct jg_frame const * frame = jg->frames + jg->frame_c - 1;
+    *c = frame->open; // Set c to the opening [ or { to provide error context.
+    return frame->type == JG_TYPE_ARR ?
+        JG_E_PARSE_UNTERM_ARR : JG_E_PARSE_UNTERM_OBJ;
+}
+
+// Push a frame for the array or object opened at *c, and skip the [ or {.
+static jg_ret open_container(
+    jg_t * jg,
+    char const * * c
+) {
+    if (jg->opt_parse.max_depth && jg->frame_c >= jg->opt_parse.max_depth) {
+        return JG_E_PARSE_MAX_DEPTH;
+    }
+    struct jg_frame * frame = NULL;
+    JG_GUARD(push_frame(jg, &frame));
+    frame->type = **c == '[' ? JG_TYPE_ARR : JG_TYPE_OBJ;
+    frame->open = (*c)++;
+    frame->stack_i = jg->stack_c;
+    frame->c = 0;
+    frame->index = NULL;
+    if (jg->opt_parse.tape) {
+        JG_GUARD(tape_push_container(jg, &frame->tape_i));
     }
     return JG_OK;
 }
 
-static jg_ret parse_object(
-    char const * * c,
+// Pack the c elements (or pairs) of an array (or object) that were pushed onto
+// jg->stack from stack_i onward into an exactly sized jg_arr (or jg_obj).
+static jg_ret pack_container(
+    jg_t * jg,
+    enum jg_type type,
+    char const * open,
+    size_t stack_i,
+    size_t c,
     struct jg_val_in * v
 ) {
-    char const * const open_brace = (*c)++; // '{'
-    reskip_any_whitespace_or_comments(c);
-    if (**c == '}') {
-        (*c)++;
-        v->type = JG_TYPE_OBJ;
-        struct jg_obj * obj = malloc(sizeof(struct jg_obj));
-        if (!obj) {
+    v->type = type;
+    if (type == JG_TYPE_ARR) {
+        struct jg_arr * arr = arena_alloc(jg,
+            sizeof(struct jg_arr) + c * sizeof(struct jg_val_in));
+        if (!arr) {
             return JG_E_MALLOC;
         }
-        obj->json = open_brace;
-        obj->pair_c = 0;
-        v->obj = obj;
-        return JG_OK;
-    }
-    size_t pair_c = 0;
-    for (;;) {
-        if (**c != '"') {
-            return JG_E_PARSE_OBJ_INVALID_KEY;
+        arr->json = open;
+        arr->elem_c = c;
+        if (c) { // jg->stack may still be NULL otherwise
+            memcpy(arr->elems, jg->stack + stack_i,
+                c * sizeof(struct jg_val_in));
         }
-        reskip_string(c);
-        reskip_any_whitespace_or_comments(c);
-        if (**c != ':') {
-            return JG_E_PARSE_OBJ_KEYVAL_INVALID_SEP;
+        v->arr = arr;
+    } else {
+        // Keys and values were pushed onto jg->stack in alternating order, such
+        // that they can be packed directly as jg_pair structs.
+        struct jg_obj * obj = arena_alloc(jg,
+            sizeof(struct jg_obj) + c * sizeof(struct jg_pair));
+        if (!obj) {
+            return JG_E_MALLOC;
         }
-        (*c)++;
-        reskip_element(c);
-        pair_c++;
-        reskip_any_whitespace_or_comments(c);
-        switch (**c) {
-        case '}':
-            break;
-        case ',':
-            (*c)++;
-            reskip_any_whitespace_or_comments(c);
-            continue;
-        default:
-            return JG_E_PARSE_OBJ_INVALID_SEP;
+        obj->json = open;
+        obj->pair_c = c;
+        if (c) { // jg->stack may still be NULL otherwise
+            memcpy(obj->pairs, jg->stack + stack_i, c * sizeof(struct jg_pair));
         }
-        break;
-    }
-    v->type = JG_TYPE_OBJ;
-    struct jg_obj * obj = calloc(1,
-        sizeof(struct jg_obj) + pair_c * sizeof(struct jg_pair));
-    if (!obj) {
-        return JG_E_CALLOC;
-    }
-    obj->json = open_brace;
-    obj->pair_c = pair_c;
-    v->obj = obj;
-    *c = open_brace + 1;
-    for (struct jg_pair * p = obj->pairs; p < obj->pairs + obj->pair_c; p++) {
-        reskip_any_whitespace_or_comments(c);
-        JG_GUARD(parse_string(c, &p->key));
-        JG_GUARD(check_key_is_unique(obj->pairs, p, p->key.json,
-            p->key.byte_c));
-        reskip_any_whitespace_or_comments(c);
-        (*c)++; // skip the ':' already known to be here
-        JG_GUARD(parse_element(c, &p->val));
-        reskip_any_whitespace_or_comments(c);
-        // Check needed here because the reskip_element() call above is actually
-        // a little too greedy when the element type is number/true/false/null.
-        if (**c != ',' && **c != '}') {
-            return JG_E_PARSE_OBJ_INVALID_SEP;
-        }
-        (*c)++; // skip the ',' or '}'
+        v->obj = obj;
     }
+    jg->stack_c = stack_i;
     return JG_OK;
 }
 
-// Any value parsed by parse_element() has already been skipped over before, so
-// all parse_...() calls below can be called safely without c_over checks.
-static jg_ret parse_element(
-    char const * * c,
-    struct jg_val_in * v
+// In lazy mode, record where a large array or object ends (see struct
+// jg_lazy_skip). Smaller ones are quicker to skip by scanning them anew.
+static jg_ret add_lazy_skip(
+    jg_t * jg,
+    char const * open,
+    char const * over
 ) {
-    reskip_any_whitespace_or_comments(c);
-    switch (**c) {
-    case '"':
-        return parse_string(c, v);
-    case '-': case '0': case '1': case '2': case '3': case '4':
-    case '5': case '6': case '7': case '8': case '9':
-        return parse_number(c, NULL, v);
-    case '[':
-        return parse_array(c, v);
-    case 'f':
-        return parse_false(c, NULL, v);
-    case 'n':
-        return parse_null(c, NULL, v);
-    case 't':
-        return parse_true(c, NULL, v);
-    case '{':
-        return parse_object(c, v);
-    default:
-        return JG_E_PARSE_INVALID_TYPE;
+    if (over - open < JG_LAZY_SKIP_MIN_BYTE_C) {
+        return JG_OK;
+    }
+    if (jg->lazy_skip_c == jg->lazy_skip_size) {
+        size_t size = jg->lazy_skip_size ? 2 * jg->lazy_skip_size : 64;
+        struct jg_lazy_skip * skips =
+            realloc(jg->lazy_skips, size * sizeof(struct jg_lazy_skip));
+        if (!skips) {
+            return JG_E_REALLOC;
+        }
+        jg->lazy_skips = skips;
+        jg->lazy_skip_size = size;
     }
+    jg->lazy_skips[jg->lazy_skip_c++] = (struct jg_lazy_skip) {
+        .open = open,
+        .over = over
+    };
+    return JG_OK;
 }
 
-// According to https://tools.ietf.org/html/rfc8259 (the current JSON spec at
-// the time of writing), any type of JSON value (i.e., string, number, array,
-// object, true, false, or null) is also valid at the root level.
-static jg_ret parse_root(
-    jg_t * jg
+// Pack the values of the innermost open array or object into an exactly sized
+// jg_arr or jg_obj (or finalize its tape entries in tape mode), and pop it. In
+// lazy mode, v is left pointing to the JSON text of the array or object.
+static jg_ret close_container(
+    jg_t * jg,
+    struct jg_val_in * v
 ) {
-    jg->json_cur = jg->json_text;
-    skip_any_whitespace_or_comments(&jg->json_cur, jg->json_over);
-    char const * const json_root = jg->json_cur;
-    switch (*jg->json_cur) {
-    case '"':
-        // Make sure the JSON text root contains a complete string...
-        JG_GUARD(skip_string(&jg->json_cur, jg->json_over));
-        jg->json_cur = json_root;
-        // ...because parse_string() doesn't check jg->json_over.
-        JG_GUARD(parse_string(&jg->json_cur, &jg->root_in));
-        break;
-    case '-': case '0': case '1': case '2': case '3': case '4': case '5':
-    case '6': case '7': case '8': case '9':
-        JG_GUARD(parse_number(&jg->json_cur, jg->json_over, &jg->root_in));
-        break;
-    case '[':
-        // make sure the JSON text root contains a complete array...
-        JG_GUARD(skip_array(&jg->json_cur, jg->json_over));
-        jg->json_cur = json_root;
-        // ...because parse_array() doesn't check jg->json_over.
-        JG_GUARD(parse_array(&jg->json_cur, &jg->root_in));
-        break;
-    case 'f':
-        JG_GUARD(parse_false(&jg->json_cur, jg->json_over, &jg->root_in));
-        break;
-    case 'n':
-        JG_GUARD(parse_null(&jg->json_cur, jg->json_over, &jg->root_in));
-        break;
-    case 't':
-        JG_GUARD(parse_true(&jg->json_cur, jg->json_over, &jg->root_in));
-        break;
-    case '{':
-        // make sure the JSON text root contains a complete object...
-        JG_GUARD(skip_object(&jg->json_cur, jg->json_over));
-        jg->json_cur = json_root;
-        // ...because parse_array() doesn't check jg->json_over.
-        JG_GUARD(parse_object(&jg->json_cur, &jg->root_in));
-        break;
-    default:
-        return JG_E_PARSE_INVALID_TYPE;
+    struct jg_frame const * frame = jg->frames + jg->frame_c - 1;
+    v->type = frame->type;
+    if (frame->index) {
+        JG_GUARD(set_obj_index(jg, frame->open, frame->index));
     }
-    skip_any_whitespace_or_comments(&jg->json_cur, jg->json_over);
-    if (jg->json_cur < jg->json_over) {
-        return JG_E_PARSE_ROOT_SURPLUS;
+    if (jg->is_lazy) {
+        v->json = frame->open;
+        v->is_unparsed = true;
+        jg->stack_c = frame->stack_i;
+    } else if (jg->opt_parse.tape) {
+        JG_GUARD(tape_set_container(jg, frame->tape_i, frame->type,
+            frame->open, frame->c));
+        jg->stack_c = frame->stack_i; // Pop any keys pushed by parse_key()
+    } else {
+        JG_GUARD(pack_container(jg, frame->type, frame->open, frame->stack_i,
+            frame->c, v));
     }
-    jg->state = JG_STATE_GET;
+    jg->frame_c--;
     return JG_OK;
 }
 
-// Copy the JSON text string to a malloc-ed char buffer, then parse.
-jg_ret jg_parse_str(
+// The key of the pair at position pos (see struct jg_index) of an open object
+static void get_open_obj_key(
     jg_t * jg,
-    char const * json_text, // null-terminator not required
-    size_t byte_c // excluding null-terminator
+    struct jg_frame const * frame,
+    uint32_t pos,
+    struct jg_val_in * key
 ) {
-    if (jg->state != JG_STATE_INIT) {
-        return jg->ret = JG_E_STATE_NOT_PARSE;
+    if (jg->opt_parse.tape) {
+        tape_get_val(jg, jg->tape + frame->tape_i + pos, key);
+    } else if (jg->is_lazy) {
+        *key = jg->stack[frame->stack_i + pos];
+    } else {
+        *key = jg->stack[frame->stack_i + 2 * pos];
+    }
+}
+
+// Index the keys parsed so far of an object that has become large enough to
+// warrant it. Once the object is complete, close_container() hands the index
+// over to jg->obj_indexes, so that getters can use it for key lookups too.
+static jg_ret index_open_obj(
+    jg_t * jg,
+    struct jg_frame * frame
+) {
+    JG_GUARD(alloc_index(jg, frame->c + 1, &frame->index));
+    uint64_t const * entry = NULL; // Tape mode: the key entry of the i-th pair
+    if (jg->opt_parse.tape) {
+        entry = jg->tape + frame->tape_i + 2;
+    }
+    for (size_t i = 0; i < frame->c; i++) {
+        uint32_t pos = i;
+        if (entry) {
+            pos = entry - (jg->tape + frame->tape_i);
+            entry = tape_get_next(entry + 1); // Skip the key and its value
+        }
+        struct jg_val_in key = {0};
+        get_open_obj_key(jg, frame, pos, &key);
+        uint32_t hash = 0;
+        JG_GUARD(hash_json_str(jg, (uint8_t const *) key.json, key.byte_c,
+            &hash));
+        index_insert(frame->index, hash, pos);
+    }
+    return JG_OK;
+}
+
+static jg_ret check_key_is_unique(
+    jg_t * jg,
+    struct jg_frame * frame, // The innermost open object
+    struct jg_val_in const * key
+) {
+    // Technically, the JSON spec inexplicably allows duplicate keys; but
+    // Jgrandson does not, primarily because pairs with duplicate keys would be
+    // inaccessible with Jgrandson's getter API.
+    if (!frame->c) {
+        return JG_OK;
+    }
+    bool strings_are_equal = false;
+    if (!frame->index) {
+        if (frame->c < JG_INDEX_MIN_KEY_C - 1) {
+            // Few keys: comparing against each of them is cheaper than hashing.
+            // In tape or lazy mode, keys are on jg->stack on their own (see
+            // parse_key()).
+            size_t key_stride = jg->opt_parse.tape || jg->is_lazy ? 1 : 2;
+            for (struct jg_val_in const * k = jg->stack + frame->stack_i;
+                k < jg->stack + jg->stack_c; k += key_stride) {
+                JG_GUARD(json_strings_are_equal((uint8_t const *) k->json,
+                    k->byte_c, (uint8_t const *) key->json, key->byte_c,
+                    &strings_are_equal));
+                if (strings_are_equal) {
+                    return JG_E_PARSE_OBJ_DUPLICATE_KEY;
+                }
+            }
+            return JG_OK;
+        }
+        JG_GUARD(index_open_obj(jg, frame));
+    }
+    uint32_t hash = 0;
+    JG_GUARD(hash_json_str(jg, (uint8_t const *) key->json, key->byte_c,
+        &hash));
+    size_t slot_i = hash & (frame->index->slot_c - 1);
+    uint32_t pos = 0;
+    while (index_find_next(frame->index, hash, &slot_i, &pos)) {
+        struct jg_val_in k = {0};
+        get_open_obj_key(jg, frame, pos, &k);
+        JG_GUARD(json_strings_are_equal((uint8_t const *) k.json, k.byte_c,
+            (uint8_t const *) key->json, key->byte_c, &strings_are_equal));
+        if (strings_are_equal) {
+            return JG_E_PARSE_OBJ_DUPLICATE_KEY;
+        }
+    }
+    JG_GUARD(reserve_index_key(jg, &frame->index));
+    // The key is about to become the next pair's key, at this position:
+    index_insert(frame->index, hash, jg->opt_parse.tape ?
+        jg->tape_c - frame->tape_i : frame->c);
+    return JG_OK;
+}
+
+// Parse a key of the innermost open object. In tape mode, the keys of objects
+// that do not have an index (yet) are also pushed onto jg->stack (on their own)
+// for the duplicate key check; and in lazy mode, all keys are.
+static jg_ret parse_key(
+    jg_t * jg,
+    char const * * c
+) {
+    if (**c != '"') {
+        return JG_E_PARSE_OBJ_INVALID_KEY;
+    }
+    struct jg_val_in key = {0};
+    JG_GUARD(parse_string(jg, c, &key));
+    struct jg_frame * frame = jg->frames + jg->frame_c - 1;
+    if (!jg->opt_parse.trust_unique_keys) {
+        JG_GUARD(check_key_is_unique(jg, frame, &key));
+    }
+    JG_GUARD(add_value(jg, &key));
+    if (!jg->opt_parse.trust_unique_keys &&
+        (jg->is_lazy || (jg->opt_parse.tape && !frame->index))) {
+        JG_GUARD(push_value(jg, &key));
+    }
+    return JG_OK;
+}
+
+// Parse the ':' following a key, and any whitespace preceding it.
+static jg_ret parse_key_sep(
+    jg_t * jg,
+    char const * * c
+) {
+    skip_any_whitespace_or_comments(c, jg->json_over);
+    if (is_json_over(jg, *c)) {
+        return unterminated(jg, c);
+    }
+    if (**c != ':') {
+        return JG_E_PARSE_OBJ_KEYVAL_INVALID_SEP;
+    }
+    (*c)++;
+    return JG_OK;
+}
+
+static void set_parse_step(
+    jg_t * jg,
+    enum jg_parse_step step,
+    char const * c
+) {
+    jg->parse_step = step;
+    jg->parse_step_c = c;
+}
+
+// Unescape string value v, if it contains any escape sequences. Its .byte_c is
+// set to that of the unescaped string right away, but unescaping the JSON text
+// itself is deferred to unescape_strs() until the JSON text is parsed, except
+// when parse_lazy_container() parses it for a getter.
+static jg_ret unescape_str(
+    jg_t * jg,
+    struct jg_val_in * v
+) {
+    if (!memchr(v->json, '\\', v->byte_c)) {
+        return JG_OK;
+    }
+    size_t json_byte_c = v->byte_c;
+    v->byte_c = get_unesc_byte_c((uint8_t const *) v->json, json_byte_c);
+    // v->json points into jg->text_buf, so casting away its const is fine.
+    if (jg->state == JG_STATE_GET) {
+        json_str_to_unesc_str((uint8_t const *) v->json, json_byte_c,
+            (uint8_t *) v->json);
+        return JG_OK;
+    }
+    struct jg_unesc * unesc = arena_alloc(jg, sizeof(struct jg_unesc));
+    if (!unesc) {
+        return JG_E_MALLOC;
+    }
+    *unesc = (struct jg_unesc) {
+        .next = jg->unescs,
+        .json = (char *) v->json,
+        .byte_c = json_byte_c
+    };
+    jg->unescs = unesc;
+    return JG_OK;
+}
+
+// Unescape the string values deferred by unescape_str(). Each is unescaped
+// into its own JSON text, which is safe because no escape sequence is shorter
+// than the char it represents.
+static void unescape_strs(
+    jg_t * jg
+) {
+    for (struct jg_unesc * u = jg->unescs; u; u = u->next) {
+        json_str_to_unesc_str((uint8_t const *) u->json, u->byte_c,
+            (uint8_t *) u->json);
+    }
+    jg->unescs = NULL;
+}
+
+// Parse the value at *c, including everything nested within it, in a single
+// pass. Rather than recursing into arrays and objects, each array or object
+// that is still open is tracked as a frame on jg->frames, such that nesting
+// depth is only limited by .opt_parse.max_depth (or by available heap memory).
+// Element values (and keys) are added to jg->stack (or jg->tape) as they are
+// parsed, and packed once the closing bracket or brace is reached.
+// Parsing starts with step jg->parse_step, and each step taken is recorded
+// there, so that jg_parse_feed() can retry a step that ran out of JSON text.
+static jg_ret parse_element(
+    jg_t * jg,
+    char const * * c,
+    struct jg_val_in * v
+) {
+    for (;;) {
+        switch (jg->parse_step) {
+        case JG_PARSE_STEP_VALUE:
+            skip_any_whitespace_or_comments(c, jg->json_over);
+            if (is_json_over(jg, *c)) {
+                return jg->frame_c ?
+                    unterminated(jg, c) : JG_E_PARSE_INVALID_TYPE;
+            }
+            *v = (struct jg_val_in) {0}; // e.g., parse_false() relies on this
+            switch (**c) {
+            case '"':
+                JG_GUARD(parse_string(jg, c, v));
+                if (jg->unescapes_strs && !(jg->is_lazy && jg->frame_c)) {
+                    JG_GUARD(unescape_str(jg, v));
+                }
+                break;
+            case '-': case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                JG_GUARD(parse_number(c, jg->json_over, v));
+                if (*c == jg->json_over && jg->json_is_partial) {
+                    // More digits may follow: have parse_more() retry later.
+                    return JG_E_PARSE_NUM_INVALID;
+                }
+                // (Lazy mode discards values nested in the root until later.)
+                if (jg->decodes_nums && !(jg->is_lazy && jg->frame_c)) {
+                    JG_GUARD(decode_number(jg, v));
+                }
+                break;
+            case 'f':
+                JG_GUARD(parse_false(c, jg->json_over, v));
+                break;
+            case 'n':
+                JG_GUARD(parse_null(c, jg->json_over, v));
+                break;
+            case 't':
+                JG_GUARD(parse_true(c, jg->json_over, v));
+                break;
+            case '[': case '{':
+                JG_GUARD(open_container(jg, c));
+                set_parse_step(jg, JG_PARSE_STEP_OPENED, *c);
+                continue;
+            default:
+                return JG_E_PARSE_INVALID_TYPE;
+            }
+            break;
+        case JG_PARSE_STEP_OPENED: case JG_PARSE_STEP_ADDED:
+            {
+                struct jg_frame const * frame = jg->frames + jg->frame_c - 1;
+                skip_any_whitespace_or_comments(c, jg->json_over);
+                if (is_json_over(jg, *c)) {
+                    return unterminated(jg, c);
+                }
+                if (**c == (frame->type == JG_TYPE_ARR ? ']' : '}')) {
+                    (*c)++;
+                    JG_GUARD(close_container(jg, v));
+                    if (jg->is_lazy) {
+                        JG_GUARD(add_lazy_skip(jg, v->json, *c));
+                    }
+                    break;
+                }
+                if (jg->parse_step == JG_PARSE_STEP_ADDED) {
+                    if (**c != ',') {
+                        return frame->type == JG_TYPE_ARR ?
+                            JG_E_PARSE_ARR_INVALID_SEP :
+                            JG_E_PARSE_OBJ_INVALID_SEP;
+                    }
+                    (*c)++;
+                }
+                if (frame->type == JG_TYPE_ARR) {
+                    set_parse_step(jg, JG_PARSE_STEP_VALUE, *c);
+                    continue; // Parse the next element
+                }
+                skip_any_whitespace_or_comments(c, jg->json_over);
+                if (is_json_over(jg, *c)) {
+                    return unterminated(jg, c);
+                }
+                JG_GUARD(parse_key(jg, c));
+                set_parse_step(jg, JG_PARSE_STEP_KEYED, *c);
+            }
+            // fall through
+        case JG_PARSE_STEP_KEYED:
+            JG_GUARD(parse_key_sep(jg, c));
+            set_parse_step(jg, JG_PARSE_STEP_VALUE, *c);
+            continue; // Parse the next value
+        default: // JG_PARSE_STEP_DONE
+            return JG_OK;
+        }
+        // Value v is complete: add it to the innermost open array or object
+        // (if any), after which its closing bracket or brace may follow.
+        if (!jg->frame_c) {
+            return JG_OK;
+        }
+        JG_GUARD(add_value(jg, v));
+        jg->frames[jg->frame_c - 1].c++;
+        set_parse_step(jg, JG_PARSE_STEP_ADDED, *c);
+    }
+}
+
+// Parse the array elements in [c, c_over) as if they were the elements of an
+// open array, but without a frame for that array, such that parse_in_parallel()
+// can split up a large root array between threads: each element is added to
+// the DOM with add_value() just like any other value at the top level would be.
+jg_ret parse_elements(
+    jg_t * jg,
+    char const * c,
+    char const * c_over,
+    size_t * elem_c
+) {
+    jg->json_cur = c;
+    jg->json_over = c_over;
+    jg->utf8_valid_over = c;
+    for (;;) {
+        struct jg_val_in v = {0};
+        set_parse_step(jg, JG_PARSE_STEP_VALUE, jg->json_cur);
+        JG_GUARD(parse_element(jg, &jg->json_cur, &v));
+        JG_GUARD(add_value(jg, &v));
+        (*elem_c)++;
+        skip_any_whitespace_or_comments(&jg->json_cur, c_over);
+        if (jg->json_cur == c_over) {
+            return JG_OK;
+        }
+        if (*jg->json_cur != ',') {
+            return JG_E_PARSE_ARR_INVALID_SEP;
+        }
+        jg->json_cur++;
+    }
+}
+
+// Return the char following the array or object that opens at c, in JSON text
+// that is known to be valid.
+static char const * skip_container(
+    jg_t * jg,
+    char const * c
+) {
+    // Binary search for c among the .lazy_skips, which are sorted by .open
+    size_t lo = 0;
+    size_t hi = jg->lazy_skip_c;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (jg->lazy_skips[mid].open == c) {
+            return jg->lazy_skips[mid].over;
+        }
+        if (jg->lazy_skips[mid].open < c) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t depth = 0;
+    for (;;) {
+        switch (*c) {
+        case '"':
+            c = skip_string(c, jg->json_over);
+            continue;
+        case '/': case '#': // The JSON text is valid, so these start comments.
+            skip_any_whitespace_or_comments(&c, jg->json_over);
+            continue;
+        case '[': case '{':
+            depth++;
+            break;
+        case ']': case '}':
+            if (!--depth) {
+                return c + 1;
+            }
+            break;
+        default:
+            break;
+        }
+        c++;
+    }
+}
+
+// Parse the elements (or pairs) of an array (or object) that lazy mode left
+// unparsed, now that a getter needs them. Nested arrays and objects are left
+// unparsed in turn: they're skipped over until they are needed themselves. The
+// JSON text was validated by the lazy parse already, so this cannot fail for
+// any reason other than lack of memory.
+jg_ret parse_lazy_container(
+    jg_t * jg,
+    struct jg_val_in * v
+) {
+    char const * c = v->json;
+    enum jg_type type = *c++ == '[' ? JG_TYPE_ARR : JG_TYPE_OBJ;
+    size_t stack_i = jg->stack_c;
+    size_t val_c = 0;
+    for (;; val_c++) {
+        skip_any_whitespace_or_comments(&c, jg->json_over);
+        if (*c == ']' || *c == '}') {
+            break;
+        }
+        if (type == JG_TYPE_OBJ) {
+            struct jg_val_in key = {0};
+            JG_GUARD(parse_string(jg, &c, &key));
+            JG_GUARD(push_value(jg, &key));
+            skip_any_whitespace_or_comments(&c, jg->json_over);
+            c++; // The ':'
+            skip_any_whitespace_or_comments(&c, jg->json_over);
+        }
+        struct jg_val_in val = {0};
+        if (*c == '[' || *c == '{') {
+            val.type = *c == '[' ? JG_TYPE_ARR : JG_TYPE_OBJ;
+            val.json = c;
+            val.is_unparsed = true;
+            c = skip_container(jg, c);
+        } else {
+            set_parse_step(jg, JG_PARSE_STEP_VALUE, c);
+            JG_GUARD(parse_element(jg, &c, &val));
+        }
+        JG_GUARD(push_value(jg, &val));
+        skip_any_whitespace_or_comments(&c, jg->json_over);
+        if (*c == ',') {
+            c++;
+        }
+    }
+    JG_GUARD(pack_container(jg, type, v->json, stack_i, val_c, v));
+    v->is_unparsed = false;
+    return JG_OK;
+}
+
+static int compare_lazy_skips(
+    void const * a,
+    void const * b
+) {
+    char const * a_open = ((struct jg_lazy_skip const *) a)->open;
+    char const * b_open = ((struct jg_lazy_skip const *) b)->open;
+    return a_open < b_open ? -1 : a_open > b_open;
+}
+
+// The lazy parse validated the JSON text as a whole: now parse the root (if it
+// is an array or object), such that getters have something to start from.
+static jg_ret finish_lazy_parse(
+    jg_t * jg
+) {
+    // Containers were recorded as they were closed: inner ones before outer.
+    if (jg->lazy_skip_c > 1) {
+        qsort(jg->lazy_skips, jg->lazy_skip_c, sizeof(struct jg_lazy_skip),
+            compare_lazy_skips);
+    }
+    // All strings are valid UTF-8 now, which saves parse_string() validating
+    // them again.
+    jg->utf8_valid_over = jg->json_over;
+    if ((jg->root_in.type == JG_TYPE_ARR || jg->root_in.type == JG_TYPE_OBJ) &&
+        jg->root_in.is_unparsed) {
+        return parse_lazy_container(jg, &jg->root_in);
+    }
+    return JG_OK;
+}
+
+// If the JSON text is still being fed and parse error ret could be caused by
+// it ending early (e.g., "[tr" or "[1, /"), rewind to the start of the step
+// during which it occurred: that step is retried once more text is fed.
+static jg_ret defer_or_fail(
+    jg_t * jg,
+    jg_ret ret
+) {
+    if (!jg->json_is_partial) {
+        return ret;
+    }
+    switch (ret) {
+    case JG_E_PARSE_UNTERM_STR: case JG_E_PARSE_UNTERM_ARR:
+    case JG_E_PARSE_UNTERM_OBJ:
+        break;
+    default:
+        if (ret < JG_E_PARSE_INVALID_TYPE || ret > JG_E_PARSE_ROOT_SURPLUS) {
+            return ret;
+        }
+        if (jg->json_cur < jg->json_over && (jg->json_cur + 1 < jg->json_over
+            || *jg->json_cur != '/')) { // '/' may be the start of a comment
+            return ret;
+        }
+    }
+    jg->json_cur = jg->parse_step_c;
+    return JG_OK;
+}
+
+static void start_parse(
+    jg_t * jg
+) {
+    jg->json_cur = jg->json_text;
+    jg->utf8_valid_over = jg->json_text;
+    set_parse_step(jg, JG_PARSE_STEP_VALUE, jg->json_text);
+    jg->decodes_nums = jg->opt_parse.decode_numbers && !jg->opt_parse.tape;
+    // Only a copy of the JSON text in jg->text_buf may be modified.
+    jg->unescapes_strs = jg->opt_parse.unescape_in_place &&
+        !jg->json_is_callertext && !jg->json_is_partial;
+    if (!jg->hash_seed) { // Only NDJSON records reuse the previous seed.
+        jg->hash_seed = new_hash_seed(jg);
+    }
+}
+
+// Parse from where the previous call left off (if any) up to jg->json_over.
+// Unless jg->json_is_partial, the JSON text is complete: anything unparsed is
+// then an error, rather than something to retry once more text is fed.
+static jg_ret parse_more(
+    jg_t * jg
+) {
+    if (jg->opt_parse.tape &&
+        (size_t) (jg->json_over - jg->json_text) > JG_TAPE_OFFSET_MAX) {
+        return JG_E_PARSE_TAPE_LIMIT;
+    }
+    if (jg->parse_step != JG_PARSE_STEP_DONE) {
+        jg_ret ret = parse_element(jg, &jg->json_cur, &jg->root_in);
+        if (ret != JG_OK) {
+            return defer_or_fail(jg, ret);
+        }
+        set_parse_step(jg, JG_PARSE_STEP_DONE, jg->json_cur);
+    }
+    skip_any_whitespace_or_comments(&jg->json_cur, jg->json_over);
+    if (jg->json_cur < jg->json_over) {
+        return defer_or_fail(jg, JG_E_PARSE_ROOT_SURPLUS);
+    }
+    if (jg->json_is_partial) {
+        jg->json_cur = jg->parse_step_c; // Re-skip any unterminated comment
+        return JG_OK;
+    }
+    if (jg->opt_parse.tape && jg->tape_c) {
+        // An array or object root: make .root_in refer to the 1st tape entry
+        // (only now, because realloc()ing jg->tape may have moved it).
+        tape_get_val(jg, jg->tape, &jg->root_in);
+    }
+    if (jg->is_lazy) {
+        JG_GUARD(finish_lazy_parse(jg));
+    }
+    unescape_strs(jg);
+    jg->state = JG_STATE_GET;
+    return JG_OK;
+}
+
+// According to https://tools.ietf.org/html/rfc8259 (the current JSON spec at
+// the time of writing), any type of JSON value (i.e., string, number, array,
+// object, true, false, or null) is also valid at the root level.
+//
+// The JSON text is read exactly once: every parse_...() function checks
+// jg->json_over itself, so no preliminary pass is needed to verify that
+// strings, arrays, and objects are terminated before they are parsed.
+static jg_ret parse_root(
+    jg_t * jg
+) {
+    start_parse(jg);
+    jg->is_lazy = jg->opt_parse.lazy && !jg->opt_parse.tape;
+    if (jg->opt_parse.thread_c > 1 && !jg->ndjson.text && !jg->is_lazy) {
+        bool is_parsed = false;
+        JG_GUARD(parse_in_parallel(jg, &is_parsed));
+        if (is_parsed) {
+            unescape_strs(jg);
+            return JG_OK;
+        }
+    }
+    return parse_more(jg);
+}
+
+jg_ret jg_parse_set_opt(
+    jg_t * jg,
+    jg_opt_parse const * opt
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    if (opt) {
+        jg->opt_parse = *opt;
+    } else {
+        jg->opt_parse = (struct jg_opt_parse) {0};
+    }
+    return jg->ret = JG_OK;
+}
+
+// Copy the JSON text string to a malloc-ed char buffer, then parse.
+jg_ret jg_parse_str(
+    jg_t * jg,
+    char const * json_text, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
     }
     jg->state = JG_STATE_PARSE;
-    JG_GUARD(alloc_strcpy(jg, &jg->json_text, json_text, byte_c));
+    JG_GUARD(alloc_text_buf(jg, byte_c + 1, &jg->json_text));
+    memcpy(jg->json_text, json_text, byte_c);
     // Overwrite null-terminator with a newline. The parse functions do not
     // expect a null-terminator, and having a final whitespace char can help
     // avoid an unnecessary malloc() edge case in jg_root_get_<number_type>().
@@ -747,15 +1131,14 @@ jg_ret jg_parse_callerstr(
     return jg->ret = parse_root(jg);
 }
 
-// Open file, copy contents to a malloc-ed char buffer, close file; then parse.
-jg_ret jg_parse_file(
+// Open file, copy contents to jg->text_buf, close file. A newline is appended
+// to the contents, which is included in *byte_c.
+jg_ret read_file(
     jg_t * jg,
-    char const * filepath
+    char const * filepath,
+    char * * text,
+    size_t * byte_c
 ) {
-    if (jg->state != JG_STATE_INIT) {
-        return jg->ret = JG_E_STATE_NOT_PARSE;
-    }
-    jg->state = JG_STATE_PARSE;
 #if defined(_WIN32) || defined(_WIN64)
     wchar_t * wfilepath = str_to_wstr(filepath);
     FILE * f = NULL;
@@ -780,7 +1163,6 @@ jg_ret jg_parse_file(
         jg->err_val.errn = errno;
         return jg->ret = JG_E_ERRNO_FSEEKO;
     }
-    size_t byte_c = 0;
     {
 #if defined(_WIN32) || defined(_WIN64)
         __int64 size = _ftelli64(f);
@@ -791,26 +1173,364 @@ jg_ret jg_parse_file(
             jg->err_val.errn = errno;
             return jg->ret = JG_E_ERRNO_FTELLO;
         }
-        byte_c = (size_t) size;
+        *byte_c = (size_t) size;
     }
     rewind(f);
-    jg->json_text = malloc(byte_c + 1);
-    if (!jg->json_text) {
-        return jg->ret = JG_E_MALLOC;
-    }
+    JG_GUARD(alloc_text_buf(jg, *byte_c + 1, text));
     // Append a newline instead of a null-terminator. The parse functions do not
     // expect a null-terminator, and having a final whitespace char can help
     // avoid an unnecessary malloc() edge case in jg_root_get_<number_type>().
-    jg->json_text[byte_c] = '\n';
-    if (fread(jg->json_text, 1, byte_c, f) != byte_c) {
-        free(jg->json_text);
+    (*text)[*byte_c] = '\n';
+    if (fread(*text, 1, *byte_c, f) != *byte_c) {
+        *text = NULL;
         return jg->ret = JG_E_FREAD;
     }
     if (fclose(f)) {
-        free(jg->json_text);
+        *text = NULL;
         jg->err_val.errn = errno;
         return jg->ret = JG_E_ERRNO_FCLOSE;
     }
-    jg->json_over = jg->json_text + ++byte_c;
+    ++*byte_c;
+    return JG_OK;
+}
+
+// Open file, copy contents to a malloc-ed char buffer, close file; then parse.
+jg_ret jg_parse_file(
+    jg_t * jg,
+    char const * filepath
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->state = JG_STATE_PARSE;
+    size_t byte_c = 0;
+    JG_GUARD(read_file(jg, filepath, &jg->json_text, &byte_c));
+    jg->json_over = jg->json_text + byte_c;
     return jg->ret = parse_root(jg);
 }
+
+// jg_parse_file(), except that the contents are hashed first, and only parsed
+// if their hash differs from *old_hash (if not NULL). Otherwise, the contents
+// are the same as those parsed last, so jg is simply reinited.
+jg_ret parse_file_if_changed(
+    jg_t * jg,
+    char const * filepath,
+    uint64_t const * old_hash,
+    uint64_t * new_hash,
+    bool * is_parsed
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->state = JG_STATE_PARSE;
+    size_t byte_c = 0;
+    JG_GUARD(read_file(jg, filepath, &jg->json_text, &byte_c));
+    *new_hash = hash_bytes(0, (uint8_t const *) jg->json_text, byte_c);
+    *is_parsed = !old_hash || *new_hash != *old_hash;
+    if (!*is_parsed) {
+        jg_reinit(jg);
+        return jg->ret = JG_OK;
+    }
+    jg->json_over = jg->json_text + byte_c;
+    return jg->ret = parse_root(jg);
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+// Map the file into memory read-only, or set *text to "" if the file is empty
+// (in which case *byte_c is 0, and nothing is to be munmap()ed).
+jg_ret map_file(
+    jg_t * jg,
+    char const * filepath,
+    bool is_sequential,
+    char const * * text,
+    size_t * byte_c
+) {
+    int fd = open(filepath, O_RDONLY);
+    if (fd == -1) {
+        jg->err_val.errn = errno;
+        return jg->ret = JG_E_ERRNO_FOPEN;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        jg->err_val.errn = errno;
+        close(fd);
+        return jg->ret = JG_E_ERRNO_FSTAT;
+    }
+    if ((uintmax_t) st.st_size > SIZE_MAX) {
+        close(fd);
+        jg->err_val.errn = EFBIG;
+        return jg->ret = JG_E_ERRNO_MMAP;
+    }
+    *byte_c = (size_t) st.st_size;
+    if (!*byte_c) { // mmap() does not do empty mappings
+        close(fd);
+        *text = "";
+        return JG_OK;
+    }
+    void * map = mmap(NULL, *byte_c, PROT_READ, MAP_PRIVATE, fd, 0);
+    int mmap_errn = errno;
+    // The mapping outlives the file descriptor; and because the file was only
+    // opened for reading, there is nothing to be lost by a failing close().
+    close(fd);
+    if (map == MAP_FAILED) {
+        jg->err_val.errn = mmap_errn;
+        return jg->ret = JG_E_ERRNO_MMAP;
+    }
+    // The JSON text is read exactly once from front to back, so ask the kernel
+    // to read ahead aggressively. Both calls are advisory: ignore any failure.
+    if (is_sequential) {
+        posix_madvise(map, *byte_c, POSIX_MADV_SEQUENTIAL);
+        posix_madvise(map, *byte_c, POSIX_MADV_WILLNEED);
+    }
+    *text = map;
+    return JG_OK;
+}
+#endif
+
+// Map the file into memory read-only, then parse the mapping as-is.
+jg_ret jg_parse_file_mmap(
+    jg_t * jg,
+    char const * filepath
+) {
+#if defined(_WIN32) || defined(_WIN64)
+    return jg_parse_file(jg, filepath); // No MapViewOfFile() variant yet
+#else
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->state = JG_STATE_PARSE;
+    size_t byte_c = 0;
+    JG_GUARD(map_file(jg, filepath, true, &jg->json_callertext, &byte_c));
+    jg->json_is_callertext = true;
+    jg->json_mmap_byte_c = byte_c;
+    // Unlike jg_parse_file(), no newline can be appended to the JSON text, so
+    // the mapping is treated the same as jg_parse_callerstr()'s caller string:
+    // jg_root_get_<number_type>() then copies a root-level number that ends at
+    // .json_over instead of relying on a trailing whitespace char.
+    jg->json_over = jg->json_callertext + byte_c;
+    return jg->ret = parse_root(jg);
+#endif
+}
+
+// The size of the first jg_parse_feed() buffer if no size hint is given
+#define JG_FEED_BUF_DEFAULT_SIZE 0x1000 // 4 KiB
+
+static char const * rebase_c(
+    char const * c,
+    char const * old_text,
+    char const * new_text
+) {
+    return c ? new_text + (c - old_text) : NULL;
+}
+
+// Replace jg->feed_buf with a buffer that has room for at least byte_c more
+// bytes (plus 1 for jg_parse_end()'s newline), and make everything that points
+// into the JSON text point into the new buffer.
+static jg_ret grow_feed_buf(
+    jg_t * jg,
+    size_t byte_c
+) {
+    struct jg_feed_buf * old = jg->feed_buf;
+    if (byte_c > SIZE_MAX / 4 - old->byte_c) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    size_t size = JG_MAX(2 * old->size, old->byte_c + byte_c + 1);
+    struct jg_feed_buf * buf = malloc(sizeof(struct jg_feed_buf) + size);
+    if (!buf) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    buf->prev = old;
+    buf->byte_c = old->byte_c;
+    buf->size = size;
+    memcpy(buf->text, old->text, old->byte_c);
+    // Values that were already parsed keep referring to the old buffer, except
+    // in tape mode, where they refer to whichever buffer jg->json_text is.
+    if (jg->opt_parse.tape) {
+        jg_ret ret = rebase_obj_indexes(jg, old->text, buf->text);
+        if (ret != JG_OK) {
+            free(buf);
+            return ret;
+        }
+    }
+    jg->json_cur = rebase_c(jg->json_cur, old->text, buf->text);
+    jg->utf8_valid_over = rebase_c(jg->utf8_valid_over, old->text, buf->text);
+    jg->parse_step_c = rebase_c(jg->parse_step_c, old->text, buf->text);
+    jg->feed_str_open = rebase_c(jg->feed_str_open, old->text, buf->text);
+    jg->feed_str_resume = rebase_c(jg->feed_str_resume, old->text, buf->text);
+    for (size_t i = 0; i < jg->frame_c; i++) {
+        jg->frames[i].open = rebase_c(jg->frames[i].open, old->text, buf->text);
+    }
+    jg->feed_buf = buf;
+    jg->json_text = buf->text;
+    return JG_OK;
+}
+
+// Start parsing JSON text that is to be fed in chunks with jg_parse_feed().
+jg_ret jg_parse_begin(
+    jg_t * jg,
+    size_t byte_c_hint // the expected JSON text size, or 0 if unknown
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->state = JG_STATE_PARSE;
+    size_t size = JG_FEED_BUF_DEFAULT_SIZE;
+    if (byte_c_hint && byte_c_hint < SIZE_MAX / 2) {
+        size = byte_c_hint + 1; // + 1 for jg_parse_end()'s newline
+    }
+    jg->feed_buf = malloc(sizeof(struct jg_feed_buf) + size);
+    if (!jg->feed_buf) {
+        return jg->ret = JG_E_MALLOC;
+    }
+    jg->feed_buf->prev = NULL;
+    jg->feed_buf->byte_c = 0;
+    jg->feed_buf->size = size;
+    jg->json_text = jg->feed_buf->text;
+    jg->json_over = jg->json_text;
+    jg->json_is_partial = true;
+    start_parse(jg);
+    return jg->ret = JG_OK;
+}
+
+// Append a chunk of JSON text to what was fed so far, and parse as much of it
+// as possible. The JSON text can be split anywhere, even within a UTF-8 char.
+jg_ret jg_parse_feed(
+    jg_t * jg,
+    char const * chunk, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+) {
+    if (!jg->json_is_partial) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    if (jg->feed_buf->size - jg->feed_buf->byte_c <= byte_c) {
+        JG_GUARD(grow_feed_buf(jg, byte_c));
+    }
+    struct jg_feed_buf * buf = jg->feed_buf;
+    memcpy(buf->text + buf->byte_c, chunk, byte_c);
+    buf->byte_c += byte_c;
+    jg->json_over = buf->text + buf->byte_c;
+    jg_ret ret = parse_more(jg);
+    if (ret != JG_OK) {
+        jg->json_is_partial = false; // Nothing more can be fed after an error.
+    }
+    return jg->ret = ret;
+}
+
+// Parse whatever remains of the JSON text fed with jg_parse_feed().
+jg_ret jg_parse_end(
+    jg_t * jg
+) {
+    if (!jg->json_is_partial) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->json_is_partial = false;
+    // Append a newline for the same reason as jg_parse_str() does. There is
+    // always room for it, because jg_parse_feed() reserves it.
+    struct jg_feed_buf * buf = jg->feed_buf;
+    buf->text[buf->byte_c++] = '\n';
+    jg->json_over = buf->text + buf->byte_c;
+    return jg->ret = parse_more(jg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NDJSON (a.k.a. JSON Lines): a JSON text per line, parsed one at a time
+
+static jg_ret begin_ndjson(
+    jg_t * jg,
+    char const * ndjson_text,
+    size_t byte_c
+) {
+    jg->state = JG_STATE_PARSE;
+    jg->ndjson.text = ndjson_text;
+    jg->ndjson.cur = ndjson_text;
+    jg->ndjson.over = ndjson_text + byte_c;
+    return jg->ret = JG_OK;
+}
+
+// Copy the NDJSON text to a malloc-ed char buffer; then see
+// jg_parse_ndjson_next().
+jg_ret jg_parse_ndjson_str(
+    jg_t * jg,
+    char const * ndjson_text, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    char * text = NULL;
+    JG_GUARD(alloc_text_buf(jg, byte_c + 1, &text));
+    memcpy(text, ndjson_text, byte_c);
+    return begin_ndjson(jg, text, byte_c);
+}
+
+// Use the NDJSON text as-is; then see jg_parse_ndjson_next().
+jg_ret jg_parse_ndjson_callerstr(
+    jg_t * jg,
+    char const * ndjson_text, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    jg->ndjson.is_callertext = true;
+    return begin_ndjson(jg, ndjson_text, byte_c);
+}
+
+// Map the file into memory read-only (or on Windows, copy its contents to a
+// malloc-ed char buffer); then see jg_parse_ndjson_next().
+jg_ret jg_parse_ndjson_file(
+    jg_t * jg,
+    char const * filepath
+) {
+    if (jg->state != JG_STATE_INIT) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    size_t byte_c = 0;
+#if defined(_WIN32) || defined(_WIN64)
+    char * text = NULL;
+    JG_GUARD(read_file(jg, filepath, &text, &byte_c));
+#else
+    char const * text = NULL;
+    JG_GUARD(map_file(jg, filepath, true, &text, &byte_c));
+    jg->ndjson.is_callertext = true;
+    jg->ndjson.mmap_byte_c = byte_c;
+#endif
+    return begin_ndjson(jg, text, byte_c);
+}
+
+// Discard the previous record (if any), then parse the next one: the next line
+// that contains anything other than whitespace. Sets *line_i to that record's
+// line number, or to 0 if no records remain.
+jg_ret jg_parse_ndjson_next(
+    jg_t * jg,
+    size_t * line_i
+) {
+    *line_i = 0;
+    if (!jg->ndjson.text) {
+        return jg->ret = JG_E_STATE_NOT_PARSE;
+    }
+    // Everything but the NDJSON text itself (and the hash seed) is reset, but
+    // all memory is kept, so that parsing a record rarely has to malloc().
+    reinit_for_ndjson_record(jg);
+    while (jg->ndjson.cur < jg->ndjson.over) {
+        char const * line = jg->ndjson.cur;
+        char const * line_over =
+            memchr(line, '\n', jg->ndjson.over - jg->ndjson.cur);
+        if (line_over) {
+            jg->ndjson.cur = line_over + 1;
+        } else {
+            jg->ndjson.cur = line_over = jg->ndjson.over;
+        }
+        jg->ndjson.line_i++;
+        if (skip_whitespace(line, line_over) == line_over) {
+            continue; // Skip blank lines (including any '\r' of a "\r\n").
+        }
+        *line_i = jg->ndjson.line_i;
+        jg->state = JG_STATE_PARSE;
+        jg->json_callertext = line;
+        jg->json_is_callertext = true;
+        jg->json_over = line_over;
+        return jg->ret = parse_root(jg);
+    }
+    return jg->ret = JG_OK;
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+struct jg_pool {
+    struct jg_opt_pool opt;
+    struct jg_lock lock; // Protects the members below
+    jg_t * idle; // LIFO of idle sessions, linked through jg->pool_next
+    size_t idle_c;
+};
+
+// The first session is created right away: besides sparing the first
+// jg_pool_get() the trouble, it gives init_lock() a jg_t to report errors to.
+jg_pool_t * jg_pool_init(
+    jg_opt_pool const * opt
+) {
+    jg_pool_t * pool = calloc(1, sizeof(struct jg_pool));
+    if (!pool) {
+        return NULL;
+    }
+    if (opt) {
+        pool->opt = *opt;
+    }
+    jg_t * jg = jg_init();
+    if (!jg) {
+        free(pool);
+        return NULL;
+    }
+    if (init_lock(jg, &pool->lock)) {
+        jg_free(jg);
+        free(pool);
+        return NULL;
+    }
+    jg->opt_parse = pool->opt.opt_parse;
+    pool->idle = jg;
+    pool->idle_c = 1;
+    return pool;
+}
+
+void jg_pool_free(
+    jg_pool_t * pool
+) {
+    for (jg_t * jg = pool->idle; jg;) {
+        jg_t * jg_next = jg->pool_next;
+        jg_free(jg);
+        jg = jg_next;
+    }
+    free_lock(&pool->lock);
+    free(pool);
+}
+
+jg_t * jg_pool_get(
+    jg_pool_t * pool
+) {
+    acquire_lock(&pool->lock);
+    jg_t * jg = pool->idle;
+    if (jg) {
+        pool->idle = jg->pool_next;
+        pool->idle_c--;
+    }
+    release_lock(&pool->lock);
+    if (jg) {
+        jg->pool_next = NULL;
+        return jg;
+    }
+    jg = jg_init();
+    if (jg) {
+        jg->opt_parse = pool->opt.opt_parse;
+    }
+    return jg;
+}
+
+void jg_pool_put(
+    jg_pool_t * pool,
+    jg_t * jg
+) {
+    // Reinit outside of the lock: with the pool's options, which also decide
+    // how much of its memory the session gets to keep.
+    jg->opt_parse = pool->opt.opt_parse;
+    jg_reinit(jg);
+    acquire_lock(&pool->lock);
+    if (!pool->opt.max_idle_c || pool->idle_c < pool->opt.max_idle_c) {
+        jg->pool_next = pool->idle;
+        pool->idle = jg;
+        pool->idle_c++;
+        jg = NULL;
+    }
+    release_lock(&pool->lock);
+    if (jg) {
+        jg_free(jg);
+    }
+}
@@ -0,0 +1,493 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+// Block-wise scanning kernels for the hot loops of jg_parse.c (and for integer
+// decoding by jg_get.c). On x86-64, SSE2 is always available; and when compiled
+// with GCC or Clang, SSSE3 and AVX2 are used if the CPU supports them (detected
+// at runtime, so that the library need not be compiled with -mavx2). Elsewhere
+// a portable SWAR (SIMD Within A Register) fallback scans 8 bytes at a time.
+//
+// Every kernel returns a pointer to the first byte in the range [c, c_over)
+// that does not belong to the class of bytes being skipped, or c_over if no
+// such byte exists. Kernels never read at or beyond c_over.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JG_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) // GCC or Clang: allows per-function target attributes
+#define JG_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define JG_SWAR_ONES UINT64_C(0x0101010101010101)
+#define JG_SWAR_LOWS UINT64_C(0x7F7F7F7F7F7F7F7F)
+#define JG_SWAR_HIGHS UINT64_C(0x8080808080808080)
+
+static uint64_t load_swar(
+    char const * c
+) {
+    uint64_t x = 0;
+    memcpy(&x, c, sizeof(x)); // (gets compiled into a single unaligned load)
+    return x;
+}
+
+#ifdef JG_SIMD_SSE2
+
+static unsigned get_first_set_bit_i( // mask must not be 0
+    uint32_t mask
+) {
+#ifdef _MSC_VER
+    unsigned long i = 0;
+    _BitScanForward(&i, mask);
+    return i;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#else
+
+// Returns x with the high bit of each byte that equals b set, and all other
+// bits cleared. Unlike the well-known "has zero byte" trick, this is exact for
+// every byte (no carries between bytes), which makes it byte order agnostic.
+static uint64_t swar_eq_bytes(
+    uint64_t x,
+    uint8_t b
+) {
+    x ^= JG_SWAR_ONES * b;
+    return ~(((x & JG_SWAR_LOWS) + JG_SWAR_LOWS) | x | JG_SWAR_LOWS);
+}
+
+#endif
+
+#ifdef JG_SIMD_DISPATCH
+
+// Non-ASCII bytes are negative as signed chars, so whether they are stopped at
+// along with control chars is determined by flipping their sign or not.
+
+__attribute__((target("avx2")))
+static char const * skip_str_chars_avx2(
+    char const * c,
+    char const * const c_over,
+    bool skip_non_ascii
+) {
+    __m256i const quote = _mm256_set1_epi8('"');
+    __m256i const backslash = _mm256_set1_epi8('\\');
+    __m256i const flip = _mm256_set1_epi8(skip_non_ascii ? (char) 0x80 : 0);
+    __m256i const space = _mm256_xor_si256(_mm256_set1_epi8(' '), flip);
+    for (; c_over - c >= 32; c += 32) {
+        __m256i const v = _mm256_loadu_si256((__m256i const *) c);
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_cmpgt_epi8(space, _mm256_xor_si256(v, flip))));
+        if (mask) {
+            return c + get_first_set_bit_i(mask);
+        }
+    }
+    return c;
+}
+
+__attribute__((target("avx2")))
+static char const * skip_whitespace_avx2(
+    char const * c,
+    char const * const c_over
+) {
+    __m256i const space = _mm256_set1_epi8(' ');
+    __m256i const newline = _mm256_set1_epi8('\n');
+    __m256i const tab = _mm256_set1_epi8('\t');
+    __m256i const carriage_return = _mm256_set1_epi8('\r');
+    for (; c_over - c >= 32; c += 32) {
+        __m256i const v = _mm256_loadu_si256((__m256i const *) c);
+        uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space),
+                _mm256_cmpeq_epi8(v, newline)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, tab),
+                _mm256_cmpeq_epi8(v, carriage_return))));
+        if (mask) {
+            return c + get_first_set_bit_i(mask);
+        }
+    }
+    return c;
+}
+
+#endif
+
+char const * skip_str_chars(
+    char const * c,
+    char const * const c_over,
+    bool skip_non_ascii
+) {
+#ifdef JG_SIMD_DISPATCH
+    if (__builtin_cpu_supports("avx2")) {
+        c = skip_str_chars_avx2(c, c_over, skip_non_ascii);
+    }
+#endif
+#ifdef JG_SIMD_SSE2
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const flip = _mm_set1_epi8(skip_non_ascii ? (char) 0x80 : 0);
+    __m128i const space = _mm_xor_si128(_mm_set1_epi8(' '), flip);
+    for (; c_over - c >= 16; c += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const *) c);
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmplt_epi8(_mm_xor_si128(v, flip), space)));
+        if (mask) {
+            return c + get_first_set_bit_i(mask);
+        }
+    }
+#else
+    uint64_t const non_ascii = skip_non_ascii ? 0 : JG_SWAR_HIGHS;
+    for (; c_over - c >= 8; c += 8) {
+        uint64_t const x = load_swar(c);
+        // Control characters are caught by adding 0x60 to the low 7 bits of
+        // each byte: only bytes below 0x20 then still have their high bit
+        // cleared.
+        uint64_t const control =
+            ~(((x & JG_SWAR_LOWS) + JG_SWAR_ONES * 0x60) | x) & JG_SWAR_HIGHS;
+        if (swar_eq_bytes(x, '"') || swar_eq_bytes(x, '\\') || control ||
+            (x & non_ascii)) {
+            break;
+        }
+    }
+#endif
+    while (c < c_over && *c != '"' && *c != '\\' && ((uint8_t) *c >= ' ') &&
+        (skip_non_ascii || (uint8_t) *c < 0x80)) {
+        c++;
+    }
+    return c;
+}
+
+char const * skip_whitespace(
+    char const * c,
+    char const * const c_over
+) {
+#ifdef JG_SIMD_DISPATCH
+    if (__builtin_cpu_supports("avx2")) {
+        c = skip_whitespace_avx2(c, c_over);
+    }
+#endif
+#ifdef JG_SIMD_SSE2
+    __m128i const space = _mm_set1_epi8(' ');
+    __m128i const newline = _mm_set1_epi8('\n');
+    __m128i const tab = _mm_set1_epi8('\t');
+    __m128i const carriage_return = _mm_set1_epi8('\r');
+    for (; c_over - c >= 16; c += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const *) c);
+        uint32_t mask = ~(uint32_t) _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, space),
+                _mm_cmpeq_epi8(v, newline)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, tab),
+                _mm_cmpeq_epi8(v, carriage_return)))) & 0xFFFF;
+        if (mask) {
+            return c + get_first_set_bit_i(mask);
+        }
+    }
+#else
+    for (; c_over - c >= 8; c += 8) {
+        uint64_t const x = load_swar(c);
+        if ((swar_eq_bytes(x, ' ') | swar_eq_bytes(x, '\n') |
+            swar_eq_bytes(x, '\t') | swar_eq_bytes(x, '\r')) != JG_SWAR_HIGHS) {
+            break;
+        }
+    }
+#endif
+    while (c < c_over &&
+        (*c == ' ' || *c == '\n' || *c == '\t' || *c == '\r')) {
+        c++;
+    }
+    return c;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// UTF-8 validation ////////////////////////////////////////////////////////////
+
+// Validate char by char, skipping ASCII 8 bytes at a time. This is also used to
+// pinpoint the exact offset of any error found by the vectorized validators.
+static char const * skip_valid_utf8_scalar(
+    char const * c,
+    char const * const c_over
+) {
+    while (c < c_over) {
+        if (c_over - c >= 8 && !(load_swar(c) & JG_SWAR_HIGHS)) {
+            c += 8;
+            continue;
+        }
+        size_t char_size = get_valid_utf8_char_size((uint8_t const *) c,
+            (uint8_t const *) c_over);
+        if (!char_size) {
+            return c;
+        }
+        c += char_size;
+    }
+    return c;
+}
+
+#ifdef JG_SIMD_DISPATCH
+
+// The vectorized validators below implement the lookup table algorithm of
+// John Keiser and Daniel Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte" (Software: Practice and Experience, 2021). Each error
+// condition of a 2-byte window is assigned a bit. Three 16-entry tables indexed
+// by the high and low nibble of the 1st byte and the high nibble of the 2nd
+// byte each yield the error conditions their nibble is compatible with; so an
+// error exists where all three have a bit in common. The 3rd and 4th bytes of
+// 3 and 4 byte chars are covered by checking that continuation bytes occur
+// exactly where a preceding lead byte requires them to.
+//
+// These validators stop at the first block that contains an error, after which
+// skip_valid_utf8_scalar() determines its exact offset.
+
+#define JG_UTF8_TOO_SHORT (1 << 0) // 11______ 0_______ or 11______ 11______
+#define JG_UTF8_TOO_LONG (1 << 1) // 0_______ 10______
+#define JG_UTF8_OVERLONG_3 (1 << 2) // 11100000 100_____
+#define JG_UTF8_TOO_LARGE (1 << 3) // 11110100 1001____ or 11110101+ ________
+#define JG_UTF8_SURROGATE (1 << 4) // 11101101 101_____
+#define JG_UTF8_OVERLONG_2 (1 << 5) // 1100000_ 10______
+#define JG_UTF8_TOO_LARGE_1000 (1 << 6) // 11110101+ 1000____
+#define JG_UTF8_OVERLONG_4 (1 << 6) // 11110000 1000____
+// (1 << 7), but as a (negative) value that fits in the char arguments of
+// _mm_setr_epi8() and _mm256_setr_epi8(), which also holds for any bitwise OR.
+#define JG_UTF8_TWO_CONTS (-0x7F - 1) // 10______ 10______
+#define JG_UTF8_CARRY \
+    (JG_UTF8_TOO_SHORT | JG_UTF8_TOO_LONG | JG_UTF8_TWO_CONTS)
+
+// The table arguments for _mm_setr_epi8() and _mm256_setr_epi8()
+#define JG_UTF8_BYTE_1_HIGH \
+    JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, \
+    JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, JG_UTF8_TOO_LONG, \
+    JG_UTF8_TWO_CONTS, JG_UTF8_TWO_CONTS, \
+    JG_UTF8_TWO_CONTS, JG_UTF8_TWO_CONTS, \
+    JG_UTF8_TOO_SHORT | JG_UTF8_OVERLONG_2, \
+    JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_SHORT | JG_UTF8_OVERLONG_3 | JG_UTF8_SURROGATE, \
+    JG_UTF8_TOO_SHORT | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000 | \
+        JG_UTF8_OVERLONG_4
+#define JG_UTF8_BYTE_1_LOW \
+    JG_UTF8_CARRY | JG_UTF8_OVERLONG_3 | JG_UTF8_OVERLONG_2 | \
+        JG_UTF8_OVERLONG_4, \
+    JG_UTF8_CARRY | JG_UTF8_OVERLONG_2, \
+    JG_UTF8_CARRY, \
+    JG_UTF8_CARRY, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000 | \
+        JG_UTF8_SURROGATE, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000, \
+    JG_UTF8_CARRY | JG_UTF8_TOO_LARGE | JG_UTF8_TOO_LARGE_1000
+#define JG_UTF8_BYTE_2_HIGH \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_LONG | JG_UTF8_OVERLONG_2 | JG_UTF8_TWO_CONTS | \
+        JG_UTF8_OVERLONG_3 | JG_UTF8_TOO_LARGE_1000 | JG_UTF8_OVERLONG_4, \
+    JG_UTF8_TOO_LONG | JG_UTF8_OVERLONG_2 | JG_UTF8_TWO_CONTS | \
+        JG_UTF8_OVERLONG_3 | JG_UTF8_TOO_LARGE, \
+    JG_UTF8_TOO_LONG | JG_UTF8_OVERLONG_2 | JG_UTF8_TWO_CONTS | \
+        JG_UTF8_SURROGATE | JG_UTF8_TOO_LARGE, \
+    JG_UTF8_TOO_LONG | JG_UTF8_OVERLONG_2 | JG_UTF8_TWO_CONTS | \
+        JG_UTF8_SURROGATE | JG_UTF8_TOO_LARGE, \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT, \
+    JG_UTF8_TOO_SHORT, JG_UTF8_TOO_SHORT
+
+// The last 3 bytes of a block must not be lead bytes of chars that do not fit.
+#define JG_UTF8_INCOMPLETE_MAX_16 \
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, \
+    (char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1)
+
+__attribute__((target("ssse3")))
+static char const * skip_valid_utf8_ssse3(
+    char const * c,
+    char const * const c_over
+) {
+    __m128i const byte_1_high_table = _mm_setr_epi8(JG_UTF8_BYTE_1_HIGH);
+    __m128i const byte_1_low_table = _mm_setr_epi8(JG_UTF8_BYTE_1_LOW);
+    __m128i const byte_2_high_table = _mm_setr_epi8(JG_UTF8_BYTE_2_HIGH);
+    __m128i const incomplete_max = _mm_setr_epi8(JG_UTF8_INCOMPLETE_MAX_16);
+    __m128i const nibble = _mm_set1_epi8(0x0F);
+    __m128i prev = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    for (; c_over - c >= 16; c += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const *) c);
+        __m128i err = prev_incomplete;
+        if (_mm_movemask_epi8(v)) { // Not all ASCII
+            __m128i const prev1 = _mm_alignr_epi8(v, prev, 15);
+            __m128i const special_cases = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(byte_1_high_table,
+                    _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                _mm_shuffle_epi8(byte_1_low_table,
+                    _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(byte_2_high_table,
+                    _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+            // Only 111_____ yields >= 0x80 for the 3rd byte, and only 1111____
+            // for the 4th byte.
+            __m128i const must_be_continuation = _mm_and_si128(_mm_or_si128(
+                _mm_subs_epu8(_mm_alignr_epi8(v, prev, 14),
+                    _mm_set1_epi8((char) (0xE0 - 0x80))),
+                _mm_subs_epu8(_mm_alignr_epi8(v, prev, 13),
+                    _mm_set1_epi8((char) (0xF0 - 0x80)))),
+                _mm_set1_epi8((char) 0x80));
+            err = _mm_xor_si128(must_be_continuation, special_cases);
+            prev_incomplete = _mm_subs_epu8(v, incomplete_max);
+        } else {
+            prev_incomplete = _mm_setzero_si128();
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) !=
+            0xFFFF) {
+            break;
+        }
+        prev = v;
+    }
+    return c;
+}
+
+__attribute__((target("avx2")))
+static char const * skip_valid_utf8_avx2(
+    char const * c,
+    char const * const c_over
+) {
+    __m256i const byte_1_high_table =
+        _mm256_setr_epi8(JG_UTF8_BYTE_1_HIGH, JG_UTF8_BYTE_1_HIGH);
+    __m256i const byte_1_low_table =
+        _mm256_setr_epi8(JG_UTF8_BYTE_1_LOW, JG_UTF8_BYTE_1_LOW);
+    __m256i const byte_2_high_table =
+        _mm256_setr_epi8(JG_UTF8_BYTE_2_HIGH, JG_UTF8_BYTE_2_HIGH);
+    __m256i const incomplete_max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, JG_UTF8_INCOMPLETE_MAX_16);
+    __m256i const nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    for (; c_over - c >= 32; c += 32) {
+        __m256i const v = _mm256_loadu_si256((__m256i const *) c);
+        __m256i err = prev_incomplete;
+        if (_mm256_movemask_epi8(v)) { // Not all ASCII
+            // Unlike _mm_alignr_epi8(), _mm256_alignr_epi8() shifts within
+            // each 128-bit lane; hence the lane crossing permutation.
+            __m256i const prev_lanes = _mm256_permute2x128_si256(prev, v, 0x21);
+            __m256i const prev1 = _mm256_alignr_epi8(v, prev_lanes, 15);
+            __m256i const special_cases = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(byte_1_high_table,
+                    _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(byte_1_low_table,
+                    _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte_2_high_table,
+                    _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+            __m256i const must_be_continuation = _mm256_and_si256(
+                _mm256_or_si256(
+                    _mm256_subs_epu8(_mm256_alignr_epi8(v, prev_lanes, 14),
+                        _mm256_set1_epi8((char) (0xE0 - 0x80))),
+                    _mm256_subs_epu8(_mm256_alignr_epi8(v, prev_lanes, 13),
+                        _mm256_set1_epi8((char) (0xF0 - 0x80)))),
+                _mm256_set1_epi8((char) 0x80));
+            err = _mm256_xor_si256(must_be_continuation, special_cases);
+            prev_incomplete = _mm256_subs_epu8(v, incomplete_max);
+        } else {
+            prev_incomplete = _mm256_setzero_si256();
+        }
+        if (!_mm256_testz_si256(err, err)) {
+            break;
+        }
+        prev = v;
+    }
+    return c;
+}
+
+#endif
+
+char const * skip_valid_utf8(
+    char const * c,
+    char const * const c_over
+) {
+#ifdef JG_SIMD_DISPATCH
+    char const * const c_start = c;
+    if (__builtin_cpu_supports("avx2")) {
+        c = skip_valid_utf8_avx2(c, c_over);
+    } else if (__builtin_cpu_supports("ssse3")) {
+        c = skip_valid_utf8_ssse3(c, c_over);
+    }
+    // The vectorized validators stop at the start of a block that either
+    // contains an error or is the incomplete final block. Either way, the last
+    // char of the previous block (if any) may extend into it (or be
+    // erroneously cut off by it), so back up to the start of that char.
+    char const * c_backup = c - JG_MIN(3, c - c_start);
+    while (c_backup < c && is_utf8_continuation_byte((uint8_t) *c_backup)) {
+        c_backup++;
+    }
+    c = c_backup;
+#endif
+    return skip_valid_utf8_scalar(c, c_over);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Integer decoding ////////////////////////////////////////////////////////////
+
+// Whether all 8 bytes of x are ASCII digits: their high nibbles must be 3, and
+// adding 6 to each byte must not carry into its high nibble (i.e., > '9').
+static bool swar_is_8_digits(
+    uint64_t x
+) {
+    return !((x & (x + JG_SWAR_ONES * 6) & UINT64_C(0xF0F0F0F0F0F0F0F0)) ^
+        (JG_SWAR_ONES * 0x30));
+}
+
+// Converts 8 ASCII digits loaded little-endian (the 1st digit in the low byte)
+// to their value by combining adjacent pairs of digits, then of 2-digit
+// numbers, then of 4-digit numbers: three multiplications in total.
+static uint32_t swar_parse_8_digits(
+    uint64_t x
+) {
+    x = ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561) >> 8;
+    x = ((x & UINT64_C(0x00FF00FF00FF00FF)) * 6553601) >> 16;
+    return (uint32_t) (((x & UINT64_C(0x0000FFFF0000FFFF)) *
+        UINT64_C(42949672960001)) >> 32);
+}
+
+static bool is_little_endian(void) { // (constant-folded by any compiler)
+    uint16_t const x = 1;
+    uint8_t b = 0;
+    memcpy(&b, &x, 1);
+    return b;
+}
+
+char const * skip_digits(
+    char const * c,
+    char const * const c_over,
+    uintmax_t * u
+) {
+    // A JSON integer rarely has more than 8 digits to go; and at most 2 more
+    // steps of 8 can fit in the 20 digits of UINTMAX_MAX (if 64 bits).
+    if (is_little_endian()) {
+        for (; c_over - c >= 8; c += 8) {
+            uint64_t const x = load_swar(c);
+            if (!swar_is_8_digits(x)) {
+                break;
+            }
+            uintmax_t const digits = swar_parse_8_digits(x);
+            *u = *u > (UINTMAX_MAX - digits) / 100000000 ?
+                UINTMAX_MAX : 100000000 * *u + digits;
+        }
+    }
+    for (; c < c_over && *c >= '0' && *c <= '9'; c++) {
+        unsigned const d = *c - '0';
+        *u = *u > (UINTMAX_MAX - d) / 10 ? UINTMAX_MAX : 10 * *u + d;
+    }
+    return c;
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h"
+
+// See the tape DOM description in jgrandson_internal.h.
+
+static jg_ret reserve_entries(
+    jg_t * jg,
+    size_t entry_c
+) {
+    if (jg->tape_size - jg->tape_c >= entry_c) {
+        return JG_OK;
+    }
+    size_t tape_size = jg->tape_size ? 2 * jg->tape_size : 256;
+    while (tape_size - jg->tape_c < entry_c) {
+        tape_size *= 2;
+    }
+    uint64_t * tape = realloc(jg->tape, tape_size * sizeof(uint64_t));
+    if (!tape) {
+        return JG_E_REALLOC;
+    }
+    jg->tape = tape;
+    jg->tape_size = tape_size;
+    return JG_OK;
+}
+
+jg_ret tape_push_value(
+    jg_t * jg,
+    struct jg_val_in const * v
+) {
+    size_t aux = 0;
+    switch (v->type) {
+    case JG_TYPE_BOOL:
+        aux = v->bool_is_true;
+        break;
+    case JG_TYPE_NUM:
+    case JG_TYPE_STR:
+        if (v->byte_c > JG_TAPE_AUX_MAX) {
+            // The parse functions' char pointer is &jg->json_cur, so this
+            // points the error context at the start of the offending value.
+            jg->json_cur = v->json;
+            return JG_E_PARSE_TAPE_LIMIT;
+        }
+        aux = v->byte_c;
+        break;
+    default:
+        break;
+    }
+    JG_GUARD(reserve_entries(jg, 1));
+    // parse_root() already made sure that every offset fits in 32 bits.
+    jg->tape[jg->tape_c++] = JG_TAPE_ENTRY(v->type, aux,
+        v->json - jg->json_callertext);
+    return JG_OK;
+}
+
+jg_ret tape_push_container(
+    jg_t * jg,
+    size_t * tape_i
+) {
+    JG_GUARD(reserve_entries(jg, 2));
+    *tape_i = jg->tape_c;
+    jg->tape_c += 2;
+    return JG_OK;
+}
+
+jg_ret tape_set_container(
+    jg_t * jg,
+    size_t tape_i,
+    enum jg_type type,
+    char const * json,
+    size_t c
+) {
+    if (c > JG_TAPE_AUX_MAX) {
+        jg->json_cur = json; // See the corresponding comment above
+        return JG_E_PARSE_TAPE_LIMIT;
+    }
+    jg->tape[tape_i] = JG_TAPE_ENTRY(type, c, json - jg->json_callertext);
+    jg->tape[tape_i + 1] = jg->tape_c - tape_i;
+    return JG_OK;
+}
+
+jg_ret tape_append(
+    jg_t * jg,
+    uint64_t const * entries,
+    size_t entry_c
+) {
+    JG_GUARD(reserve_entries(jg, entry_c));
+    memcpy(jg->tape + jg->tape_c, entries, entry_c * sizeof(uint64_t));
+    jg->tape_c += entry_c;
+    return JG_OK;
+}
+
+void tape_get_val(
+    jg_t * jg,
+    uint64_t const * entry,
+    struct jg_val_in * v
+) {
+    v->type = JG_TAPE_TYPE(*entry);
+    switch (v->type) {
+    case JG_TYPE_ARR:
+        v->arr = (struct jg_arr *) entry;
+        return;
+    case JG_TYPE_OBJ:
+        v->obj = (struct jg_obj *) entry;
+        return;
+    case JG_TYPE_BOOL:
+        v->bool_is_true = JG_TAPE_AUX(*entry);
+        break;
+    default:
+        v->byte_c = JG_TAPE_AUX(*entry);
+    }
+    v->json = jg->json_callertext + JG_TAPE_OFFSET(*entry);
+}
+
+char const * tape_get_json(
+    jg_t * jg,
+    uint64_t const * entry
+) {
+    return jg->json_callertext + JG_TAPE_OFFSET(*entry);
+}
+
+uint64_t const * tape_get_next(
+    uint64_t const * entry
+) {
+    switch (JG_TAPE_TYPE(*entry)) {
+    case JG_TYPE_ARR:
+    case JG_TYPE_OBJ:
+        return entry + entry[1];
+    default:
+        return entry + 1;
+    }
+}
+
+uint64_t const * tape_get_elem(
+    jg_t * jg,
+    uint64_t const * arr,
+    size_t arr_i
+) {
+    size_t elem_c = JG_TAPE_AUX(*arr);
+    if (arr[1] == elem_c + 2) {
+        return arr + 2 + arr_i; // All elements are 1 entry wide: index directly
+    }
+    struct jg_tape_cursor * cursor = jg->tape_cursors +
+        (((uintptr_t) arr / sizeof(uint64_t)) & (JG_TAPE_CURSOR_C - 1));
+    if (cursor->arr != arr || cursor->elem_i > arr_i) {
+        cursor->arr = arr;
+        cursor->elem = arr + 2;
+        cursor->elem_i = 0;
+    }
+    while (cursor->elem_i < arr_i) {
+        cursor->elem = tape_get_next(cursor->elem);
+        cursor->elem_i++;
+    }
+    return cursor->elem;
+}
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#define _POSIX_C_SOURCE 201112L // sysconf(), sched_yield()
+
+#include "jgrandson_internal.h"
+
+#ifndef JG_SINGLE_THREADED
+#include <sched.h> // sched_yield()
+#include <unistd.h> // sysconf()
+#endif
+
+// On Windows, Jgrandson never starts threads of its own, so all of the lock
+// functions below do nothing there.
+
+jg_ret init_lock(
+    jg_t * jg,
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) jg;
+    (void) lock;
+#else
+    int e = pthread_mutex_init(&lock->mutex, NULL);
+    if (e) {
+        jg->err_val.errn = e;
+        return jg->ret = JG_E_ERRNO_THREAD;
+    }
+    e = pthread_cond_init(&lock->cond, NULL);
+    if (e) {
+        pthread_mutex_destroy(&lock->mutex);
+        jg->err_val.errn = e;
+        return jg->ret = JG_E_ERRNO_THREAD;
+    }
+#endif
+    return JG_OK;
+}
+
+void free_lock(
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) lock;
+#else
+    pthread_cond_destroy(&lock->cond);
+    pthread_mutex_destroy(&lock->mutex);
+#endif
+}
+
+void acquire_lock(
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) lock;
+#else
+    pthread_mutex_lock(&lock->mutex);
+#endif
+}
+
+void release_lock(
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) lock;
+#else
+    pthread_mutex_unlock(&lock->mutex);
+#endif
+}
+
+void wait_for_lock_signal(
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) lock;
+#else
+    pthread_cond_wait(&lock->cond, &lock->mutex);
+#endif
+}
+
+void signal_lock(
+    struct jg_lock * lock
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) lock;
+#else
+    pthread_cond_broadcast(&lock->cond);
+#endif
+}
+
+size_t get_thread_c(
+    size_t thread_c
+) {
+#ifdef JG_SINGLE_THREADED
+    (void) thread_c;
+    return 1;
+#else
+    if (thread_c) {
+        return thread_c;
+    }
+    long cpu_c = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpu_c > 0 ? (size_t) cpu_c : 1;
+#endif
+}
+
+void run_threads(
+    size_t thread_c,
+    void * (* run)(void *),
+    void * args,
+    size_t arg_byte_c
+) {
+#ifndef JG_SINGLE_THREADED
+    // If (some) threads can't be created, the threads that do run simply have
+    // more work left to claim for themselves.
+    pthread_t * threads = NULL;
+    bool * is_started = NULL;
+    if (thread_c > 1) {
+        threads = malloc((thread_c - 1) * sizeof(pthread_t));
+        is_started = calloc(thread_c - 1, sizeof(bool));
+    }
+    if (threads && is_started) {
+        for (size_t i = 1; i < thread_c; i++) {
+            is_started[i - 1] = !pthread_create(threads + i - 1, NULL, run,
+                (char *) args + i * arg_byte_c);
+        }
+    }
+#else
+    (void) thread_c;
+    (void) arg_byte_c;
+#endif
+    run(args); // The calling thread runs with the 1st arg.
+#ifndef JG_SINGLE_THREADED
+    if (threads && is_started) {
+        for (size_t i = 1; i < thread_c; i++) {
+            if (is_started[i - 1]) {
+                pthread_join(threads[i - 1], NULL);
+            }
+        }
+    }
+    free(threads);
+    free(is_started);
+#endif
+}
+
+// On Windows, frozen documents and their slots aren't shared across threads
+// (see jgrandson.h), so plain integers do there.
+
+void init_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+) {
+#ifdef JG_SINGLE_THREADED
+    atomic->val = val;
+#else
+    atomic_init(&atomic->val, val);
+#endif
+}
+
+uintptr_t load_atomic(
+    struct jg_atomic * atomic
+) {
+#ifdef JG_SINGLE_THREADED
+    return atomic->val;
+#else
+    return atomic_load(&atomic->val);
+#endif
+}
+
+void store_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+) {
+#ifdef JG_SINGLE_THREADED
+    atomic->val = val;
+#else
+    atomic_store(&atomic->val, val);
+#endif
+}
+
+uintptr_t exchange_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+) {
+#ifdef JG_SINGLE_THREADED
+    uintptr_t old_val = atomic->val;
+    atomic->val = val;
+    return old_val;
+#else
+    return atomic_exchange(&atomic->val, val);
+#endif
+}
+
+uintptr_t add_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+) {
+#ifdef JG_SINGLE_THREADED
+    atomic->val += val;
+    return atomic->val - val;
+#else
+    return atomic_fetch_add(&atomic->val, val);
+#endif
+}
+
+uintptr_t sub_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+) {
+#ifdef JG_SINGLE_THREADED
+    atomic->val -= val;
+    return atomic->val + val;
+#else
+    return atomic_fetch_sub(&atomic->val, val);
+#endif
+}
+
+void yield_thread(
+    void
+) {
+#ifndef JG_SINGLE_THREADED
+    sched_yield();
+#endif
+}
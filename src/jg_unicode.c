@@ -24,6 +24,50 @@ size_t get_utf8_char_size(
     return ++u == u_over || !is_utf8_continuation_byte(*u) ? 3 : 4;
 }
 
+// Returns the size of the UTF-8 char at u, or 0 if it is not a valid UTF-8 char
+// according to the well-formed byte sequence table of the Unicode Standard:
+// overlong encodings, surrogates, and code points above U+10FFFF are invalid.
+size_t get_valid_utf8_char_size(
+    uint8_t const * u,
+    uint8_t const * const u_over
+) {
+    if (*u < 0x80) {
+        return 1;
+    }
+    size_t char_size = 0;
+    uint8_t second_min = 0x80; // The range of the 2nd byte depends on the 1st.
+    uint8_t second_max = 0xBF;
+    if (*u >= 0xC2 && *u <= 0xDF) {
+        char_size = 2;
+    } else if (*u >= 0xE0 && *u <= 0xEF) {
+        char_size = 3;
+        if (*u == 0xE0) {
+            second_min = 0xA0; // Overlong below U+0800
+        } else if (*u == 0xED) {
+            second_max = 0x9F; // Surrogates U+D800 through U+DFFF
+        }
+    } else if (*u >= 0xF0 && *u <= 0xF4) {
+        char_size = 4;
+        if (*u == 0xF0) {
+            second_min = 0x90; // Overlong below U+10000
+        } else if (*u == 0xF4) {
+            second_max = 0x8F; // Above U+10FFFF
+        }
+    } else {
+        return 0; // Continuation byte, overlong 0xC0/0xC1, or 0xF5 and above
+    }
+    if ((size_t) (u_over - u) < char_size ||
+        u[1] < second_min || u[1] > second_max) {
+        return 0;
+    }
+    for (size_t i = 2; i < char_size; i++) {
+        if (!is_utf8_continuation_byte(u[i])) {
+            return 0;
+        }
+    }
+    return char_size;
+}
+
 static uint32_t utf16hex_substr_to_codepoint( // E.g., "5F6A" to 0x5F6A
     uint8_t const * u // an already validated JSON substring
 ) {
@@ -105,6 +149,17 @@ size_t get_codepoint_c(
     return codepoint_c;
 }
 
+size_t get_unesc_codepoint_c(
+    uint8_t const * const unesc_str,
+    size_t unesc_byte_c
+) {
+    size_t codepoint_c = 0;
+    for (uint8_t const * u = unesc_str; u < unesc_str + unesc_byte_c; u++) {
+        codepoint_c += !is_utf8_continuation_byte(*u);
+    }
+    return codepoint_c;
+}
+
 void json_str_to_unesc_str(
     uint8_t const * const json_str, // an already validated JSON string
     size_t json_byte_c,
@@ -222,18 +277,23 @@ jg_ret json_strings_are_equal(
         *strings_are_equal = false;
         return JG_OK;
     }
-    // Using malloc() here is arguably an ugly and slow solution compared to
-    // doing an in-place codepoint comparison, but that would involve writing
-    // significantly more code for this cold branch. Maybe some other time.
-    uint8_t * str_pair = malloc(2 * unesc_byte_c);
-    if (!str_pair) {
-        return JG_E_MALLOC;
+    // Unescape both strings to compare them. This only needs malloc() for
+    // strings too long to unescape on the stack, which keys rarely are.
+    uint8_t stack_buf[256];
+    uint8_t * str_pair = stack_buf;
+    if (2 * unesc_byte_c > sizeof(stack_buf)) {
+        str_pair = malloc(2 * unesc_byte_c);
+        if (!str_pair) {
+            return JG_E_MALLOC;
+        }
     }
     json_str_to_unesc_str(j1_str, j1_byte_c, str_pair);
     json_str_to_unesc_str(j2_str, j2_byte_c, str_pair + unesc_byte_c);
-    *strings_are_equal = !strncmp((char const *) str_pair,
-        (char const *) (str_pair + unesc_byte_c), unesc_byte_c);
-    free(str_pair);
+    *strings_are_equal = !memcmp(str_pair, str_pair + unesc_byte_c,
+        unesc_byte_c);
+    if (str_pair != stack_buf) {
+        free(str_pair);
+    }
     return JG_OK;
 }
 
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#define _POSIX_C_SOURCE 201112L // read(), close()
+
+#include "jgrandson_internal.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+struct jg_watch {
+    char * filepath;
+    jg_doc_slot_t * slot; // Holds the document parsed from the file last
+    uint64_t hash; // Of the file contents that document was parsed from
+    bool is_hashed; // False until the first document is published
+#ifdef __linux__
+    char const * filename; // The part of .filepath after its last slash
+    int inotify_fd; // -1 if not (yet) initialized
+    int dir_wd; // The directory's watch descriptor
+#endif
+};
+
+#ifdef __linux__
+// Watch the file's directory rather than just the file itself: editors and
+// deployment tools tend to replace a file by renaming a new one over it (or by
+// swapping a symlink to it), after which a watch on the old file sees nothing.
+static jg_ret watch_dir(
+    jg_t * jg,
+    jg_watch_t * watch
+) {
+    watch->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->inotify_fd == -1) {
+        jg->err_val.errn = errno;
+        return jg->ret = JG_E_ERRNO_INOTIFY;
+    }
+    char const * slash = strrchr(watch->filepath, '/');
+    watch->filename = slash ? slash + 1 : watch->filepath;
+    char * dir = NULL;
+    JG_GUARD(alloc_strcpy(jg, &dir, slash ? watch->filepath : ".",
+        !slash ? 1 : slash == watch->filepath ? 1 :
+        (size_t) (slash - watch->filepath)));
+    watch->dir_wd = inotify_add_watch(watch->inotify_fd, dir,
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    int errn = errno;
+    free(dir);
+    if (watch->dir_wd == -1) {
+        jg->err_val.errn = errn;
+        return jg->ret = JG_E_ERRNO_INOTIFY;
+    }
+    return JG_OK;
+}
+
+// Also watch the file itself (or whichever file a symlink to it points to),
+// which catches in-place writes to a file that lives in another directory. The
+// watch stays with the file even if it gets replaced, so it is renewed after
+// every change; and if the file doesn't exist right now, the directory watch
+// has it covered.
+static void watch_file(
+    jg_watch_t * watch
+) {
+    inotify_add_watch(watch->inotify_fd, watch->filepath, IN_CLOSE_WRITE);
+}
+
+// Whether the event may concern the file: events from the directory watch
+// only do if they name the file (rather than, say, the temporary file an editor
+// writes before renaming it over the file). A watch removed because its file
+// was deleted or replaced is of no concern either: whatever replaces the file
+// raises its own event.
+static bool is_relevant_event(
+    jg_watch_t const * watch,
+    struct inotify_event const * ev
+) {
+    if (ev->mask & IN_Q_OVERFLOW) {
+        return true; // Events were lost, so any of them may have been relevant.
+    }
+    if (ev->mask & IN_IGNORED) {
+        return false;
+    }
+    return ev->wd != watch->dir_wd || (ev->len &&
+        !strcmp(ev->name, watch->filename));
+}
+
+// Read all pending inotify events, and return whether any of them prompts the
+// file's hash to be checked.
+static bool has_events(
+    jg_watch_t * watch
+) {
+    _Alignas(struct inotify_event) char buf[4096];
+    bool is_relevant = false;
+    ssize_t byte_c = 0;
+    while ((byte_c = read(watch->inotify_fd, buf, sizeof(buf))) > 0) {
+        for (char const * ev = buf; ev < buf + byte_c; ev +=
+            sizeof(struct inotify_event) +
+            ((struct inotify_event const *) ev)->len) {
+            is_relevant |= is_relevant_event(watch,
+                (struct inotify_event const *) ev);
+        }
+    }
+    // Any error other than the lack of events is taken to mean there may be.
+    return is_relevant || (byte_c == -1 && errno != EAGAIN);
+}
+#endif
+
+// Parse the file and publish it as a new document, unless its contents hash
+// the same as those of the document published last.
+static jg_ret publish_if_changed(
+    jg_t * jg,
+    jg_watch_t * watch,
+    bool * is_updated
+) {
+    uint64_t hash = 0;
+    bool is_parsed = false;
+    JG_GUARD(parse_file_if_changed(jg, watch->filepath,
+        watch->is_hashed ? &watch->hash : NULL, &hash, &is_parsed));
+    if (!is_parsed) {
+        return JG_OK;
+    }
+    jg_doc_t * doc = NULL;
+    JG_GUARD(jg_freeze(jg, &doc));
+    jg_doc_slot_publish(watch->slot, doc);
+    // Only now, such that contents that fail to parse are retried if they
+    // change, while reverting to the contents published last is a no-op.
+    watch->hash = hash;
+    watch->is_hashed = true;
+    *is_updated = true;
+    return JG_OK;
+}
+
+static jg_ret init_watch(
+    jg_t * jg,
+    char const * filepath,
+    jg_watch_t * watch
+) {
+    JG_GUARD(alloc_strcpy(jg, &watch->filepath, filepath, strlen(filepath)));
+    watch->slot = jg_doc_slot_init();
+    if (!watch->slot) {
+        return jg->ret = JG_E_MALLOC;
+    }
+#ifdef __linux__
+    // Before the file is read, such that no change can slip in between
+    JG_GUARD(watch_dir(jg, watch));
+    watch_file(watch);
+#endif
+    bool is_updated = false;
+    return publish_if_changed(jg, watch, &is_updated);
+}
+
+jg_ret jg_watch_init(
+    jg_t * jg,
+    char const * filepath,
+    jg_watch_t * * watch
+) {
+    *watch = calloc(1, sizeof(struct jg_watch));
+    if (!*watch) {
+        return jg->ret = JG_E_CALLOC;
+    }
+#ifdef __linux__
+    (*watch)->inotify_fd = -1;
+    (*watch)->dir_wd = -1;
+#endif
+    jg_ret ret = init_watch(jg, filepath, *watch);
+    if (ret != JG_OK) {
+        jg_watch_free(*watch);
+        *watch = NULL;
+    }
+    return jg->ret = ret;
+}
+
+void jg_watch_free(
+    jg_watch_t * watch
+) {
+    if (watch->slot) {
+        jg_doc_slot_free(watch->slot);
+    }
+#ifdef __linux__
+    if (watch->inotify_fd != -1) {
+        close(watch->inotify_fd);
+    }
+#endif
+    free(watch->filepath);
+    free(watch);
+}
+
+jg_ret jg_watch_update(
+    jg_t * jg,
+    jg_watch_t * watch,
+    bool * is_updated
+) {
+    *is_updated = false;
+    jg_reinit(jg); // Discard the outcome of the previous update.
+#ifdef __linux__
+    if (!has_events(watch)) {
+        return jg->ret = JG_OK;
+    }
+    watch_file(watch);
+#endif
+    return jg->ret = publish_if_changed(jg, watch, is_updated);
+}
+
+jg_doc_t * jg_watch_get_doc(
+    jg_watch_t * watch
+) {
+    return jg_doc_slot_get(watch->slot);
+}
+
+int jg_watch_get_fd(
+    jg_watch_t * watch
+) {
+#ifdef __linux__
+    return watch->inotify_fd;
+#else
+    (void) watch;
+    return -1;
+#endif
+}
@@ -38,11 +38,12 @@ extern "C" {
 #define JG_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define JG_MAX(a, b) ((a) > (b) ? (a) : (b))
 
-// Enforce an opaque pointer API for the following 5 types by keeping
+// Enforce an opaque pointer API for the following 6 types by keeping
 // struct definitions private (jgrandson_internal.h).
 typedef struct jgrandson jg_t;
 typedef struct jg_arr const jg_arr_get_t;
 typedef struct jg_obj const jg_obj_get_t;
+typedef struct jg_val_in const jg_val_get_t;
 typedef struct jg_val_out jg_arr_set_t;
 typedef struct jg_val_out jg_obj_set_t;
 
@@ -133,7 +134,15 @@ typedef enum {
     JG_E_GET_NUM_NOT_FLO = 71,
     JG_E_GET_NUM_FLOAT_OUT_OF_RANGE = 72,
     JG_E_GET_NUM_DOUBLE_OUT_OF_RANGE = 73,
-    JG_E_GET_NUM_LONG_DOUBLE_OUT_OF_RANGE = 74
+    JG_E_GET_NUM_LONG_DOUBLE_OUT_OF_RANGE = 74,
+    JG_E_PARSE_TAPE_LIMIT = 75,
+    JG_E_PARSE_MAX_DEPTH = 76,
+    JG_E_ERRNO_FSTAT = 77,
+    JG_E_ERRNO_MMAP = 78,
+    JG_E_ERRNO_THREAD = 79,
+    JG_E_ERRNO_INOTIFY = 80,
+    JG_E_IMAGE_NOT_TAPE = 81,
+    JG_E_IMAGE_INVALID = 82
 } jg_ret;
 
 #define JG_GUARD(func_call) do { \
@@ -180,6 +189,72 @@ char const * jg_get_err_str(
 //##############################################################################
 //## jg_parse_...() prototypes (jg_parse.c) ####################################
 
+struct jg_opt_parse {
+    // If true, store the parsed DOM as one contiguous "tape" of 8-byte entries
+    // instead of as a tree of separately allocated arrays and objects. This
+    // takes less memory and is more cache-friendly to traverse; but limits the
+    // JSON text to 4 GiB, and strings, numbers, arrays, and objects to 2^29 - 1
+    // bytes/elements/pairs each. All getters work the same either way.
+    bool tape; // Default: false
+
+    // The maximum nesting depth of arrays and objects (e.g., "[[]]" is 2 deep)
+    // beyond which parsing fails with JG_E_PARSE_MAX_DEPTH. Parsing does not
+    // recurse regardless, so this only serves to limit untrusted input.
+    size_t max_depth; // Default: 0 (no limit)
+
+    // If true, skip checking that the keys of each object are unique, which
+    // only makes sense for JSON text from a trusted producer. Should an object
+    // contain duplicate keys nonetheless, getters return its first such pair.
+    // Otherwise, parsing fails with JG_E_PARSE_OBJ_DUPLICATE_KEY. (Objects with
+    // many keys are checked with a hash index, which getters then reuse.)
+    bool trust_unique_keys; // Default: false
+
+    // If greater than 1, a root array of a large JSON text is parsed by up to
+    // this many threads, each taking its turn at the next chunk of elements.
+    // The result (or error) is the same as when parsing with a single thread.
+    // Not applicable to jg_parse_feed() or NDJSON records. (Not on Windows.)
+    size_t thread_c; // Default: 0 (parse in the calling thread only)
+
+    // If true, parsing only validates the JSON text (and notes where its large
+    // arrays and objects end) without storing any of the values nested within
+    // the root. Instead, each array and object gets parsed once a getter first
+    // gets it, which makes getting a few values out of a large JSON text much
+    // quicker. Not applicable to .tape or jg_parse_feed(); and .thread_c is
+    // ignored if true.
+    bool lazy; // Default: false
+
+    // jg_reinit() keeps the buffers of the previous parse (its arena, stacks,
+    // indexes, and copy of the JSON text) so that the next parse can reuse them
+    // without having to malloc() anything. If nonzero, any such buffers beyond
+    // this many bytes in total are free()d instead.
+    size_t max_retained_byte_c; // Default: 0 (no limit)
+
+    // If true, parsing also decodes each number, so that getters of integer
+    // types and jg_[root|arr|obj]_get_double() only need to check its range
+    // instead of converting its JSON text. This costs 32 bytes per number.
+    // Not applicable to .tape.
+    bool decode_numbers; // Default: false
+
+    // If true, jg_parse_str() and jg_parse_file() unescape every string value
+    // in place within their copy of the JSON text once parsing succeeds, such
+    // that getters of unescaped strings only need to copy (or view) them. The
+    // jg_[root|arr|obj]_get_json_[caller]str() getters escape them anew in
+    // turn, escaping only the chars that must be (e.g., "\/" becomes "/"); and
+    // the error strings of getters quote the JSON text as modified. Keys are
+    // left as they are. Not applicable to other jg_parse_...() functions.
+    bool unescape_in_place; // Default: false
+};
+
+typedef struct jg_opt_parse jg_opt_parse;
+
+// Set the options for subsequent jg_parse_...() calls (NULL restores defaults).
+// Like jg_parse_...(), this can only be called when Jgrandson is in its initial
+// state. Options remain in effect after jg_reinit().
+jg_ret jg_parse_set_opt(
+    jg_t * jg,
+    jg_opt_parse const * opt
+);
+
 // Copy the JSON text string to a malloc-ed char buffer, then parse.
 jg_ret jg_parse_str(
     jg_t * jg,
@@ -200,11 +275,327 @@ jg_ret jg_parse_file(
     char const * filepath
 );
 
+// Map the file into memory read-only, then parse the mapping as-is (i.e., the
+// JSON text is never copied). The file remains mapped until jg_reinit() or
+// jg_free(), and must not be truncated by anyone in the meantime. Only works
+// for regular files. (On Windows, this currently just calls jg_parse_file().)
+jg_ret jg_parse_file_mmap(
+    jg_t * jg,
+    char const * filepath
+);
+
+// Incrementally parse JSON text that arrives in chunks (e.g., from a socket):
+// call jg_parse_begin(), then jg_parse_feed() for each chunk, then
+// jg_parse_end(). Chunks are copied to a buffer of Jgrandson's own, and each
+// jg_parse_feed() parses as much as it can, so that any error is reported as
+// soon as possible; but nothing can be gotten until jg_parse_end() succeeds.
+// A byte_c_hint of the total JSON text size (if known) avoids buffer regrowth.
+jg_ret jg_parse_begin(
+    jg_t * jg,
+    size_t byte_c_hint // 0 if unknown
+);
+
+jg_ret jg_parse_feed(
+    jg_t * jg,
+    char const * chunk, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+);
+
+jg_ret jg_parse_end(
+    jg_t * jg
+);
+
+// Parse NDJSON (a.k.a. JSON Lines) text, in which each line is a JSON text of
+// its own: a "record". After one of these 3 functions, each call to
+// jg_parse_ndjson_next() parses the next record, which can then be gotten with
+// the jg_root_get_...() etc. getters as usual, until the call after that. The
+// memory used by each record is reused for the next one. If a record fails to
+// parse, its error string contains its line number within the NDJSON text; and
+// calling jg_parse_ndjson_next() again simply skips to the next record.
+// Lines containing only whitespace are skipped. Call jg_reinit() or jg_free()
+// when done.
+jg_ret jg_parse_ndjson_str( // NDJSON text is copied to a malloc-ed buffer
+    jg_t * jg,
+    char const * ndjson_text, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+);
+
+jg_ret jg_parse_ndjson_callerstr( // NDJSON text is used as-is (i.e., no copy)
+    jg_t * jg,
+    char const * ndjson_text, // null-terminator not required
+    size_t byte_c // excluding null-terminator
+);
+
+jg_ret jg_parse_ndjson_file( // NDJSON file is mmap()ed like jg_parse_file_mmap
+    jg_t * jg,
+    char const * filepath
+);
+
+// Sets *line_i to the line number of the record parsed, or to 0 if none remain.
+jg_ret jg_parse_ndjson_next(
+    jg_t * jg,
+    size_t * line_i
+);
+
+// Called by jg_parse_ndjson_parallel() for each record. If ret is JG_OK, the
+// record can be gotten from jg with the getters as usual until the callback
+// returns; otherwise jg_get_err_str(jg, ...) describes the record's parse
+// error. This jg belongs to the thread: it must not be jg_free()d or reinited.
+// Return false to stop jg_parse_ndjson_parallel() from parsing any more (but in
+// unordered mode, other threads finish the batches of lines they have claimed).
+typedef bool (* jg_ndjson_cb)(
+    jg_t * jg,
+    size_t line_i, // The record's line number
+    jg_ret ret,
+    void * cb_arg
+);
+
+struct jg_opt_ndjson {
+    // The number of threads to parse records with (including the calling
+    // thread). If 0, the number of online CPU cores is used.
+    // Default: 0
+    size_t thread_c;
+    // If true, the callback is called for one record at a time in line order
+    // (albeit from any of the threads). Otherwise, each thread calls it as soon
+    // as it has parsed a record, so calls may be concurrent and out of order.
+    // Default: false
+    bool is_ordered;
+};
+
+typedef struct jg_opt_ndjson jg_opt_ndjson;
+
+// Parse all remaining records of the NDJSON text given to jg_parse_ndjson_...()
+// in parallel (each thread with a jg_t of its own, with the same parse options
+// as jg), calling cb for each of them. Records are handed out to threads in
+// batches of consecutive lines. (On Windows, the calling thread does it all.)
+// Afterwards, jg_parse_ndjson_next() finds no records remaining (unless a
+// callback stopped parsing early, in which case it continues after the lines
+// already handed out).
+jg_ret jg_parse_ndjson_parallel(
+    jg_t * jg,
+    jg_opt_ndjson const * opt, // NULL means: use defaults
+    jg_ndjson_cb cb, // Must not be NULL (else JG_E_GET_ARG_IS_NULL)
+    void * cb_arg
+);
+
 //##############################################################################
-//## jg_[root|arr|obj]_get_...() prototypes (jg_get.c) #########################
+//## jg_pool_...() prototypes (jg_pool.c) ######################################
+
+// A pool of idle jg_t sessions, which can be shared by any number of threads
+// (except on Windows, where each thread must have a pool of its own). Sessions
+// are handed out most recently used first: their buffers are then the most
+// likely to have enough capacity (and to still be in cache). The idle sessions
+// are a LIFO protected by a mutex, which jg_pool_get() and jg_pool_put() hold
+// only to pop or push a session; so threads do contend for it, but briefly.
+typedef struct jg_pool jg_pool_t;
+
+struct jg_opt_pool {
+    // The parse options of every session the pool hands out. Set
+    // .opt_parse.max_retained_byte_c to cap how much memory each idle session
+    // keeps hold of.
+    jg_opt_parse opt_parse; // Default: all defaults
+
+    // The number of idle sessions beyond which jg_pool_put() jg_free()s them
+    size_t max_idle_c; // Default: 0 (no limit)
+};
+
+typedef struct jg_opt_pool jg_opt_pool;
+
+jg_pool_t * jg_pool_init( // Returns NULL if out of memory
+    jg_opt_pool const * opt // NULL means: use defaults
+);
+
+// Free the pool and all of its idle sessions. Any sessions gotten from it that
+// were not put back remain valid, but must be jg_free()d by the caller instead.
+void jg_pool_free(
+    jg_pool_t * pool
+);
+
+// Get an idle session from the pool (or a new one if none are left), in its
+// initial state and with the pool's parse options. Returns NULL if out of
+// memory.
+jg_t * jg_pool_get(
+    jg_pool_t * pool
+);
+
+// Put a session gotten with jg_pool_get() back in the pool, in whichever state
+// it is. The pool jg_reinit()s it (with the pool's parse options), which is
+// all the clean-up needed.
+void jg_pool_put(
+    jg_pool_t * pool,
+    jg_t * jg
+);
+
+//##############################################################################
+//## jg_freeze(), jg_parse_doc(), and jg_doc_...() prototypes (jg_doc.c) #######
+
+// A parsed DOM frozen by jg_freeze() into an immutable document, which any
+// number of threads can get values from concurrently (except on Windows, where
+// documents can't be shared across threads). Each thread does so through a
+// session of its own: jg_parse_doc() turns any session in its initial state
+// into a reader of the document in O(1) time, after which the usual getters
+// work on it as if it parsed the document itself. Readers share the DOM, but
+// keep their own error state; so jg_get_err_str() etc. work as usual too.
+//
+// Documents are reference counted: jg_freeze() hands out one reference, every
+// reader holds one until it is jg_reinit() or jg_free()d, and the document is
+// freed once the last reference is released. Any caller-owned JSON text (i.e.,
+// of jg_parse_callerstr()) must outlive the document.
+typedef struct jg_doc jg_doc_t;
+
+// Freeze the DOM that jg parsed successfully into *doc. In lazy mode, whatever
+// remains unparsed is parsed first; and so are the key indexes of any large
+// objects that .trust_unique_keys or jg_load_image() left unindexed, such that
+// getters never need to modify the document. The DOM (and all memory jg
+// retained) is moved to the document rather than copied, leaving jg as if it
+// was jg_reinit() with its parse options kept, ready to parse the next
+// document.
+jg_ret jg_freeze(
+    jg_t * jg,
+    jg_doc_t * * doc
+);
+
+jg_doc_t * jg_doc_acquire( // Returns doc, with a reference added to it
+    jg_doc_t * doc
+);
+
+void jg_doc_release( // Release a reference; NULL is a no-op
+    jg_doc_t * doc
+);
+
+// Make jg (which must be in its initial state) a reader of doc until it is
+// jg_reinit() or jg_free()d. jg acquires a reference of its own.
+jg_ret jg_parse_doc(
+    jg_t * jg,
+    jg_doc_t * doc
+);
+
+// A slot through which a writer thread can publish new documents to any number
+// of reader threads, read-copy-update (RCU) style: getting the latest document
+// takes no lock (nor does reading it), so writers never block readers. Readers
+// are best off getting the latest document once per unit of work, rather than
+// per value they get.
+typedef struct jg_doc_slot jg_doc_slot_t;
+
+jg_doc_slot_t * jg_doc_slot_init( // Returns NULL if out of memory
+    void
+);
+
+// Free the slot, releasing its reference to the document published last (if
+// any). No other thread may be using the slot by then.
+void jg_doc_slot_free(
+    jg_doc_slot_t * slot
+);
+
+// Publish doc in place of the document published previously, taking over the
+// caller's reference to it. Readers that already got the previous document
+// keep it until they release it, but the slot releases its own reference
+// right away, once no reader can be in the middle of getting it anymore.
+void jg_doc_slot_publish(
+    jg_doc_slot_t * slot,
+    jg_doc_t * doc
+);
+
+// Get the document published last (or NULL if none was), with a reference
+// acquired for the caller to jg_doc_release() when done with it.
+jg_doc_t * jg_doc_slot_get(
+    jg_doc_slot_t * slot
+);
+
+//##############################################################################
+//## jg_watch_...() prototypes (jg_watch.c) ####################################
+
+// Hot-reloads a JSON (configuration) file: each time the file changes, it is
+// parsed anew, and published as a new jg_doc_t (see above). Readers get the
+// latest document with jg_watch_get_doc(), which (like getting values from it)
+// never blocks, and never sees a half-parsed DOM. Each old document is freed
+// once its last reader releases it.
+//
+// On Linux, the file (and its directory) are watched with inotify, so that
+// checking for changes costs nothing until the file is written, or created or
+// moved into place (writes to other files in its directory are ignored). Then
+// (and on other platforms, every time) the file is read, and only parsed if its
+// contents hash differently from those published last.
+typedef struct jg_watch jg_watch_t;
+
+// Parse the file with jg (with the parse options set for jg), and publish it
+// as the watch's first document.
+jg_ret jg_watch_init(
+    jg_t * jg, // Must be in its initial state
+    char const * filepath,
+    jg_watch_t * * watch
+);
+
+// Free the watch, which releases its reference to the document published last.
+// No other thread may be using the watch by then.
+void jg_watch_free(
+    jg_watch_t * watch
+);
+
+// Check whether the file changed, and if so, reparse and publish it; in which
+// case *is_updated is set to true. jg is jg_reinit() first. If the new contents
+// fail to parse, the error is returned (and jg_get_err_str(jg, ...) describes
+// it), but the document published last stays in place. Only one thread may
+// call this at a time.
+jg_ret jg_watch_update(
+    jg_t * jg,
+    jg_watch_t * watch,
+    bool * is_updated
+);
+
+// Get the document published last, with a reference acquired for the caller to
+// jg_doc_release() when done with it. Any number of threads can call this.
+jg_doc_t * jg_watch_get_doc(
+    jg_watch_t * watch
+);
+
+// The inotify file descriptor, which becomes readable once jg_watch_update()
+// has something to check: poll() or epoll_wait() on it to update only then. On
+// other platforms, -1 is returned, and jg_watch_update() is to be polled.
+int jg_watch_get_fd(
+    jg_watch_t * watch
+);
+
+//##############################################################################
+//## jg_save_image() and jg_load_image() prototypes (jg_image.c) ###############
+
+// An image is a file holding a DOM parsed in tape mode (see .tape above) in a
+// form that can be read as-is: its JSON text with all string values already
+// unescaped (as if by .unescape_in_place), followed by its tape. Loading an
+// image merely maps it into memory, which takes O(1) time regardless of its
+// size; pages are then read in as getters touch them. Processes that load the
+// same image share its pages through the page cache.
+//
+// Loading only checks that an image's trailer and root value lie within the
+// file, not the rest of the DOM: so a truncated image (or another file) is
+// rejected, but images are to come from a trusted source, such as a build step
+// of the same application.
+// They are specific to the byte order of the platform they were saved on.
+
+// Save the DOM that jg parsed successfully with .tape enabled. jg stays in its
+// getter state, so this can be done right after parsing.
+jg_ret jg_save_image(
+    jg_t * jg,
+    char const * filepath
+);
+
+// Load an image into jg (which must be in its initial state), after which the
+// usual getters work on it until jg is jg_reinit() or jg_free()d (which unmaps
+// it). On Windows, the image is read into a heap buffer instead.
+jg_ret jg_load_image(
+    jg_t * jg,
+    char const * filepath
+);
+
+//##############################################################################
+//## jg_[root|arr|obj|val]_get_...() prototypes (jg_get.c) #####################
+
+// The jg_val_get_...() getters get the value of an object's pair by its
+// jg_val_get_t handle, as handed out by jg_obj_iter_[begin|next]() (see the
+// bottom of this section), rather than by its key.
 
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_json_type() ///////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_json_type() ///////////////////////////////////////
 
 jg_ret jg_root_get_json_type(
     jg_t * jg,
@@ -225,8 +616,14 @@ jg_ret jg_obj_get_json_type(
     enum jg_type * type
 );
 
+jg_ret jg_val_get_json_type(
+    jg_t * jg,
+    jg_val_get_t * val,
+    enum jg_type * type
+);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_bool() ////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_bool() ////////////////////////////////////////////
 
 jg_ret jg_root_get_bool(
     jg_t * jg,
@@ -249,8 +646,14 @@ jg_ret jg_obj_get_bool(
     bool * v
 );
 
+jg_ret jg_val_get_bool(
+    jg_t * jg,
+    jg_val_get_t * val,
+    bool * v
+);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_null() ////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_null() ////////////////////////////////////////////
 
 // Having a "v" parameter would be pointless in the case of ..._get_null().
 jg_ret jg_root_get_null(
@@ -269,8 +672,13 @@ jg_ret jg_obj_get_null(
     char const * key
 );
 
+jg_ret jg_val_get_null(
+    jg_t * jg,
+    jg_val_get_t * val
+);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_arr() /////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_arr() /////////////////////////////////////////////
 
 struct jg_opt_arr {
     char const * min_c_reason;
@@ -322,8 +730,17 @@ jg_ret jg_obj_get_arr_defa(
     size_t * elem_c
 );
 
+typedef struct jg_opt_arr jg_val_arr;
+jg_ret jg_val_get_arr(
+    jg_t * jg,
+    jg_val_get_t * val,
+    jg_val_arr * opt,
+    jg_arr_get_t * * v,
+    size_t * elem_c
+);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_obj() /////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_obj() /////////////////////////////////////////////
 
 // All remaining getters have the same form of protottpe. Use of the following
 // macros macros reduces the size of this header by a few hundred lines.
@@ -353,6 +770,14 @@ jg_ret jg_obj_get##_suf( \
     _type * v \
 )
 
+#define JG_VAL_GET(_suf, _type) \
+jg_ret jg_val_get##_suf( \
+    jg_t * jg, \
+    jg_val_get_t * val, \
+    jg_val##_suf * opt, \
+    _type * v \
+)
+
 struct jg_opt_obj {
     char * * * keys;
     size_t * key_c;
@@ -381,8 +806,11 @@ JG_OBJ_GET(_obj, jg_obj_get_t *);
 typedef struct jg_opt_obj_defa jg_obj_obj_defa;
 JG_OBJ_GET(_obj_defa, jg_obj_get_t *);
 
+typedef struct jg_opt_obj jg_val_obj;
+JG_VAL_GET(_obj, jg_obj_get_t *);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_(json)_(caller)str() //////////////////////////////////
+// jg_[root|arr|obj|val]_get_(json)_(caller)str() //////////////////////////////
 
 // These getters come in 2 * 2 = 4 forms:
 // 
@@ -473,8 +901,68 @@ JG_OBJ_GET(_json_str, char *);
 typedef struct jg_opt_obj_str jg_obj_json_callerstr;
 JG_OBJ_GET(_json_callerstr, char);
 
+
+typedef struct jg_opt_str jg_val_str;
+JG_VAL_GET(_str, char *);
+
+typedef struct jg_opt_str jg_val_callerstr;
+JG_VAL_GET(_callerstr, char);
+
+typedef struct jg_opt_str jg_val_json_str;
+JG_VAL_GET(_json_str, char *);
+
+typedef struct jg_opt_str jg_val_json_callerstr;
+JG_VAL_GET(_json_callerstr, char);
+
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_<integer_type>() //////////////////////////////////////
+// jg_[root|arr|obj|val]_get_strview() /////////////////////////////////////////
+
+// Like jg_[root|arr|obj]_get_str(), except that rather than a malloc()ed copy,
+// "v" is a view of the unescaped string: if the JSON string contains no escape
+// sequences, "v.str" points into the JSON text itself; otherwise it points to
+// the string as unescaped into memory owned by jg (which each such call on an
+// escaped string allocates anew). Either way, "v.str" is NOT null-terminated,
+// and remains valid until jg is reinitialized or freed (or, with
+// jg_parse_callerstr(), until the caller's JSON text is freed; if sooner).
+//
+// The .omit_null_terminator option has no effect on these getters.
+
+struct jg_strview {
+    char const * str; // NOT null-terminated
+    size_t byte_c;
+};
+
+typedef struct jg_strview jg_strview;
+
+typedef struct jg_opt_str jg_root_strview;
+JG_ROOT_GET(_strview, jg_strview);
+
+typedef struct jg_opt_str jg_arr_strview;
+JG_ARR_GET(_strview, jg_strview);
+
+typedef struct jg_opt_obj_str jg_obj_strview;
+JG_OBJ_GET(_strview, jg_strview);
+
+typedef struct jg_opt_str jg_val_strview;
+JG_VAL_GET(_strview, jg_strview);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_[root|arr|obj|val]_get_<integer_type>() //////////////////////////////////
+
+// Each jg_arr_get_<integer_type>_array() getter gets *elem_c consecutive
+// elements starting at index arr_i in one go, as if by that many calls to the
+// corresponding jg_arr_get_<integer_type>() getter with the same opt; except
+// that if any element fails to be gotten, *elem_c is set to the number of
+// elements that were (i.e., the failing one has index arr_i + *elem_c).
+#define JG_ARR_GET_ARRAY(_suf, _type) \
+jg_ret jg_arr_get##_suf##_array( \
+    jg_t * jg, \
+    jg_arr_get_t * arr, \
+    size_t arr_i, \
+    jg_arr##_suf * opt, \
+    _type * v, \
+    size_t * elem_c \
+)
 
 #define JG_GET_INT(_suf, _type) \
 struct jg_opt##_suf { \
@@ -497,9 +985,13 @@ JG_ROOT_GET(_suf, _type); \
 \
 typedef struct jg_opt##_suf jg_arr##_suf; \
 JG_ARR_GET(_suf, _type); \
+JG_ARR_GET_ARRAY(_suf, _type); \
 \
 typedef struct jg_opt_obj##_suf jg_obj##_suf; \
-JG_OBJ_GET(_suf, _type)
+JG_OBJ_GET(_suf, _type); \
+\
+typedef struct jg_opt##_suf jg_val##_suf; \
+JG_VAL_GET(_suf, _type)
 
 JG_GET_INT(_int8, int8_t);
 JG_GET_INT(_char, char);
@@ -526,7 +1018,7 @@ JG_GET_INT(_sizet, size_t);
 JG_GET_INT(_uintmax, uintmax_t);
 
 ////////////////////////////////////////////////////////////////////////////////
-// jg_[root|arr|obj]_get_[float|double|long_double]() //////////////////////////
+// jg_[root|arr|obj|val]_get_[float|double|long_double]() //////////////////////
 
 // Floating point getters may change in the future to take a jg_opt struct
 // with .min and .max members, along with .rel_diff, .abs_diff and/or .epsilon,
@@ -556,15 +1048,84 @@ jg_ret jg_obj_get##_suf( \
     _type * v \
 )
 
+#define JG_VAL_GET_FLO(_suf, _type) \
+jg_ret jg_val_get##_suf( \
+    jg_t * jg, \
+    jg_val_get_t * val, \
+    _type * v \
+)
+
+// Like jg_arr_get_<integer_type>_array(), but without any opt
+#define JG_ARR_GET_FLO_ARRAY(_suf, _type) \
+jg_ret jg_arr_get##_suf##_array( \
+    jg_t * jg, \
+    jg_arr_get_t * arr, \
+    size_t arr_i, \
+    _type * v, \
+    size_t * elem_c \
+)
+
 #define JG_GET_FLO(_suf, _type) \
 JG_ROOT_GET_FLO(_suf, _type); \
 JG_ARR_GET_FLO(_suf, _type); \
-JG_OBJ_GET_FLO(_suf, _type)
+JG_ARR_GET_FLO_ARRAY(_suf, _type); \
+JG_OBJ_GET_FLO(_suf, _type); \
+JG_VAL_GET_FLO(_suf, _type)
 
 JG_GET_FLO(_float, float);
 JG_GET_FLO(_double, double);
 JG_GET_FLO(_long_double, long double);
 
+////////////////////////////////////////////////////////////////////////////////
+// jg_obj_iter_[begin|next|get_key]() //////////////////////////////////////////
+
+// A cursor over the pairs of an object, which unlike the .keys option of the
+// jg_[root|arr|obj|val]_get_obj() getters needs no allocation, and unlike the
+// jg_obj_get_...() getters needs no key lookup.
+struct jg_obj_iter {
+    jg_obj_get_t * obj; // Internal: the object iterated over
+    void const * pair; // Internal: the current pair
+    size_t pair_c; // The number of pairs the object has
+    // A view of the current pair's key within the JSON text: NOT unescaped
+    // (like jg_[root|arr|obj|val]_get_json_str(); see jg_obj_iter_get_key()
+    // instead), nor null-terminated.
+    jg_strview key;
+    // The current pair's value, to be gotten with the jg_val_get_...() getters;
+    // or NULL once all pairs have been iterated over.
+    jg_val_get_t * val;
+};
+
+typedef struct jg_obj_iter jg_obj_iter;
+
+// Point iter at the 1st pair of obj, and then at each next pair in the order
+// they appear in the JSON text. Both .key and .val remain valid for as long as
+// obj does, even after iter moves on. For example:
+//
+// jg_obj_iter it;
+// for (ret = jg_obj_iter_begin(jg, obj, &it); !ret && it.val;
+//     ret = jg_obj_iter_next(jg, &it)) {
+//     <...compare it.key, then call jg_val_get_...(jg, it.val, ...)...>
+// }
+jg_ret jg_obj_iter_begin(
+    jg_t * jg,
+    jg_obj_get_t * obj,
+    jg_obj_iter * iter
+);
+
+jg_ret jg_obj_iter_next(
+    jg_t * jg,
+    jg_obj_iter * iter
+);
+
+// Set *key to a view of the current pair's key as unescaped, in the same way as
+// jg_[root|arr|obj|val]_get_strview() does for strings: if the key contains
+// escape sequences, each call unescapes it anew into memory owned by jg.
+jg_ret jg_obj_iter_get_key(
+    jg_t * jg,
+    jg_obj_iter const * iter,
+    jg_strview * key
+);
+
 //##############################################################################
 //## jg_[root|arr|obj]_set_...() prototypes (jg_set.c) #########################
 
@@ -709,6 +1270,7 @@ jg_ret jg_generate_file(
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std::placeholders;
@@ -762,15 +1324,19 @@ protected:
         switch (ret) {
         case JG_E_STATE_NOT_PARSE: case JG_E_STATE_NOT_GET:
         case JG_E_STATE_NOT_SET: case JG_E_STATE_NOT_GENERATE:
+        case JG_E_IMAGE_NOT_TAPE:
             throw ErrState(str);
         case JG_E_SET_ROOT_ALREADY_SET: case JG_E_SET_NOT_ARR:
         case JG_E_SET_NOT_OBJ: case JG_E_SET_OBJ_DUPLICATE_KEY:
             throw ErrSet(str);
         case JG_E_MALLOC: case JG_E_CALLOC: case JG_E_REALLOC:
         case JG_E_VSPRINTF: case JG_E_VSNPRINTF: case JG_E_NEWLOCALE:
+        case JG_E_ERRNO_THREAD:
             throw ErrMemory(str);
         case JG_E_FREAD: case JG_E_FWRITE: case JG_E_ERRNO_FOPEN:
         case JG_E_ERRNO_FCLOSE: case JG_E_ERRNO_FSEEKO: case JG_E_ERRNO_FTELLO:
+        case JG_E_ERRNO_FSTAT: case JG_E_ERRNO_MMAP: case JG_E_ERRNO_INOTIFY:
+        case JG_E_IMAGE_INVALID:
             throw ErrFile(str);
         case JG_E_PARSE_INVALID_TYPE: case JG_E_PARSE_UNTERM_STR:
         case JG_E_PARSE_UNTERM_ARR: case JG_E_PARSE_UNTERM_OBJ:
@@ -786,6 +1352,7 @@ protected:
         case JG_E_PARSE_ARR_INVALID_SEP: case JG_E_PARSE_OBJ_INVALID_KEY:
         case JG_E_PARSE_OBJ_KEYVAL_INVALID_SEP: case JG_E_PARSE_OBJ_INVALID_SEP:
         case JG_E_PARSE_OBJ_DUPLICATE_KEY: case JG_E_PARSE_ROOT_SURPLUS:
+        case JG_E_PARSE_TAPE_LIMIT: case JG_E_PARSE_MAX_DEPTH:
             throw ErrParse(str);
         case JG_E_GET_ARG_IS_NULL:
             throw ErrArg(str);
@@ -831,6 +1398,33 @@ protected:
         std::string const & max_c_reason = std::string()
     ) const;
 
+    template <typename Opt> static inline void set_str_opt(
+        Opt & opt,
+        size_t min_byte_c,
+        size_t max_byte_c,
+        size_t min_cp_c,
+        size_t max_cp_c,
+        std::string const & min_byte_c_reason,
+        std::string const & max_byte_c_reason,
+        std::string const & min_cp_c_reason,
+        std::string const & max_cp_c_reason,
+        size_t * codepoint_c
+    ) {
+        opt.codepoint_c = codepoint_c;
+        opt.min_byte_c_reason =
+            min_byte_c_reason.empty() ? nullptr : min_byte_c_reason.c_str();
+        opt.max_byte_c_reason =
+            max_byte_c_reason.empty() ? nullptr : max_byte_c_reason.c_str();
+        opt.min_cp_c_reason =
+            min_cp_c_reason.empty() ? nullptr : min_cp_c_reason.c_str();
+        opt.max_cp_c_reason =
+            max_cp_c_reason.empty() ? nullptr : max_cp_c_reason.c_str();
+        opt.min_byte_c = min_byte_c;
+        opt.max_byte_c = max_byte_c;
+        opt.min_cp_c = min_cp_c;
+        opt.max_cp_c = max_cp_c;
+    }
+
     template <typename Functor, typename Opt> inline auto get_str(
         Functor functor,
         Opt && opt,
@@ -847,20 +1441,10 @@ protected:
     ) const {
         size_t byte_c{};
 
+        set_str_opt(opt, min_byte_c, max_byte_c, min_cp_c, max_cp_c,
+            min_byte_c_reason, max_byte_c_reason, min_cp_c_reason,
+            max_cp_c_reason, codepoint_c);
         opt.byte_c = &byte_c;
-        opt.codepoint_c = codepoint_c;
-        opt.min_byte_c_reason =
-            min_byte_c_reason.empty() ? nullptr : min_byte_c_reason.c_str();
-        opt.max_byte_c_reason =
-            max_byte_c_reason.empty() ? nullptr : max_byte_c_reason.c_str();
-        opt.min_cp_c_reason =
-            min_cp_c_reason.empty() ? nullptr : min_cp_c_reason.c_str();
-        opt.max_cp_c_reason =
-            max_cp_c_reason.empty() ? nullptr : max_cp_c_reason.c_str();
-        opt.min_byte_c = min_byte_c;
-        opt.max_byte_c = max_byte_c;
-        opt.min_cp_c = min_cp_c;
-        opt.max_cp_c = max_cp_c;
         opt.omit_null_terminator = true;
 
         guard(functor(&opt, nullptr));
@@ -869,6 +1453,33 @@ protected:
         return str;
     }
 
+    // Unlike get_str(), a single call without any copying (unless unescaping
+    // is needed): the std::string_view returned is valid for as long as the
+    // JSON text is (see jg_[root|arr|obj]_get_strview() in the C API above).
+    template <typename Functor, typename Opt> inline auto get_strview(
+        Functor functor,
+        Opt && opt,
+        size_t min_byte_c = 0,
+        size_t max_byte_c = 0,
+        size_t min_cp_c = 0,
+        size_t max_cp_c = 0,
+        // Cannot use std::string_view: null-terminated .c_str() needed
+        std::string const & min_byte_c_reason = std::string(),
+        std::string const & max_byte_c_reason = std::string(),
+        std::string const & min_cp_c_reason = std::string(),
+        std::string const & max_cp_c_reason = std::string(),
+        size_t * codepoint_c = nullptr
+    ) const {
+        jg_strview v{};
+
+        set_str_opt(opt, min_byte_c, max_byte_c, min_cp_c, max_cp_c,
+            min_byte_c_reason, max_byte_c_reason, min_cp_c_reason,
+            max_cp_c_reason, codepoint_c);
+
+        guard(functor(&opt, &v));
+        return std::string_view(v.str, v.byte_c);
+    }
+
     std::shared_ptr<jg::_Session const> _s{};
 };
 
@@ -907,6 +1518,16 @@ protected:
         return v; \
     }
 
+// Gets all elements of the array at once (see jg_arr_get_..._array() above).
+#define JGP_GET_ARRAY(_suf, _type, _args, _opt, _func) \
+    inline auto get##_suf##_array(_##_args) const { \
+        _##_opt; \
+        std::vector<_type> v(_elem_c); \
+        size_t elem_c = _elem_c; \
+        guard(_func); \
+        return v; \
+    }
+
 #define _JGP_GET_ROOT(_suf, _type) \
     JGP_GET(_suf, _type, JGP_ARGS(), JGP_OPT, \
         jg_root_get##_suf(_s->jg, &v) \
@@ -915,17 +1536,14 @@ protected:
     JGP_GET(_suf, _type, JGP_ARGS(), JGP_OPT, \
         jg_arr_get##_suf(_s->jg, _arr, _i, &v) \
     )
-#define _JGP_GET_OBJ(_suf, _type) \
+#define _JGP_GET_VAL(_suf, _type) \
     JGP_GET(_suf, _type, JGP_ARGS(), JGP_OPT, \
-        jg_obj_get##_suf(_s->jg, _obj, _k, &v) \
+        jg_val_get##_suf(_s->jg, _it.val, &v) \
     )
-#define _JGP_GET_OBJ_NDEFA(_suf, _type) \
-    JGP_GET(_suf, _type, JGP_ARGS(), JGP_OPT, \
-        jg_obj_get##_suf(_s->jg, _obj, _k, nullptr, &v) \
-    )
-#define _JGP_GET_OBJ_DEFA(_suf, _type) \
+// Only an empty object has no current pair to get defa instead of.
+#define _JGP_GET_VAL_DEFA(_suf, _type) \
     JGP_GET(_suf##_defa, _type, JGP_ARGS(_type defa), JGP_OPT, \
-        jg_obj_get##_suf(_s->jg, _obj, _k, &defa, &v) \
+        _it.val ? jg_val_get##_suf(_s->jg, _it.val, &v) : (v = defa, JG_OK) \
     )
 #define _JGP_GET_ROOT_MINMAX(_suf, _type, _type_min, _type_max) \
     JGP_GET(_suf, _type, \
@@ -941,19 +1559,32 @@ protected:
             _type_min, _type_max), \
         jg_arr_get##_suf(_s->jg, _arr, _i, &opt, &v) \
     )
-#define _JGP_GET_OBJ_MINMAX_NDEFA(_suf, _type, _type_min, _type_max) \
+#define _JGP_GET_VAL_MINMAX(_suf, _type, _type_min, _type_max) \
     JGP_GET(_suf, _type, \
         JGP_ARGS_MINMAX(JGP_ARGS_MINMAX_NDEFA, _type, _type_min, _type_max), \
-        JGP_OPT_MINMAX(JGP_OPT_MINMAX_DEFA, jg_opt_obj##_suf, nullptr, _type, \
+        JGP_OPT_MINMAX(JGP_OPT_MINMAX_NDEFA, jg_opt##_suf, nullptr, _type, \
             _type_min, _type_max), \
-        jg_obj_get##_suf(_s->jg, _obj, _k, &opt, &v) \
+        jg_val_get##_suf(_s->jg, _it.val, &opt, &v) \
     )
-#define _JGP_GET_OBJ_MINMAX_DEFA(_suf, _type, _type_min, _type_max) \
+#define _JGP_GET_VAL_MINMAX_DEFA(_suf, _type, _type_min, _type_max) \
     JGP_GET(_suf##_defa, _type, \
         JGP_ARGS_MINMAX(JGP_ARGS_MINMAX_DEFA, _type, _type_min, _type_max), \
-        JGP_OPT_MINMAX(JGP_OPT_MINMAX_DEFA, jg_opt_obj##_suf, &defa, _type, \
+        JGP_OPT_MINMAX(JGP_OPT_MINMAX_NDEFA, jg_opt##_suf, nullptr, _type, \
             _type_min, _type_max), \
-        jg_obj_get##_suf(_s->jg, _obj, _k, &opt, &v) \
+        _it.val ? jg_val_get##_suf(_s->jg, _it.val, &opt, &v) : \
+            (v = defa, JG_OK) \
+    )
+
+#define _JGP_GET_ARR_ARRAY(_suf, _type) \
+    JGP_GET_ARRAY(_suf, _type, JGP_ARGS(), JGP_OPT, \
+        jg_arr_get##_suf##_array(_s->jg, _arr, 0, v.data(), &elem_c) \
+    )
+#define _JGP_GET_ARR_ARRAY_MINMAX(_suf, _type, _type_min, _type_max) \
+    JGP_GET_ARRAY(_suf, _type, \
+        JGP_ARGS_MINMAX(JGP_ARGS_MINMAX_NDEFA, _type, _type_min, _type_max), \
+        JGP_OPT_MINMAX(JGP_OPT_MINMAX_NDEFA, jg_opt##_suf, nullptr, _type, \
+            _type_min, _type_max), \
+        jg_arr_get##_suf##_array(_s->jg, _arr, 0, &opt, v.data(), &elem_c) \
     )
 
 #define JGP_GET_JSON_TYPE(_get) _##_get(_json_type, jg_type)
@@ -991,6 +1622,12 @@ struct Root : protected Base {
         _s = std::make_shared<jg::_Session const>();
     }
 
+    inline void set_parse_opt(
+        jg_opt_parse const & opt
+    ) const {
+        guard(jg_parse_set_opt(_s->jg, &opt));
+    }
+
     inline void parse_str(
         std::string const & json_text
     ) const {
@@ -1021,6 +1658,57 @@ struct Root : protected Base {
         guard(jg_parse_file(_s->jg, filepath.c_str()));
     }
 
+    // Same UTF-8 expectation as parse_file() above
+    inline void parse_file_mmap(
+        std::string const & filepath
+    ) const {
+        guard(jg_parse_file_mmap(_s->jg, filepath.c_str()));
+    }
+
+    inline void parse_begin(
+        size_t byte_c_hint = 0
+    ) const {
+        guard(jg_parse_begin(_s->jg, byte_c_hint));
+    }
+
+    inline void parse_feed(
+        std::string const & chunk
+    ) const {
+        guard(jg_parse_feed(_s->jg, chunk.c_str(), chunk.size()));
+    }
+
+    template <typename Type>
+    inline void parse_feed(
+        std::span<Type> const & chunk
+    ) const {
+        guard(jg_parse_feed(_s->jg, reinterpret_cast<char const *>(&chunk[0]),
+            chunk.size_bytes()));
+    }
+
+    inline void parse_end() const { guard(jg_parse_end(_s->jg)); }
+
+    inline void parse_ndjson_str(
+        std::string const & ndjson_text
+    ) const {
+        guard(jg_parse_ndjson_str(_s->jg, ndjson_text.c_str(),
+            ndjson_text.size()));
+    }
+
+    // Same UTF-8 expectation as parse_file() below
+    inline void parse_ndjson_file(
+        std::string const & filepath
+    ) const {
+        guard(jg_parse_ndjson_file(_s->jg, filepath.c_str()));
+    }
+
+    // Returns the line number of the record parsed, or 0 if none remain. Upon
+    // a parse error, the next call skips to the next record.
+    inline size_t parse_ndjson_next() const {
+        size_t line_i = 0;
+        guard(jg_parse_ndjson_next(_s->jg, &line_i));
+        return line_i;
+    }
+
     // Explicitly require (C++20) std::filesystem::path for this overload to
     // prevent the compiler from trying to promote std::string, and then getting
     // confused that there already is another overload above taking std::string.
@@ -1080,6 +1768,10 @@ struct Root : protected Base {
         auto json_str = get_json_str(args...);
         return *reinterpret_cast<std::u8string *>(&json_str);
     }
+    template <typename... Args> inline auto get_strview(Args... args) const {
+        return Base::get_strview(std::bind(jg_root_get_strview, _s->jg, _1,
+            _2), jg_opt_str{}, args...);
+    }
 
     inline void get_null() const { guard(jg_root_get_null(_s->jg)); }
     JGP_GET_JSON_TYPE(JGP_GET_ROOT);
@@ -1162,12 +1854,18 @@ public:
         auto json_str = get_json_str(args...);
         return *reinterpret_cast<std::u8string *>(&json_str);
     }
+    template <typename... Args> inline auto get_strview(Args... args) const {
+        return Base::get_strview(std::bind(jg_arr_get_strview, _s->jg, _arr,
+            _i, _1, _2), jg_opt_str{}, args...);
+    }
 
     inline void get_null() const { guard(jg_arr_get_null(_s->jg, _arr, _i)); }
     JGP_GET_JSON_TYPE(JGP_GET_ARR);
     JGP_GET_BOOL(JGP_GET_ARR);
     JGP_GET_INT(JGP_GET_ARR_MINMAX);
     JGP_GET_FLO(JGP_GET_ARR);
+    JGP_GET_INT(JGP_GET_ARR_ARRAY_MINMAX);
+    JGP_GET_FLO(JGP_GET_ARR_ARRAY);
 
 private:
     jg_arr_get_t * _arr{};
@@ -1175,27 +1873,28 @@ private:
 
 class ObjGet : public Container {
 public:
+    // Walks obj with a jg_obj_iter, such that neither iterating over it nor
+    // getting its values allocates anything (except for unescaping keys that
+    // contain escape sequences). Keys are unescaped, and the ..._defa() getters
+    // only return defa if there is no current pair (i.e., obj is an empty
+    // default object), just as when they used to look up the current key.
     inline ObjGet(
         std::shared_ptr<jg::_Session const> s,
-        jg_obj_get_t * obj,
-        char * * keys,
-        size_t key_c
-    ) noexcept : Container(s) {
-        _elem_c = key_c;
+        jg_obj_get_t * obj // NULL for an empty default object
+    ) : Container(s) {
         _obj = obj;
-        _keys = keys;
-    }
-    inline ~ObjGet() noexcept {
-        // These keys were received from a C API ..._get_obj...() option struct,
-        // which hands off heap ownership responsibility to the caller.
-        free(_keys);
+        if (obj) {
+            guard(jg_obj_iter_begin(_s->jg, obj, &_it));
+            _elem_c = _it.pair_c;
+        }
     }
 
     inline auto & begin() const noexcept { return *this; }
     inline auto end() const noexcept { return *this; }
     inline auto & operator * () const noexcept { return *this; }
-    inline auto & operator ++ () noexcept {
-        ++_i < _elem_c ? _k = _keys[_i] : _k = _keys[_elem_c - 1];
+    inline auto & operator ++ () {
+        _i++;
+        guard(jg_obj_iter_next(_s->jg, &_it));
         return *this;
     }
     inline auto operator [] (size_t index) {
@@ -1203,71 +1902,96 @@ public:
             throw ErrGetRange("Array received a subscription index beyond its "
                 "valid range.");
         }
-        _k = _keys[_i = index];
+        if (index < _i) {
+            rewind();
+        }
+        while (_i < index) {
+            ++*this;
+        }
         return *this;
     }
     auto & operator [] (std::string const & key) {
-        for (_i = 0; _i < _elem_c; _i++) {
-            _k = _keys[_i];
-            if (_k == key) {
+        for (rewind(); _i < _elem_c; ++*this) {
+            if (get_keyview() == key) {
                 return *this;
             }
         }
         throw ErrGetKey("Key \"" + key + "\" not found.");
     }
 
-    inline std::string get_key() const noexcept { return _k; }
+    // The current key as unescaped, as it always has been
+    inline std::string get_key() const { return std::string(get_keyview()); }
+    // Views the key within the JSON text if it contains no escape sequences;
+    // or else (like get_strview()) its unescaped copy in memory owned by the
+    // session, which each such call allocates anew.
+    inline std::string_view get_keyview() const {
+        jg_strview key{};
+        guard(jg_obj_iter_get_key(_s->jg, &_it, &key));
+        return std::string_view(key.str, key.byte_c);
+    }
     inline auto get_keys() const {
-        std::vector<std::string> keys(_elem_c);
-        auto k = _keys;
-        for (auto & key : keys) {
-            key = *k++;
+        std::vector<std::string> keys;
+        keys.reserve(_elem_c);
+        jg_obj_iter it{};
+        if (_obj) {
+            guard(jg_obj_iter_begin(_s->jg, _obj, &it));
+        }
+        for (; it.val; guard(jg_obj_iter_next(_s->jg, &it))) {
+            jg_strview key{};
+            guard(jg_obj_iter_get_key(_s->jg, &it, &key));
+            keys.emplace_back(key.str, key.byte_c);
         }
         return keys;
     }
 
     template <typename... Args> inline auto get_arr(Args... args) const {
-        return Base::get_arr(std::bind(jg_obj_get_arr, _s->jg, _obj, _k, _1, _2,
+        return Base::get_arr(std::bind(jg_val_get_arr, _s->jg, _it.val, _1, _2,
             _3), args...);
     }
     inline auto get_arr_defa(
         size_t max_c = 0,
         std::string const & max_c_reason = std::string()
     ) const {
-        jg_obj_arr_defa opt{
+        jg_val_arr opt{
+            nullptr,
             max_c_reason.empty() ? nullptr : max_c_reason.c_str(),
+            0,
             max_c
         };
         jg_arr_get_t * arr{};
         size_t elem_c{};
-        guard(jg_obj_get_arr_defa(_s->jg, _obj, _k, &opt, &arr, &elem_c));
+        if (_it.val) {
+            guard(jg_val_get_arr(_s->jg, _it.val, &opt, &arr, &elem_c));
+        }
         return ArrGet(_s, arr, elem_c);
     }
 
     template <typename... Args> inline auto get_obj(Args... args) const {
-        return Base::get_obj(std::bind(jg_obj_get_obj, _s->jg, _obj, _k, _1,
+        return Base::get_obj(std::bind(jg_val_get_obj, _s->jg, _it.val, _1,
             _2), args...);
     }
     inline auto get_obj_defa(
         size_t max_c = 0,
         std::string const & max_c_reason = std::string()
     ) const {
-        char * * keys{};
-        size_t key_c{};
-        jg_obj_obj_defa opt{
-            &keys,
-            &key_c,
+        jg_val_obj opt{
+            nullptr,
+            nullptr,
+            nullptr,
             max_c_reason.empty() ? nullptr : max_c_reason.c_str(),
-            max_c,
+            0,
+            max_c
         };
         jg_obj_get_t * obj{};
-        guard(jg_obj_get_obj_defa(_s->jg, _obj, _k, &opt, &obj));
-        return ObjGet(_s, obj, keys, key_c);
+        if (_it.val) {
+            guard(jg_val_get_obj(_s->jg, _it.val, &opt, &obj));
+        }
+        return ObjGet(_s, obj);
     }
 
     template <typename... Args> inline auto get_str(Args... args) const {
-        return Base::get_str(std::bind(jg_obj_get_callerstr, _s->jg, _obj, _k,
-            _1, _2), jg_opt_obj_str{}, args...);
+        return Base::get_str(std::bind(jg_val_get_callerstr, _s->jg, _it.val,
+            _1, _2), jg_opt_str{}, args...);
     }
     template <typename... Args> inline std::u8string get_u8str(Args... args)
         const {
@@ -1276,8 +2000,7 @@ public:
     }
     template <typename... Args> inline auto get_str_defa(
         std::string const & defa, Args... args) const {
-        return Base::get_str(std::bind(jg_obj_get_callerstr, _s->jg, _obj, _k,
-            _1, _2), jg_opt_obj_str{defa.c_str()}, args...);
+        return _it.val ? get_str(args...) : defa;
     }
     template <typename... Args> inline std::u8string get_u8str_defa(
         Args... args) const {
@@ -1285,8 +2008,8 @@ public:
         return *reinterpret_cast<std::u8string *>(&str_defa);
     }
     template <typename... Args> inline auto get_json_str(Args... args) const {
-        return Base::get_str(std::bind(jg_obj_get_json_callerstr, _s->jg, _obj,
-            _k, _1, _2), jg_opt_obj_str{}, args...);
+        return Base::get_str(std::bind(jg_val_get_json_callerstr, _s->jg,
+            _it.val, _1, _2), jg_opt_str{}, args...);
     }
     template <typename... Args> inline std::u8string get_json_u8str(
         Args... args) const {
@@ -1295,28 +2018,42 @@ public:
     }
     template <typename... Args> inline auto get_json_str_defa(
         std::string const & defa, Args... args) const {
-        return Base::get_str(std::bind(jg_obj_get_json_callerstr, _s->jg, _obj,
-            _k, _1, _2), jg_opt_obj_str{defa.c_str()}, args...);
+        return _it.val ? get_json_str(args...) : defa;
     }
     template <typename... Args> inline std::u8string get_json_u8str_defa(
         Args... args) const {
         auto json_str_defa = get_json_str_defa(args...);
         return *reinterpret_cast<std::u8string *>(&json_str_defa);
     }
+    template <typename... Args> inline auto get_strview(Args... args) const {
+        return Base::get_strview(std::bind(jg_val_get_strview, _s->jg, _it.val,
+            _1, _2), jg_opt_str{}, args...);
+    }
+    // If there is no pair, the std::string_view returned views defa.
+    template <typename... Args> inline auto get_strview_defa(
+        std::string const & defa, Args... args) const {
+        return _it.val ? get_strview(args...) : std::string_view(defa);
+    }
 
-    inline void get_null() const { guard(jg_obj_get_null(_s->jg, _obj,  _k)); }
-    JGP_GET_JSON_TYPE(JGP_GET_OBJ);
-    JGP_GET_BOOL(JGP_GET_OBJ_NDEFA);
-    JGP_GET_BOOL(JGP_GET_OBJ_DEFA);
-    JGP_GET_INT(JGP_GET_OBJ_MINMAX_NDEFA);
-    JGP_GET_INT(JGP_GET_OBJ_MINMAX_DEFA);
-    JGP_GET_FLO(JGP_GET_OBJ_NDEFA);
-    JGP_GET_FLO(JGP_GET_OBJ_DEFA);
+    inline void get_null() const { guard(jg_val_get_null(_s->jg, _it.val)); }
+    JGP_GET_JSON_TYPE(JGP_GET_VAL);
+    JGP_GET_BOOL(JGP_GET_VAL);
+    JGP_GET_BOOL(JGP_GET_VAL_DEFA);
+    JGP_GET_INT(JGP_GET_VAL_MINMAX);
+    JGP_GET_INT(JGP_GET_VAL_MINMAX_DEFA);
+    JGP_GET_FLO(JGP_GET_VAL);
+    JGP_GET_FLO(JGP_GET_VAL_DEFA);
 
 private:
+    inline void rewind() {
+        _i = 0;
+        if (_obj) {
+            guard(jg_obj_iter_begin(_s->jg, _obj, &_it));
+        }
+    }
+
     jg_obj_get_t * _obj{};
-    char * * _keys{};
-    char * _k{};
+    jg_obj_iter _it{};
 };
 
 #undef _JGP_ARGS
@@ -1328,15 +2065,17 @@ private:
 #undef _JGP_OPT_MINMAX_DEFA
 #undef _JGP_OPT_MINMAX
 #undef JGP_GET
+#undef JGP_GET_ARRAY
 #undef _JGP_GET_ROOT
 #undef _JGP_GET_ARR
-#undef _JGP_GET_OBJ
-#undef _JGP_GET_OBJ_NDEFA
-#undef _JGP_GET_OBJ_DEFA
+#undef _JGP_GET_VAL
+#undef _JGP_GET_VAL_DEFA
 #undef _JGP_GET_ROOT_MINMAX
 #undef _JGP_GET_ARR_MINMAX
-#undef _JGP_GET_OBJ_MINMAX_NDEFA
-#undef _JGP_GET_OBJ_MINMAX_DEFA
+#undef _JGP_GET_VAL_MINMAX
+#undef _JGP_GET_VAL_MINMAX_DEFA
+#undef _JGP_GET_ARR_ARRAY
+#undef _JGP_GET_ARR_ARRAY_MINMAX
 #undef JGP_GET_JSON_TYPE
 #undef JGP_GET_BOOL
 #undef JGP_GET_INT
@@ -1394,11 +2133,9 @@ inline auto Base::get_obj(
     std::string const & min_c_reason,
     std::string const & max_c_reason
 ) const {
-    char * * keys{};
-    size_t key_c{};
     jg_opt_obj opt{
-        &keys,
-        &key_c,
+        nullptr,
+        nullptr,
         min_c_reason.empty() ? nullptr : min_c_reason.c_str(),
         max_c_reason.empty() ? nullptr : max_c_reason.c_str(),
         min_c,
@@ -1406,7 +2143,7 @@ inline auto Base::get_obj(
     };
     jg_obj_get_t * obj{};
     guard(functor(&opt, &obj));
-    return ObjGet(_s, obj, keys, key_c);
+    return ObjGet(_s, obj);
 }
 
 } // End of namespace jg
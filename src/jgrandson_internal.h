@@ -6,6 +6,13 @@
 
 #include "jgrandson.h"
 
+#if defined(_WIN32) || defined(_WIN64)
+#define JG_SINGLE_THREADED // Jgrandson starts no threads of its own on Windows.
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
 // All public API functions return an error if that function belongs to a
 // jg_state that is incompatible with the current state.
 enum jg_state {
@@ -31,14 +38,44 @@ struct jg_val_in {
         struct jg_arr * arr; // If .type is ARR
         struct jg_obj * obj; // If .type is OBJ
         char const * json; // If .type is not ARR nor OBJ -- NOT null-terminated
+        // Instead of .json if .type is NUM and jg->decodes_nums (see below)
+        struct jg_num const * num;
     };
     union {
         uint32_t byte_c; // If .type is NUM or STR
         bool bool_is_true; // If .type is BOOL
+        // If .type is ARR or OBJ in lazy mode (see .opt_parse.lazy): if true,
+        // its elements or pairs are yet to be parsed, and .json points to its
+        // opening [ or { instead of .arr or .obj pointing to anything.
+        bool is_unparsed;
     };
     enum jg_type type; // The JSON type this value belongs to (see jgrandson.h)
 };
 
+// A number as decoded by parse_element() if .opt_parse.decode_numbers, such
+// that getters need not convert its JSON text again. The integer and double
+// getters use .mag and .dbl when they are exact, and the JSON text otherwise.
+struct jg_num {
+    char const * json; // Same meaning as .json in jg_val_in
+    // The absolute value of the integer if .is_integer, or UINTMAX_MAX if it
+    // exceeds that (which strto[u]imax() saturate to likewise)
+    uintmax_t mag;
+    double dbl; // Only valid if .has_dbl
+    bool is_neg; // The number starts with a '-' (even if it is zero)
+    bool is_integer; // The number has neither a fraction nor an exponent
+    bool has_dbl; // .dbl is the correctly rounded double
+};
+
+// The decimal form of a JSON number, as scanned by scan_decimal() (jg_float.c):
+// its value is digits * 10^exp10 (negated if .is_neg).
+#define JG_DECIMAL_DIGIT_C 19 // The most that always fit in 64 bits
+struct jg_decimal {
+    uint64_t digits; // The first JG_DECIMAL_DIGIT_C significant digits
+    int64_t exp10;
+    bool is_neg;
+    bool is_truncated; // Any nonzero digits did not fit in .digits.
+};
+
 struct jg_arr {
     char const * json; // Same meaning as .json in jg_val_in has for non-arr/obj
     size_t elem_c;
@@ -56,6 +93,53 @@ struct jg_obj {
     struct jg_pair pairs[]; // flexible array member
 };
 
+// All jg_arr and jg_obj structs of a parsed DOM are bump-allocated from an
+// arena of chunks (see arena_alloc() in jg_heap.c) rather than malloc()ed
+// individually, such that freeing the DOM is O(chunk count) instead of
+// O(container count). Chunks are kept across jg_reinit() for reuse. (Decoded
+// numbers and strings unescaped by jg_[root|arr|obj]_get_strview() go there
+// too, for the same reason.)
+struct jg_arena_chunk {
+    struct jg_arena_chunk * next; // Chunks are linked in order of allocation
+    size_t byte_c; // The size of .bytes
+    size_t used_byte_c; // The number of .bytes handed out so far
+    char bytes[]; // flexible array member
+};
+
+// If jg_parse_set_opt() enabled .tape, the parsed DOM is instead stored as one
+// contiguous array of 8-byte tape entries (jg->tape) in depth-first order:
+//
+// bits 0-2: enum jg_type
+// bits 3-31: NUM/STR: byte_c; BOOL: truth value; ARR: elem_c; OBJ: pair_c
+// bits 32-63: the offset of the value's .json within the JSON text
+//
+// Each ARR or OBJ entry is followed by a raw skip entry holding the number of
+// entries spanned by the array or object (including the ARR/OBJ entry itself
+// and the skip entry), followed by its elements, or by its keys and values in
+// alternating order. In this mode, struct jg_arr and struct jg_obj pointers
+// handed out by getters are actually pointers to ARR and OBJ tape entries.
+#define JG_TAPE_TYPE_BIT_C 3
+#define JG_TAPE_AUX_MAX ((1U << (32 - JG_TAPE_TYPE_BIT_C)) - 1)
+#define JG_TAPE_OFFSET_MAX UINT32_MAX
+#define JG_TAPE_ENTRY(type, aux, offset) ((uint64_t) (type) | \
+    (uint64_t) (aux) << JG_TAPE_TYPE_BIT_C | (uint64_t) (offset) << 32)
+#define JG_TAPE_TYPE(entry) \
+    ((enum jg_type) ((entry) & ((1U << JG_TAPE_TYPE_BIT_C) - 1)))
+#define JG_TAPE_AUX(entry) \
+    ((size_t) ((uint32_t) (entry) >> JG_TAPE_TYPE_BIT_C))
+#define JG_TAPE_OFFSET(entry) ((size_t) ((entry) >> 32))
+
+// Caches the position of the last element looked up in a tape array, such that
+// iterating over an array by index doesn't require rewalking it from the start.
+struct jg_tape_cursor {
+    uint64_t const * arr; // The ARR tape entry
+    uint64_t const * elem; // The tape entry of element .elem_i
+    size_t elem_i;
+};
+
+// The number of arrays for which cursors are cached simultaneously (power of 2)
+#define JG_TAPE_CURSOR_C 8
+
 ////////////////////////////////////////////////////////////////////////////////
 // struct definitions for JG_STATE_SET and JG_STATE_GENERATE ///////////////////
 
@@ -92,6 +176,124 @@ struct jg_obj_node {
     struct jg_obj_node * next;
 };
 
+// Objects with at least this many pairs get a hash index of their keys. It is
+// built during parsing to detect duplicate keys, or lazily upon the first key
+// lookup in the object if .opt_parse.trust_unique_keys skipped that check.
+#define JG_INDEX_MIN_KEY_C 16
+
+struct jg_index_slot {
+    uint32_t hash; // hash_unesc_str() of the unescaped key
+    uint32_t pos_plus_1; // 0 if the slot is empty (see below for pos)
+};
+
+// An open-addressing (linear probing) hash table of the keys of an object. Keys
+// are identified by their position pos: the index of their jg_pair in .pairs of
+// the jg_obj, or in tape mode, the key's tape entry offset from the OBJ entry.
+struct jg_index {
+    size_t slot_c; // A power of 2
+    size_t key_c;
+    struct jg_index_slot slots[]; // flexible array member
+};
+
+// An entry of the hash table that maps objects to their struct jg_index (if
+// any). Objects are identified by the location of their opening '{' (.json),
+// which works the same regardless of whether tape mode is used.
+struct jg_obj_index_slot {
+    char const * obj_json; // NULL if the slot is empty
+    struct jg_index * index;
+};
+
+// In lazy mode, the end of an array or object spanning at least
+// JG_LAZY_SKIP_MIN_BYTE_C bytes, such that parse_lazy_container() can skip over
+// it without scanning its JSON text anew
+struct jg_lazy_skip {
+    char const * open; // Its opening [ or {
+    char const * over; // The byte following its closing ] or }
+};
+
+#define JG_LAZY_SKIP_MIN_BYTE_C 0x100 // 256 B
+
+// If .opt_parse.unescape_in_place, a string value with escape sequences, which
+// is unescaped in place only once the JSON text as a whole has been parsed
+// (such that parse errors are reported in the JSON text as it was). Allocated
+// from the arena, and linked in the reverse order of parsing.
+struct jg_unesc {
+    struct jg_unesc * next;
+    char * json;
+    size_t byte_c; // Its .byte_c before unescaping
+};
+
+// The step parse_element() is to take next. Each step begins right after the
+// last change to the DOM, such that when the JSON text fed by jg_parse_feed()
+// so far ends halfway through a step, that step can simply be retried once
+// more of the JSON text has been fed.
+enum jg_parse_step {
+    JG_PARSE_STEP_VALUE = 0, // Parse the root, an array element, or a value
+    JG_PARSE_STEP_OPENED, // Parse the 1st element or key, or ']' or '}'
+    JG_PARSE_STEP_ADDED, // Parse ']', '}', or the ',' before the next element
+    JG_PARSE_STEP_KEYED, // Parse the ':' after a key
+    JG_PARSE_STEP_DONE // The root value is complete
+};
+
+// A buffer of the JSON text fed by jg_parse_feed() so far. When it runs out of
+// room, its text is copied to a new buffer twice its size; but the old buffer
+// is kept until jg_reinit() or jg_free(), because the DOM may refer to it.
+struct jg_feed_buf {
+    struct jg_feed_buf * prev; // The buffer that this buffer replaced (if any)
+    size_t byte_c; // The number of bytes of JSON text in .text
+    size_t size; // The number of bytes .text has room for
+    char text[]; // flexible array member
+};
+
+// The NDJSON text given to jg_parse_ndjson_...(), the lines of which are parsed
+// one record at a time by jg_parse_ndjson_next(): each record's line is then
+// parsed as if it were given to jg_parse_callerstr().
+struct jg_ndjson {
+    char const * text; // NULL unless jg_parse_ndjson_...() was called
+    char const * cur; // The start of the line following the current record
+    char const * over; // The byte following the end of the NDJSON text
+    size_t line_i; // The line number of the current record (starting at 1)
+    size_t mmap_byte_c; // The size of the mapping if .text is mmap()ed
+    bool is_callertext; // Not free()d by Jgrandson if true
+};
+
+// An array or object that is open (i.e., being parsed or generated) at the
+// nesting level corresponding to this frame's position in jg->frames
+struct jg_frame {
+    union {
+        char const * open; // Parse: the location of its opening [ or {
+        struct jg_arr_node const * arr_node; // Generate: the current element
+        struct jg_obj_node const * obj_node; // Generate: the current pair
+    };
+    size_t stack_i; // Parse: its 1st value's index on jg->stack
+    size_t tape_i; // Parse (tape mode): the index of its ARR or OBJ tape entry
+    size_t c; // Parse: the number of elements or pairs parsed so far
+    struct jg_index * index; // Parse: its key index (if it is a large object)
+    enum jg_type type; // ARR or OBJ
+};
+
+// A mutex and a condition variable for use by the thread pools of
+// jg_parse_ndjson_parallel() and parse_in_parallel() (see jg_thread.c)
+struct jg_lock {
+#ifdef JG_SINGLE_THREADED
+    char unused; // C does not allow empty structs.
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+};
+
+// An integer (or a pointer cast to one) that threads can read and update
+// without taking a lock, for use by frozen documents and their slots (see
+// jg_doc.c). All operations on it are sequentially consistent.
+struct jg_atomic {
+#ifdef JG_SINGLE_THREADED
+    uintptr_t val;
+#else
+    _Atomic uintptr_t val;
+#endif
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Main jgrandson (jg_t) struct definition /////////////////////////////////////
 
@@ -116,6 +318,78 @@ struct jgrandson {
     };
     char const * json_cur; // Current parsing position within JSON text
     char const * json_over; // The byte following the end of the JSON text
+    // JSON text from where UTF-8 validation started up to (but excluding)
+    // .utf8_valid_over is known to be valid. If .utf8_valid_over < .json_over,
+    // it points to the 1st byte of an invalid UTF-8 char, which is an error if
+    // it belongs to a string (but not if it belongs to a comment).
+    char const * utf8_valid_over;
+    // Where parsing is to resume (see enum jg_parse_step)
+    enum jg_parse_step parse_step;
+    char const * parse_step_c;
+    // The buffer of the JSON text fed with jg_parse_feed() (if any), and where
+    // to resume scanning the string whose opening '"' is at .feed_str_open if
+    // the JSON text fed so far ended within it
+    struct jg_feed_buf * feed_buf;
+    char const * feed_str_open;
+    char const * feed_str_resume;
+
+    // Parse-only LIFO of values that belong to arrays and objects that are
+    // still being parsed. Once the closing bracket or brace of such an array or
+    // object is reached, close_container() packs its values into an exactly
+    // sized jg_arr or jg_obj, and pops them off the stack again.
+    struct jg_val_in * stack;
+    size_t stack_c; // The number of values currently on the stack
+    size_t stack_size; // The number of values the stack has room for
+    // Arena chunk list head, and the chunk currently being allocated from
+    struct jg_arena_chunk * arena_head;
+    struct jg_arena_chunk * arena_cur;
+    // LIFO of the arrays and objects currently being parsed or generated, such
+    // that neither needs to recurse (see struct jg_frame)
+    struct jg_frame * frames;
+    size_t frame_c; // The number of frames currently on the LIFO
+    size_t frame_size; // The number of frames the LIFO has room for
+    // The tape DOM (if .opt_parse.tape), which is kept across jg_reinit() too
+    uint64_t * tape;
+    size_t tape_c; // The number of entries currently on the tape
+    size_t tape_size; // The number of entries the tape has room for
+    bool tape_is_image; // .tape points into the image of jg_load_image()
+    struct jg_tape_cursor tape_cursors[JG_TAPE_CURSOR_C];
+    // Objects with at least JG_INDEX_MIN_KEY_C pairs that have a key index
+    struct jg_obj_index_slot * obj_indexes;
+    size_t obj_index_c; // The number of objects that have an index
+    size_t obj_index_slot_c; // The size of .obj_indexes (a power of 2)
+    // Seeds all key hashes: set anew by each parse (except NDJSON records)
+    uint64_t hash_seed;
+    // Lazy mode (if .opt_parse.lazy, unless .opt_parse.tape or jg_parse_feed()
+    // is used): the large arrays and objects, sorted by their .open
+    bool is_lazy;
+    struct jg_lazy_skip * lazy_skips;
+    size_t lazy_skip_c;
+    size_t lazy_skip_size; // The number of skips .lazy_skips has room for
+    // The copy of the (ND)JSON text made by jg_parse_[ndjson_]str/file(), if
+    // any, which is kept across jg_reinit() too (see alloc_text_buf())
+    char * text_buf;
+    size_t text_buf_byte_c;
+    // Links the idle sessions of a jg_pool_t (see jg_pool.c)
+    jg_t * pool_next;
+    // The frozen document that jg_parse_doc() made this session a reader of
+    // (see jg_doc.c), the DOM of which the session shares rather than owns; and
+    // the session's own .opt_parse.tape, which the document's (or that of
+    // jg_load_image()) overrides
+    jg_doc_t * doc;
+    bool own_opt_tape;
+    // Whether the NUM values of the DOM point to a struct jg_num, which is the
+    // case if .opt_parse.decode_numbers (unless .opt_parse.tape)
+    bool decodes_nums;
+    // Whether STR values are unescaped in place, which is the case if
+    // .opt_parse.unescape_in_place and the JSON text is a copy in .text_buf
+    // (or if it was loaded by jg_load_image()); and those yet to be unescaped
+    // (until parsing succeeds)
+    bool unescapes_strs;
+    struct jg_unesc * unescs;
+    // Getters work on struct jg_val_in values: tape entries are decoded here.
+    struct jg_val_in tape_val;
+    struct jg_opt_parse opt_parse; // Set with jg_parse_set_opt()
    
     union { 
         char * err_str; // Ref to a heap string returned by jg_get_err_str()
@@ -125,6 +399,11 @@ struct jgrandson {
     union jg_err_val err_val; // Val associated with the last .ret err condition
     
     bool json_is_callertext; // JSON text not free()d by Jgrandson if true
+    // The size of the mapping if the JSON text is a file mmap()ed by
+    // jg_parse_file_mmap() (in which case .json_is_callertext is true too)
+    size_t json_mmap_byte_c;
+    bool json_is_partial; // True in between jg_parse_begin() and jg_parse_end()
+    struct jg_ndjson ndjson; // Kept from one jg_parse_ndjson_next() to the next
     bool err_str_needs_free; // Not to be free()d (by anyone) if false
 
     jg_ret ret; // The last jg_ret value returned by a public API function
@@ -134,7 +413,7 @@ struct jgrandson {
 ////////////////////////////////////////////////////////////////////////////////
 // jg_heap.c prototypes (internal) /////////////////////////////////////////////
 
-void free_json_text( // Only free()s if not jg->json_is_callertext
+void free_json_text( // munmap()s if mapped; keeps .text_buf for reuse
     jg_t * jg
 );
 
@@ -142,6 +421,10 @@ void free_err_str( // Only free()s if not jg->err_str_needs_free
     jg_t * jg
 );
 
+void reinit_for_ndjson_record( // jg_reinit(), except for .ndjson and .hash_seed
+    jg_t * jg
+);
+
 jg_ret set_custom_err_str(
     jg_t * jg,
     char const * custom_err_str
@@ -154,6 +437,173 @@ jg_ret alloc_strcpy(
     size_t byte_c // excluding null-terminator
 );
 
+jg_ret alloc_text_buf( // Points *text at jg->text_buf of at least byte_c bytes
+    jg_t * jg,
+    size_t byte_c,
+    char * * text
+);
+
+void * arena_alloc( // Returns NULL if malloc() fails
+    jg_t * jg,
+    size_t byte_c
+);
+
+jg_ret push_frame( // Grows jg->frames as needed; *frame is left uninitialized
+    jg_t * jg,
+    struct jg_frame * * frame
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_parse.c prototypes (internal) ////////////////////////////////////////////
+
+void skip_any_whitespace_or_comments(
+    char const * * c,
+    char const * const c_over
+);
+
+char const * skip_string( // Returns the char following the closing '"'
+    char const * c, // The opening '"'
+    char const * const c_over
+);
+
+jg_ret parse_elements( // Parses a run of array elements without the brackets
+    jg_t * jg,
+    char const * c, // The 1st element (or whitespace or comments preceding it)
+    char const * c_over, // The ',' or ']' following the last element
+    size_t * elem_c // Incremented by the number of elements parsed
+);
+
+jg_ret parse_lazy_container( // Called by getters in lazy mode
+    jg_t * jg,
+    struct jg_val_in * v // .is_unparsed must be true
+);
+
+jg_ret read_file( // Called by jg_load_image() on Windows (see jg_image.c)
+    jg_t * jg,
+    char const * filepath,
+    char * * text,
+    size_t * byte_c // Includes the newline appended to the contents
+);
+
+#if !defined(_WIN32) && !defined(_WIN64)
+jg_ret map_file( // Also called by jg_load_image() (see jg_image.c)
+    jg_t * jg,
+    char const * filepath,
+    bool is_sequential, // Whether to ask the kernel to read ahead
+    char const * * text,
+    size_t * byte_c
+);
+#endif
+
+jg_ret parse_file_if_changed( // Called by jg_watch_...() (see jg_parse.c)
+    jg_t * jg,
+    char const * filepath,
+    uint64_t const * old_hash, // Of the contents parsed last (if any)
+    uint64_t * new_hash, // Of the contents read now
+    bool * is_parsed // False if they hash to *old_hash (and jg is reinited)
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_get.c prototypes (internal) //////////////////////////////////////////////
+
+jg_ret complete_dom( // Called by jg_freeze() before handing the DOM over
+    jg_t * jg
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_doc.c prototypes (internal) //////////////////////////////////////////////
+
+void stop_reading_doc( // Called by jg_reinit() and jg_free() if jg->doc is set
+    jg_t * jg
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_image.c prototypes (internal) ////////////////////////////////////////////
+
+void stop_reading_image( // Called by jg_reinit() and jg_free() on image tapes
+    jg_t * jg
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_parallel.c prototypes (internal) /////////////////////////////////////////
+
+jg_ret parse_in_parallel( // Called by parse_root() if .opt_parse.thread_c > 1
+    jg_t * jg,
+    bool * is_parsed // False if the JSON text is to be parsed sequentially
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_thread.c prototypes (internal) ///////////////////////////////////////////
+
+jg_ret init_lock( // Returns JG_E_ERRNO_THREAD on failure
+    jg_t * jg,
+    struct jg_lock * lock
+);
+
+void free_lock(
+    struct jg_lock * lock
+);
+
+void acquire_lock(
+    struct jg_lock * lock
+);
+
+void release_lock(
+    struct jg_lock * lock
+);
+
+void wait_for_lock_signal( // The lock must be acquired.
+    struct jg_lock * lock
+);
+
+void signal_lock( // Wakes up all threads waiting for a signal
+    struct jg_lock * lock
+);
+
+size_t get_thread_c( // The number of online CPU cores if thread_c is 0
+    size_t thread_c
+);
+
+void run_threads( // Calls run(args + i * arg_byte_c) for each i in parallel
+    size_t thread_c,
+    void * (* run)(void *),
+    void * args,
+    size_t arg_byte_c
+);
+
+void init_atomic( // Must precede any other operation on the atomic
+    struct jg_atomic * atomic,
+    uintptr_t val
+);
+
+uintptr_t load_atomic(
+    struct jg_atomic * atomic
+);
+
+void store_atomic(
+    struct jg_atomic * atomic,
+    uintptr_t val
+);
+
+uintptr_t exchange_atomic( // Returns the value it replaced
+    struct jg_atomic * atomic,
+    uintptr_t val
+);
+
+uintptr_t add_atomic( // Returns the value preceding the addition
+    struct jg_atomic * atomic,
+    uintptr_t val
+);
+
+uintptr_t sub_atomic( // Returns the value preceding the subtraction
+    struct jg_atomic * atomic,
+    uintptr_t val
+);
+
+void yield_thread( // Lets other threads run before the calling thread resumes
+    void
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 // jg_error.c prototypes (internal) ////////////////////////////////////////////
 
@@ -164,6 +614,185 @@ jg_ret print_alloc_str(
     ...
 );
 
+////////////////////////////////////////////////////////////////////////////////
+// jg_simd.c prototypes (internal) /////////////////////////////////////////////
+
+// All return the first char in [c, c_over) that they do not skip, or c_over.
+
+char const * skip_str_chars( // Skips all but '"', '\\', and control chars...
+    char const * c,
+    char const * const c_over,
+    bool skip_non_ascii // ...and non-ASCII bytes unless this is true
+);
+
+char const * skip_whitespace( // Skips ' ', '\n', '\t', and '\r'
+    char const * c,
+    char const * const c_over
+);
+
+char const * skip_valid_utf8( // Returns the 1st byte of the 1st invalid char
+    char const * c, // must point to the 1st byte of a char
+    char const * const c_over
+);
+
+// Also accumulates the value of the digits skipped into *u, saturating at
+// UINTMAX_MAX (like strtoumax() does) if it exceeds that.
+char const * skip_digits( // Skips '0' through '9'
+    char const * c,
+    char const * const c_over,
+    uintmax_t * u
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_index.c prototypes (internal) ////////////////////////////////////////////
+
+uint64_t new_hash_seed( // Called by parse_root() to seed hash_unesc_str()
+    jg_t const * jg
+);
+
+uint64_t hash_bytes( // Also tells whether a watched file changed (jg_watch.c)
+    uint64_t seed,
+    uint8_t const * bytes,
+    size_t byte_c
+);
+
+uint32_t hash_unesc_str( // hash_bytes() folded to 32 bits
+    uint64_t seed,
+    uint8_t const * str,
+    size_t byte_c
+);
+
+jg_ret hash_json_str( // hash_unesc_str(jg->hash_seed, <the unescaped string>)
+    jg_t * jg,
+    uint8_t const * json_str, // an already validated JSON string
+    size_t json_byte_c,
+    uint32_t * hash
+);
+
+jg_ret alloc_index( // Arena-allocates an empty index with room for key_c keys
+    jg_t * jg,
+    size_t key_c,
+    struct jg_index * * index
+);
+
+jg_ret reserve_index_key( // Replaces the index with a larger copy if it is full
+    jg_t * jg,
+    struct jg_index * * index
+);
+
+void index_insert( // The index must have room (i.e., key_c < slot_c / 2)
+    struct jg_index * index,
+    uint32_t hash,
+    uint32_t pos
+);
+
+bool index_find_next( // Returns false once no more candidates remain
+    struct jg_index const * index,
+    uint32_t hash,
+    size_t * slot_i, // Set to hash & (slot_c - 1) before the 1st call
+    uint32_t * pos // The position of a key with the same hash (if true)
+);
+
+struct jg_index * get_obj_index( // Returns NULL if the object has no index
+    jg_t * jg,
+    char const * obj_json
+);
+
+jg_ret set_obj_index(
+    jg_t * jg,
+    char const * obj_json,
+    struct jg_index * index
+);
+
+jg_ret rebase_obj_indexes( // Rekey them from old_text to new_text (tape mode)
+    jg_t * jg,
+    char const * old_text,
+    char const * new_text
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_float.c prototypes (internal) ////////////////////////////////////////////
+
+void scan_decimal(
+    char const * json, // an already validated JSON number
+    size_t byte_c,
+    struct jg_decimal * dec
+);
+
+bool decimal_to_double( // Returns false if strtod() is needed after all
+    struct jg_decimal const * dec,
+    double * d
+);
+
+// The following return JG_E_GET_NUM_..._OUT_OF_RANGE or JG_E_GET_NUM_NOT_FLO if
+// the strto[f|d|ld]() slow path does, or JG_E_MALLOC if its copy of json does.
+
+jg_ret json_to_float(
+    char const * json, // an already validated JSON number
+    size_t byte_c,
+    float * v
+);
+
+jg_ret json_to_double(
+    char const * json, // an already validated JSON number
+    size_t byte_c,
+    double * v
+);
+
+jg_ret json_to_long_double(
+    char const * json, // an already validated JSON number
+    size_t byte_c,
+    long double * v
+);
+
+////////////////////////////////////////////////////////////////////////////////
+// jg_tape.c prototypes (internal) /////////////////////////////////////////////
+
+jg_ret tape_push_value( // Appends an entry for any type other than ARR or OBJ
+    jg_t * jg,
+    struct jg_val_in const * v
+);
+
+jg_ret tape_push_container( // Reserves the ARR/OBJ entry and its skip entry
+    jg_t * jg,
+    size_t * tape_i // Set to the index of the reserved ARR/OBJ entry
+);
+
+jg_ret tape_set_container( // Fills in the entries reserved above
+    jg_t * jg,
+    size_t tape_i,
+    enum jg_type type,
+    char const * json,
+    size_t c // elem_c or pair_c
+);
+
+jg_ret tape_append( // Appends entries copied from another tape
+    jg_t * jg,
+    uint64_t const * entries,
+    size_t entry_c
+);
+
+void tape_get_val(
+    jg_t * jg,
+    uint64_t const * entry,
+    struct jg_val_in * v
+);
+
+char const * tape_get_json(
+    jg_t * jg,
+    uint64_t const * entry
+);
+
+uint64_t const * tape_get_next( // The entry following entry's value
+    uint64_t const * entry
+);
+
+uint64_t const * tape_get_elem( // The caller must check that arr_i < elem_c
+    jg_t * jg,
+    uint64_t const * arr,
+    size_t arr_i
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 // jg_unicode.c prototypes (internal) //////////////////////////////////////////
 
@@ -179,6 +808,11 @@ size_t get_utf8_char_size(
     uint8_t const * const u_over
 );
 
+size_t get_valid_utf8_char_size( // Returns 0 if invalid
+    uint8_t const * u,
+    uint8_t const * const u_over
+);
+
 size_t get_unesc_byte_c(
     uint8_t const * const json_str, // an already validated JSON string
     size_t json_byte_c
@@ -194,6 +828,11 @@ size_t get_codepoint_c(
     size_t json_byte_c
 );
 
+size_t get_unesc_codepoint_c(
+    uint8_t const * const unesc_str,
+    size_t unesc_byte_c
+);
+
 void json_str_to_unesc_str(
     uint8_t const * const json_str, // an already validated JSON string
     size_t json_byte_c,
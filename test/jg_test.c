@@ -0,0 +1,2462 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include "jgrandson_internal.h" // For test_retention()
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int fail_c = 0;
+
+#define REPORT(_call, _ret, _expected) fprintf(stderr, \
+    "%s:%d: %s returned %d instead of %d\n", __FILE__, __LINE__, #_call, \
+    (int) (_ret), (int) (_expected))
+
+#define CHECK(_cond) do { \
+    if (!(_cond)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+            #_cond); \
+        fail_c++; \
+    } \
+} while (0)
+
+#define CHECK_RET(_call, _ret) do { \
+    jg_ret check_ret = (_call); \
+    if (check_ret != (_ret)) { \
+        REPORT(_call, check_ret, _ret); \
+        fail_c++; \
+    } \
+} while (0)
+
+// Getting anything after an unexpectedly failed parse is pointless, so bail.
+#define CHECK_PARSE(_call) do { \
+    jg_ret check_ret = (_call); \
+    if (check_ret != JG_OK) { \
+        REPORT(_call, check_ret, JG_OK); \
+        fail_c++; \
+        return; \
+    } \
+} while (0)
+
+static jg_ret parse_with_opt(
+    jg_t * jg,
+    jg_opt_parse const * opt,
+    char const * json_text
+) {
+    jg_reinit(jg);
+    jg_ret ret = jg_parse_set_opt(jg, opt);
+    if (ret != JG_OK) {
+        return ret;
+    }
+    return jg_parse_str(jg, json_text, strlen(json_text));
+}
+
+// Text describing a value, built by dump_val() to compare DOMs with
+struct test_dump {
+    char str[0x4000];
+    size_t byte_c;
+};
+
+static void dump_printf(
+    struct test_dump * dump,
+    char const * format,
+    ...
+) {
+    va_list args;
+    va_start(args, format);
+    size_t size = sizeof(dump->str) - dump->byte_c;
+    int byte_c = vsnprintf(dump->str + dump->byte_c, size, format, args);
+    va_end(args);
+    if (byte_c > 0) {
+        dump->byte_c += (size_t) byte_c < size ? (size_t) byte_c : size - 1;
+    }
+}
+
+// Dump val if not NULL, or else element arr_i of arr if not NULL, or else the
+// root, with every getter that applies to its type; or dump the getter error
+// encountered instead.
+static void dump_val(
+    jg_t * jg,
+    jg_val_get_t * val,
+    jg_arr_get_t * arr,
+    size_t arr_i,
+    struct test_dump * dump
+) {
+#define DUMP_GET(_get, ...) do { \
+    jg_ret dump_ret = val ? jg_val_get##_get(jg, val, __VA_ARGS__) : arr ? \
+        jg_arr_get##_get(jg, arr, arr_i, __VA_ARGS__) : \
+        jg_root_get##_get(jg, __VA_ARGS__); \
+    if (dump_ret != JG_OK) { \
+        dump_printf(dump, "<error %d>", (int) dump_ret); \
+        return; \
+    } \
+} while (0)
+    enum jg_type type = JG_TYPE_NULL;
+    DUMP_GET(_json_type, &type);
+    switch (type) {
+    case JG_TYPE_NULL:
+        dump_printf(dump, "null");
+        return;
+    case JG_TYPE_BOOL: {
+        bool v = false;
+        DUMP_GET(_bool, &v);
+        dump_printf(dump, v ? "true" : "false");
+        return;
+    }
+    case JG_TYPE_NUM: {
+        double v = 0.0;
+        DUMP_GET(_double, &v);
+        dump_printf(dump, "%a", v);
+        return;
+    }
+    case JG_TYPE_STR: {
+        jg_strview v = {0};
+        DUMP_GET(_strview, NULL, &v);
+        dump_printf(dump, "\"%.*s\"", (int) v.byte_c, v.str);
+        return;
+    }
+    case JG_TYPE_ARR: {
+        jg_arr_get_t * v = NULL;
+        size_t elem_c = 0;
+        DUMP_GET(_arr, NULL, &v, &elem_c);
+        dump_printf(dump, "[");
+        for (size_t i = 0; i < elem_c; i++) {
+            dump_printf(dump, i ? ", " : "");
+            dump_val(jg, NULL, v, i, dump);
+        }
+        dump_printf(dump, "]");
+        return;
+    }
+    case JG_TYPE_OBJ: default: {
+        jg_obj_get_t * v = NULL;
+        DUMP_GET(_obj, NULL, &v);
+        dump_printf(dump, "{");
+        jg_obj_iter it = {0};
+        jg_ret ret = jg_obj_iter_begin(jg, v, &it);
+        for (size_t i = 0; ret == JG_OK && it.val;
+            ret = jg_obj_iter_next(jg, &it), i++) {
+            dump_printf(dump, "%s\"%.*s\": ", i ? ", " : "",
+                (int) it.key.byte_c, it.key.str);
+            dump_val(jg, it.val, NULL, 0, dump);
+        }
+        dump_printf(dump, ret == JG_OK ? "}" : "<error %d>", (int) ret);
+    }
+    }
+#undef DUMP_GET
+}
+
+static bool write_file(
+    char const * filepath,
+    void const * bytes,
+    size_t byte_c
+) {
+    FILE * f = fopen(filepath, "wb");
+    CHECK(f);
+    if (!f) {
+        return false;
+    }
+    bool is_written = fwrite(bytes, 1, byte_c, f) == byte_c;
+    return !fclose(f) && is_written;
+}
+
+//##############################################################################
+//## jg_parse_...() errors #####################################################
+
+// An unterminated string is reported as such regardless of its final bytes,
+// and of whether the jg_parse_...() function appends a newline to the text.
+static void test_unterm_str(
+    jg_t * jg
+) {
+    char const * const json_texts[] = {
+        "\"abc", "[\"abc\\", "{\"a\": \"\\u12",
+        // jg_parse_feed() can't tell that these won't be terminated later on.
+        "\"abc\n", "\"abc\\\n"
+    };
+    for (size_t i = 0; i < sizeof(json_texts) / sizeof(*json_texts); i++) {
+        char const * json_text = json_texts[i];
+        size_t byte_c = strlen(json_text);
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_str(jg, json_text, byte_c), JG_E_PARSE_UNTERM_STR);
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_callerstr(jg, json_text, byte_c),
+            JG_E_PARSE_UNTERM_STR);
+        if (i >= 3) {
+            continue;
+        }
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_begin(jg, 0), JG_OK);
+        CHECK_RET(jg_parse_feed(jg, json_text, byte_c), JG_OK);
+        CHECK_RET(jg_parse_end(jg), JG_E_PARSE_UNTERM_STR);
+    }
+    // A control char that is part of the JSON text is still reported as such.
+    CHECK_RET(parse_with_opt(jg, NULL, "\"a\tb\""),
+        JG_E_PARSE_STR_UNESC_CONTROL);
+}
+
+//##############################################################################
+//## skip_str_chars() and skip_whitespace() ####################################
+
+#define TEST_SCAN_MAX_BYTE_C 100 // Several 32-byte AVX2 and 16-byte SSE2 steps
+#define TEST_SCAN_MAX_SHIFT 16
+
+static char const * skip_str_chars_ref(
+    char const * c,
+    char const * c_over,
+    bool skip_non_ascii
+) {
+    while (c < c_over && *c != '"' && *c != '\\' && (uint8_t) *c >= ' ' &&
+        (skip_non_ascii || (uint8_t) *c < 0x80)) {
+        c++;
+    }
+    return c;
+}
+
+static char const * skip_whitespace_ref(
+    char const * c,
+    char const * c_over
+) {
+    while (c < c_over &&
+        (*c == ' ' || *c == '\n' || *c == '\t' || *c == '\r')) {
+        c++;
+    }
+    return c;
+}
+
+static void report_scan(
+    int line,
+    size_t shift,
+    size_t byte_c,
+    size_t stop_i,
+    uint8_t stop
+) {
+    fprintf(stderr, "%s:%d: scan of %zu bytes at shift %zu missed 0x%02X at "
+        "%zu\n", __FILE__, line, byte_c, shift, stop, stop_i);
+    fail_c++;
+}
+
+// Whichever kernel the CPU gets, it must stop at the same byte as scanning
+// byte by byte does: for each stop byte at each position of each length, from
+// starts of every alignment.
+static void test_scan(
+    void
+) {
+    static char buf[TEST_SCAN_MAX_SHIFT + TEST_SCAN_MAX_BYTE_C];
+    uint8_t const str_stops[] = {'"', '\\', 0x00, 0x1F, 0x20, 0x7F, 0x80,
+        0xA0, 0xC3, 0xFF};
+    uint8_t const whitespace_stops[] = {'a', 0x00, 0x0B, 0x0C, 0x80, 0x89,
+        0x8A, 0xA0, 0xFF};
+    for (size_t shift = 0; shift < TEST_SCAN_MAX_SHIFT; shift++) {
+        char * c = buf + shift;
+        for (size_t byte_c = 0; byte_c <= TEST_SCAN_MAX_BYTE_C; byte_c++) {
+            for (size_t i = 0; i <= byte_c; i++) { // i == byte_c: no stop byte
+                for (size_t j = 0; j < sizeof(str_stops); j++) {
+                    memset(c, 'a', byte_c);
+                    if (i < byte_c) {
+                        c[i] = (char) str_stops[j];
+                    }
+                    for (int k = 0; k < 2; k++) {
+                        if (skip_str_chars(c, c + byte_c, k) !=
+                            skip_str_chars_ref(c, c + byte_c, k)) {
+                            report_scan(__LINE__, shift, byte_c, i,
+                                str_stops[j]);
+                            return;
+                        }
+                    }
+                }
+                for (size_t j = 0; j < sizeof(whitespace_stops); j++) {
+                    for (size_t k = 0; k < byte_c; k++) {
+                        c[k] = " \t\n\r"[k % 4];
+                    }
+                    if (i < byte_c) {
+                        c[i] = (char) whitespace_stops[j];
+                    }
+                    if (skip_whitespace(c, c + byte_c) !=
+                        skip_whitespace_ref(c, c + byte_c)) {
+                        report_scan(__LINE__, shift, byte_c, i,
+                            whitespace_stops[j]);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//##############################################################################
+//## skip_valid_utf8() #########################################################
+
+#define TEST_UTF8_MAX_PAD_C 70 // Puts each sequence at every vector offset
+
+// The byte sequences are each preceded by pad_c ASCII chars within a string
+// value, and followed by 40 more, such that each gets validated by the vector
+// kernels as well as by the scalar tail.
+static struct {
+    char const * seq;
+    size_t bad_i; // The byte of seq the error points to, or SIZE_MAX if valid
+} const utf8_seqs[] = {
+    // Valid: the boundaries of each sequence length
+    {"\xC2\x80", SIZE_MAX}, {"\xDF\xBF", SIZE_MAX}, {"\xE0\xA0\x80", SIZE_MAX},
+    {"\xED\x9F\xBF", SIZE_MAX}, {"\xEE\x80\x80", SIZE_MAX},
+    {"\xEF\xBF\xBF", SIZE_MAX}, {"\xF0\x90\x80\x80", SIZE_MAX},
+    {"\xF4\x8F\xBF\xBF", SIZE_MAX},
+    // Overlong encodings
+    {"\xC0\x80", 0}, {"\xC1\xBF", 0}, {"\xE0\x80\x80", 0},
+    {"\xE0\x9F\xBF", 0}, {"\xF0\x80\x80\x80", 0}, {"\xF0\x8F\xBF\xBF", 0},
+    // UTF-16 surrogates, and code points beyond U+10FFFF
+    {"\xED\xA0\x80", 0}, {"\xED\xBF\xBF", 0}, {"\xF4\x90\x80\x80", 0},
+    {"\xF5\x80\x80\x80", 0},
+    // Bytes that never occur, and truncated or surplus continuation bytes
+    {"\xFE", 0}, {"\xFF", 0}, {"\x80", 0}, {"\xBF", 0}, {"\xC3" "a", 0},
+    {"\xE2\x82" "a", 0}, {"\xF0\x9F\x98" "a", 0}, {"\xC3\xA9\xA9", 2},
+    {"\xE2\x82\xAC\x80", 3}
+};
+
+static void test_utf8(
+    jg_t * jg
+) {
+    static char json_text[TEST_UTF8_MAX_PAD_C + 64];
+    for (size_t i = 0; i < sizeof(utf8_seqs) / sizeof(*utf8_seqs); i++) {
+        char const * seq = utf8_seqs[i].seq;
+        size_t seq_byte_c = strlen(seq);
+        for (size_t pad_c = 0; pad_c <= TEST_UTF8_MAX_PAD_C; pad_c++) {
+            snprintf(json_text, sizeof(json_text), "\"%.*s%s%.40s\"",
+                (int) pad_c, "0123456789012345678901234567890123456789"
+                "012345678901234567890123456789", seq,
+                "0123456789012345678901234567890123456789");
+            jg_ret ret = parse_with_opt(jg, NULL, json_text);
+            if (utf8_seqs[i].bad_i == SIZE_MAX) {
+                jg_strview v = {0};
+                CHECK_RET(ret, JG_OK);
+                CHECK_RET(jg_root_get_strview(jg, NULL, &v), JG_OK);
+                CHECK(v.byte_c == pad_c + seq_byte_c + 40 &&
+                    !memcmp(v.str + pad_c, seq, seq_byte_c));
+                continue;
+            }
+            CHECK_RET(ret, JG_E_PARSE_STR_UTF8_INVALID);
+            // Counting chars as lead bytes, like jg_get_err_str() does
+            size_t char_c = 2 + pad_c;
+            for (size_t j = 0; j < utf8_seqs[i].bad_i; j++) {
+                char_c += ((uint8_t) seq[j] & 0xC0) != 0x80;
+            }
+            char where[64];
+            snprintf(where, sizeof(where), "[LINE 1, CHAR %zu]", char_c);
+            if (!strstr(jg_get_err_str(jg, "<", ">"), where)) {
+                fprintf(stderr, "%s:%d: sequence %zu after %zu chars: %s\n",
+                    __FILE__, __LINE__, i, pad_c, jg_get_err_str(jg, "<", ">"));
+                fail_c++;
+            }
+        }
+    }
+}
+
+//##############################################################################
+//## jg_parse_file_mmap() ######################################################
+
+#define TEST_MMAP_FILEPATH "jg_test_mmap.json"
+#define TEST_MMAP_BYTE_C 0x1000 // The smallest page size there is
+
+// Each text is padded at its front to fill a page, such that it ends right at
+// the end of its mapping, where reading even a byte too far would fault.
+static char const * const mmap_json_texts[] = {
+    "[\"a\\nb\", 1.5e3, {\"k\\u0065y\": null}, [true, false]]",
+    "-1234567890.5",
+    "\"\\ud83d\\ude00\"",
+    "[\"unterminated",
+    "{\"a\": tru",
+    "[1, 2",
+    "" // An empty file
+};
+
+// jg_parse_file_mmap() parses the same as jg_parse_callerstr() of the same
+// (read-only) text, or fails the same. (jg_parse_file() would differ in error
+// context, because of the newline it appends to its copy.)
+static void test_parse_file_mmap(
+    jg_t * jg
+) {
+    jg_t * str_jg = jg_init();
+    CHECK(str_jg);
+    if (!str_jg) {
+        return;
+    }
+    static char json_text[TEST_MMAP_BYTE_C];
+    static struct test_dump dump;
+    static struct test_dump mmap_dump;
+    jg_opt_parse const opts[] = {{0}, {.tape = true}, {.lazy = true},
+        {.unescape_in_place = true}}; // Not to write to the read-only mapping
+    size_t text_c = sizeof(mmap_json_texts) / sizeof(*mmap_json_texts);
+    for (size_t i = 0; i < text_c; i++) {
+        size_t byte_c = strlen(mmap_json_texts[i]);
+        size_t pad_byte_c = byte_c ? TEST_MMAP_BYTE_C - byte_c : 0;
+        memset(json_text, ' ', pad_byte_c);
+        memcpy(json_text + pad_byte_c, mmap_json_texts[i], byte_c);
+        if (!write_file(TEST_MMAP_FILEPATH, json_text, pad_byte_c + byte_c)) {
+            continue;
+        }
+        for (size_t j = 0; j < sizeof(opts) / sizeof(*opts); j++) {
+            jg_reinit(str_jg);
+            CHECK_RET(jg_parse_set_opt(str_jg, opts + j), JG_OK);
+            jg_ret ret = jg_parse_callerstr(str_jg, json_text,
+                pad_byte_c + byte_c);
+            jg_reinit(jg);
+            CHECK_RET(jg_parse_set_opt(jg, opts + j), JG_OK);
+            CHECK_RET(jg_parse_file_mmap(jg, TEST_MMAP_FILEPATH), ret);
+            if (ret != JG_OK) {
+                CHECK(!strcmp(jg_get_err_str(jg, "<", ">"),
+                    jg_get_err_str(str_jg, "<", ">")));
+                continue;
+            }
+            dump.byte_c = 0;
+            dump_val(str_jg, NULL, NULL, 0, &dump);
+            mmap_dump.byte_c = 0;
+            dump_val(jg, NULL, NULL, 0, &mmap_dump);
+            CHECK(!strcmp(mmap_dump.str, dump.str));
+        }
+    }
+    remove(TEST_MMAP_FILEPATH);
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+    CHECK_RET(jg_parse_file_mmap(jg, TEST_MMAP_FILEPATH), JG_E_ERRNO_FOPEN);
+    jg_free(str_jg);
+}
+
+//##############################################################################
+//## .lazy #####################################################################
+
+static void test_lazy(
+    jg_t * jg
+) {
+    char const * json_text =
+        "{\"a\": [1, {\"b\": [2, 3]}], \"c\": {\"d\": {\"e\": 4}}, \"f\": 5}";
+    CHECK_PARSE(parse_with_opt(jg, &(jg_opt_parse){.lazy = true}, json_text));
+    jg_obj_get_t * root = NULL;
+    CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+    jg_obj_get_t * obj = NULL;
+    CHECK_RET(jg_obj_get_obj(jg, root, "c", NULL, &obj), JG_OK);
+    CHECK_RET(jg_obj_get_obj(jg, obj, "d", NULL, &obj), JG_OK);
+    int v = 0;
+    CHECK_RET(jg_obj_get_int(jg, obj, "e", NULL, &v), JG_OK);
+    CHECK(v == 4);
+    jg_arr_get_t * arr = NULL;
+    size_t elem_c = 0;
+    CHECK_RET(jg_obj_get_arr(jg, root, "a", NULL, &arr, &elem_c), JG_OK);
+    CHECK(elem_c == 2);
+    CHECK_RET(jg_arr_get_obj(jg, arr, 1, NULL, &obj), JG_OK);
+    CHECK_RET(jg_obj_get_arr(jg, obj, "b", NULL, &arr, &elem_c), JG_OK);
+    CHECK(elem_c == 2);
+    CHECK_RET(jg_arr_get_int(jg, arr, 1, NULL, &v), JG_OK);
+    CHECK(v == 3);
+    CHECK_RET(jg_obj_get_int(jg, root, "f", NULL, &v), JG_OK);
+    CHECK(v == 5);
+
+    // Lazy parsing still validates the entire JSON text.
+    CHECK_RET(parse_with_opt(jg, &(jg_opt_parse){.lazy = true},
+        "{\"a\": [1, {\"b\": [2, 3}]}"), JG_E_PARSE_ARR_INVALID_SEP);
+    CHECK_RET(parse_with_opt(jg, &(jg_opt_parse){.lazy = true},
+        "{\"a\": {\"b\": 1, \"b\": 2}}"), JG_E_PARSE_OBJ_DUPLICATE_KEY);
+}
+
+#define TEST_LAZY_PAD_C 40 // Enough for "big" to exceed JG_LAZY_SKIP_MIN_BYTE_C
+
+// Nest innermost 5 deep, within arrays and objects large enough to be skipped
+static void print_lazy_json_text(
+    char * buf,
+    size_t size,
+    char const * innermost
+) {
+    size_t byte_c = snprintf(buf, size, "{\"a\": {\"big\": [");
+    for (size_t i = 0; i < TEST_LAZY_PAD_C; i++) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, "\"pad %zu\", ", i);
+    }
+    snprintf(buf + byte_c, size - byte_c, "{\"x\": %s}]}, \"b\": 1}",
+        innermost);
+}
+
+// Get key of the last element of "big", or the error doing so
+static jg_ret get_lazy_innermost(
+    jg_t * jg,
+    char const * key
+) {
+    jg_obj_get_t * obj = NULL;
+    jg_arr_get_t * arr = NULL;
+    size_t elem_c = 0;
+    int v = 0;
+    JG_GUARD(jg_root_get_obj(jg, NULL, &obj));
+    JG_GUARD(jg_obj_get_obj(jg, obj, "a", NULL, &obj));
+    JG_GUARD(jg_obj_get_arr(jg, obj, "big", NULL, &arr, &elem_c));
+    JG_GUARD(jg_arr_get_obj(jg, arr, elem_c - 1, NULL, &obj));
+    return jg_obj_get_int(jg, obj, key, NULL, &v);
+}
+
+// Whether lazy parsing skipped a container or not, parse and getter errors are
+// reported the same as when parsing eagerly (also when gotten again); and .lazy
+// is ignored in tape mode.
+static void test_lazy_errors(
+    jg_t * jg
+) {
+    jg_t * eager_jg = jg_init();
+    CHECK(eager_jg);
+    if (!eager_jg) {
+        return;
+    }
+    char const * const innermosts[] = {"[1, 2]", "[1 2]", "[1, falze]",
+        "{\"k\": 1, \"k\": 2}", "[1, \"unterminated", "[[[[1]]]]"};
+    static char json_text[0x1000];
+    jg_opt_parse const opt = {.max_depth = 6};
+    jg_opt_parse const lazy_opt = {.max_depth = 6, .lazy = true};
+    for (size_t i = 1; i < sizeof(innermosts) / sizeof(*innermosts); i++) {
+        print_lazy_json_text(json_text, sizeof(json_text), innermosts[i]);
+        jg_ret ret = parse_with_opt(eager_jg, &opt, json_text);
+        CHECK(ret != JG_OK);
+        CHECK_RET(parse_with_opt(jg, &lazy_opt, json_text), ret);
+        CHECK(!strcmp(jg_get_err_str(jg, "<", ">"),
+            jg_get_err_str(eager_jg, "<", ">")));
+    }
+
+    print_lazy_json_text(json_text, sizeof(json_text), innermosts[0]);
+    CHECK_PARSE(parse_with_opt(eager_jg, &opt, json_text));
+    CHECK_PARSE(parse_with_opt(jg, &lazy_opt, json_text));
+    char const * const keys[] = {"x", "y"};
+    jg_ret const rets[] = {JG_E_GET_NOT_NUM, JG_E_GET_OBJ_KEY_NOT_FOUND};
+    for (size_t i = 0; i < 2; i++) {
+        CHECK_RET(get_lazy_innermost(eager_jg, keys[i]), rets[i]);
+        // An error string can only be gotten once (its custom part is freed).
+        char err_str[0x200];
+        snprintf(err_str, sizeof(err_str), "%s",
+            jg_get_err_str(eager_jg, "<", ">"));
+        for (size_t j = 0; j < 2; j++) { // The first time parses the skipped.
+            CHECK_RET(get_lazy_innermost(jg, keys[i]), rets[i]);
+            CHECK(!strcmp(jg_get_err_str(jg, "<", ">"), err_str));
+        }
+    }
+    static struct test_dump dump;
+    static struct test_dump lazy_dump;
+    dump.byte_c = 0;
+    dump_val(eager_jg, NULL, NULL, 0, &dump);
+    for (size_t i = 0; i < 2; i++) {
+        if (i) {
+            CHECK_PARSE(parse_with_opt(jg, &(jg_opt_parse){.tape = true,
+                .lazy = true}, json_text));
+            CHECK_RET(jg_save_image(jg, "jg_test.image"), JG_OK);
+            remove("jg_test.image");
+        }
+        lazy_dump.byte_c = 0;
+        dump_val(jg, NULL, NULL, 0, &lazy_dump);
+        CHECK(!strcmp(lazy_dump.str, dump.str));
+    }
+    jg_free(eager_jg);
+}
+
+// The keys of a nested object must not be mistaken for duplicates of the keys
+// of the object enclosing it, in either tree or tape mode.
+static void test_nested_same_key(
+    jg_t * jg
+) {
+    char const * json_text = "{\"a\": {\"b\": 1}, \"b\": 2}";
+    jg_opt_parse const opts[] = {{0}, {.tape = true}, {.lazy = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        jg_obj_get_t * root = NULL;
+        CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+        int v = 0;
+        CHECK_RET(jg_obj_get_int(jg, root, "b", NULL, &v), JG_OK);
+        CHECK(v == 2);
+        jg_obj_get_t * obj = NULL;
+        CHECK_RET(jg_obj_get_obj(jg, root, "a", NULL, &obj), JG_OK);
+        CHECK_RET(jg_obj_get_int(jg, obj, "b", NULL, &v), JG_OK);
+        CHECK(v == 1);
+        CHECK_RET(parse_with_opt(jg, opts + i,
+            "{\"a\": {\"b\": 1}, \"b\": 2, \"b\": 3}"),
+            JG_E_PARSE_OBJ_DUPLICATE_KEY);
+    }
+}
+
+//##############################################################################
+//## Key lookups and their index ###############################################
+
+#define TEST_INDEX_MAX_KEY_C 200
+
+// Key i, as written in the JSON text (escaped or not), or as looked up
+static void print_index_key(
+    char * buf,
+    size_t size,
+    size_t i,
+    bool is_json
+) {
+    if (i % 11 == 5) {
+        snprintf(buf, size, "\xC3\xA9%zu", i); // Non-ASCII
+    } else if (i % 7 == 3 && is_json) {
+        snprintf(buf, size, "\\u006B%zu", i); // An escaped "k"
+    } else {
+        snprintf(buf, size, "k%zu", i);
+    }
+}
+
+// Objects with fewer keys than JG_INDEX_MIN_KEY_C are searched, the others
+// looked up through their index: either way, every key is found by its
+// unescaped form (in any order), and keys absent are not.
+static void test_key_index(
+    jg_t * jg
+) {
+    static char json_text[TEST_INDEX_MAX_KEY_C * 32];
+    size_t const key_cs[] = {JG_INDEX_MIN_KEY_C - 1, JG_INDEX_MIN_KEY_C,
+        JG_INDEX_MIN_KEY_C + 1, TEST_INDEX_MAX_KEY_C};
+    jg_opt_parse const opts[] = {{0}, {.tape = true}, {.lazy = true},
+        {.trust_unique_keys = true}, {.tape = true, .trust_unique_keys = true},
+        {.unescape_in_place = true}};
+    char key[32];
+    for (size_t i = 0; i < sizeof(key_cs) / sizeof(*key_cs); i++) {
+        size_t key_c = key_cs[i];
+        // Nested in an array, as lazy mode only defers nested objects
+        size_t byte_c = snprintf(json_text, sizeof(json_text), "[{");
+        for (size_t j = 0; j < key_c; j++) {
+            print_index_key(key, sizeof(key), j, true);
+            byte_c += snprintf(json_text + byte_c, sizeof(json_text) - byte_c,
+                "%s\"%s\": %zu", j ? ", " : "", key, j);
+        }
+        snprintf(json_text + byte_c, sizeof(json_text) - byte_c, "}]");
+        for (size_t j = 0; j < sizeof(opts) / sizeof(*opts); j++) {
+            CHECK_PARSE(parse_with_opt(jg, opts + j, json_text));
+            jg_arr_get_t * arr = NULL;
+            jg_obj_get_t * obj = NULL;
+            CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+            CHECK_RET(jg_arr_get_obj(jg, arr, 0, NULL, &obj), JG_OK);
+            for (size_t k = 0; k < key_c; k++) {
+                size_t key_i = k * 37 % key_c; // 37 being prime: out of order
+                print_index_key(key, sizeof(key), key_i, false);
+                size_t v = 0;
+                CHECK_RET(jg_obj_get_sizet(jg, obj, key, NULL, &v), JG_OK);
+                CHECK(v == key_i);
+            }
+            print_index_key(key, sizeof(key), key_c, false);
+            char const * const absent_keys[] = {key, "", "k", "K0", "k00",
+                "k1 ", "\\u006B3", "\xC3\xA9", "\xC3\xA9" "6"};
+            for (size_t k = 0; k < sizeof(absent_keys) / sizeof(*absent_keys);
+                k++) {
+                size_t v = 0;
+                CHECK_RET(jg_obj_get_sizet(jg, obj, absent_keys[k], NULL, &v),
+                    JG_E_GET_OBJ_KEY_NOT_FOUND);
+            }
+        }
+    }
+}
+
+//##############################################################################
+//## Duplicate keys ############################################################
+
+// An object of key_c "k<i>" keys (with values i), where key dup_i repeats key
+// orig_i: escaped if is_esc. Returns the offset of the repeated key.
+static size_t print_dup_json_text(
+    char * buf,
+    size_t size,
+    size_t key_c,
+    size_t orig_i,
+    size_t dup_i,
+    bool is_esc
+) {
+    size_t byte_c = snprintf(buf, size, "[{");
+    size_t dup_offset = 0;
+    for (size_t i = 0; i < key_c; i++) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, i ? ", " : "");
+        if (i == dup_i) {
+            dup_offset = byte_c;
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                is_esc ? "\"\\u006B%zu\": %zu" : "\"k%zu\": %zu", orig_i, i);
+        } else {
+            byte_c += snprintf(buf + byte_c, size - byte_c, "\"k%zu\": %zu", i,
+                i);
+        }
+    }
+    snprintf(buf + byte_c, size - byte_c, "}]");
+    return dup_offset;
+}
+
+// Whether keys are compared one by one or through an index, a duplicate key is
+// rejected where it occurs, even if it's escaped differently; unless unique
+// keys are trusted, in which case the first of the pairs is gotten.
+static void test_dup_keys(
+    jg_t * jg
+) {
+    static char json_text[0x1000];
+    size_t const key_cs[] = {3, JG_INDEX_MIN_KEY_C - 1, JG_INDEX_MIN_KEY_C,
+        100};
+    jg_opt_parse const opts[] = {{0}, {.tape = true}, {.lazy = true}};
+    for (size_t i = 0; i < sizeof(key_cs) / sizeof(*key_cs); i++) {
+        size_t key_c = key_cs[i];
+        size_t const pairs[][2] = {{0, 1}, {0, key_c - 1}, {key_c - 2,
+            key_c - 1}, {key_c / 2, key_c / 2 + 1}};
+        for (size_t j = 0; j < sizeof(pairs) / sizeof(*pairs); j++) {
+            for (int is_esc = 0; is_esc < 2; is_esc++) {
+                size_t dup_offset = print_dup_json_text(json_text,
+                    sizeof(json_text), key_c, pairs[j][0], pairs[j][1],
+                    is_esc);
+                // The error is marked at the ':' following the repeated key.
+                char where[64];
+                snprintf(where, sizeof(where), "[LINE 1, CHAR %zu]",
+                    strchr(json_text + dup_offset, ':') - json_text + 1);
+                for (size_t k = 0; k < sizeof(opts) / sizeof(*opts); k++) {
+                    CHECK_RET(parse_with_opt(jg, opts + k, json_text),
+                        JG_E_PARSE_OBJ_DUPLICATE_KEY);
+                    CHECK(strstr(jg_get_err_str(jg, "<", ">"), where));
+                    jg_opt_parse opt = opts[k];
+                    opt.trust_unique_keys = true;
+                    CHECK_PARSE(parse_with_opt(jg, &opt, json_text));
+                    jg_arr_get_t * arr = NULL;
+                    jg_obj_get_t * obj = NULL;
+                    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+                    CHECK_RET(jg_arr_get_obj(jg, arr, 0, NULL, &obj), JG_OK);
+                    char key[32];
+                    snprintf(key, sizeof(key), "k%zu", pairs[j][0]);
+                    size_t v = 0;
+                    CHECK_RET(jg_obj_get_sizet(jg, obj, key, NULL, &v), JG_OK);
+                    CHECK(v == pairs[j][0]);
+                }
+            }
+        }
+    }
+
+    // Each session seeds its own hash, so keys that collide in one session
+    // (as chosen by whoever wrote the JSON text) don't collide in another.
+    jg_t * other_jg = jg_init();
+    CHECK(other_jg);
+    if (other_jg) {
+        CHECK_PARSE(parse_with_opt(jg, NULL, "{}"));
+        CHECK_PARSE(parse_with_opt(other_jg, NULL, "{}"));
+        CHECK(jg->hash_seed != other_jg->hash_seed);
+        CHECK(hash_unesc_str(jg->hash_seed, (uint8_t const *) "k", 1) !=
+            hash_unesc_str(other_jg->hash_seed, (uint8_t const *) "k", 1));
+        jg_free(other_jg);
+    }
+}
+
+//##############################################################################
+//## Arena allocation ##########################################################
+
+#define TEST_ARENA_STR_C 20000 // An array larger than the 1st arena chunk
+#define TEST_ARENA_OBJ_C 5000 // Containers filling many arena chunks
+
+enum test_arena_text {
+    TEST_ARENA_STRS,
+    TEST_ARENA_OBJS,
+    TEST_ARENA_SMALL
+};
+
+static size_t get_arena_elem_c(
+    enum test_arena_text text
+) {
+    return text == TEST_ARENA_STRS ? TEST_ARENA_STR_C :
+        text == TEST_ARENA_OBJS ? TEST_ARENA_OBJ_C : 1;
+}
+
+static size_t print_arena_json_text(
+    char * buf,
+    size_t size,
+    enum test_arena_text text
+) {
+    char const * format = text == TEST_ARENA_STRS ? "%s\"s%zu\\n\"" :
+        text == TEST_ARENA_OBJS ? "%s{\"i\": %zu, \"a\": [\"t\\t\"]}" :
+        "%s%zu";
+    size_t byte_c = snprintf(buf, size, "[");
+    for (size_t i = 0; i < get_arena_elem_c(text) && byte_c < size; i++) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, format,
+            i ? ", " : "", i);
+    }
+    if (byte_c < size) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, "]");
+    }
+    return byte_c;
+}
+
+static void check_arena_text(
+    jg_t * jg,
+    enum test_arena_text text
+) {
+    jg_arr_get_t * arr = NULL;
+    size_t elem_c = 0;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, &elem_c), JG_OK);
+    jg_strview first = {0};
+    char expect[32];
+    for (size_t i = 0; i < elem_c; i++) {
+        jg_strview v = {0};
+        jg_obj_get_t * obj = NULL;
+        jg_arr_get_t * obj_arr = NULL;
+        size_t v_i = 0;
+        switch (text) {
+        case TEST_ARENA_STRS:
+            CHECK_RET(jg_arr_get_strview(jg, arr, i, NULL, &v), JG_OK);
+            snprintf(expect, sizeof(expect), "s%zu\n", i);
+            CHECK(v.byte_c == strlen(expect) &&
+                !memcmp(v.str, expect, v.byte_c));
+            if (!i) {
+                first = v;
+            }
+            break;
+        case TEST_ARENA_OBJS:
+            CHECK_RET(jg_arr_get_obj(jg, arr, i, NULL, &obj), JG_OK);
+            CHECK_RET(jg_obj_get_sizet(jg, obj, "i", NULL, &v_i), JG_OK);
+            CHECK(v_i == i);
+            CHECK_RET(jg_obj_get_arr(jg, obj, "a", NULL, &obj_arr, NULL),
+                JG_OK);
+            CHECK_RET(jg_arr_get_strview(jg, obj_arr, 0, NULL, &v), JG_OK);
+            CHECK(v.byte_c == 2 && !memcmp(v.str, "t\t", 2));
+            break;
+        default:
+            CHECK_RET(jg_arr_get_sizet(jg, arr, i, NULL, &v_i), JG_OK);
+            CHECK(v_i == i);
+        }
+    }
+    CHECK(elem_c == get_arena_elem_c(text));
+    // Views unescaped into the arena stay put as later ones fill new chunks.
+    CHECK(text != TEST_ARENA_STRS || (first.byte_c == 3 &&
+        !memcmp(first.str, "s0\n", 3)));
+}
+
+// Reinitializing jg reuses its arena chunks for the next DOM, whichever size
+// each is, be it with all chunks retained or only those within a byte budget.
+static void test_arena(
+    jg_t * jg
+) {
+    static char json_text[TEST_ARENA_STR_C * 16];
+    enum test_arena_text const texts[] = {TEST_ARENA_STRS, TEST_ARENA_SMALL,
+        TEST_ARENA_OBJS, TEST_ARENA_STRS, TEST_ARENA_OBJS, TEST_ARENA_SMALL,
+        TEST_ARENA_OBJS, TEST_ARENA_STRS};
+    jg_opt_parse const opts[] = {{0}, {.max_retained_byte_c = 0x10000}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        for (size_t j = 0; j < sizeof(texts) / sizeof(*texts); j++) {
+            jg_reinit(jg);
+            CHECK_RET(jg_parse_set_opt(jg, opts + i), JG_OK);
+            size_t byte_c = print_arena_json_text(json_text,
+                sizeof(json_text), texts[j]);
+            CHECK_PARSE(jg_parse_str(jg, json_text, byte_c));
+            check_arena_text(jg, texts[j]);
+        }
+    }
+    jg_reinit(jg);
+}
+
+//##############################################################################
+//## .tape #####################################################################
+
+#define TEST_TAPE_ARR_C 12 // More than JG_TAPE_CURSOR_C, so cursors get evicted
+#define TEST_TAPE_ELEM_C 25
+#define TEST_TAPE_GET_C 2000
+
+// A root array of arrays whose elements include nested arrays and objects,
+// which the tape has to skip over to get to the next element
+static void print_tape_json_text(
+    char * buf,
+    size_t size,
+    size_t seed
+) {
+    size_t byte_c = snprintf(buf, size, "[");
+    for (size_t i = 0; i < TEST_TAPE_ARR_C; i++) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, "%s[", i ? ", " : "");
+        for (size_t j = 0; j < TEST_TAPE_ELEM_C; j++) {
+            size_t n = seed + i * TEST_TAPE_ELEM_C + j;
+            char const * sep = j ? ", " : "";
+            switch (n % 5) {
+            case 0:
+                byte_c += snprintf(buf + byte_c, size - byte_c, "%s%zu", sep,
+                    n);
+                break;
+            case 1:
+                byte_c += snprintf(buf + byte_c, size - byte_c, "%s\"s\\n%zu\"",
+                    sep, n);
+                break;
+            case 2:
+                byte_c += snprintf(buf + byte_c, size - byte_c,
+                    "%s[%zu, [[%zu], {}], []]", sep, n, n);
+                break;
+            case 3:
+                byte_c += snprintf(buf + byte_c, size - byte_c,
+                    "%s{\"k\": %zu, \"n\": [{\"k\": [%zu]}]}", sep, n, n);
+                break;
+            default:
+                byte_c += snprintf(buf + byte_c, size - byte_c, "%s%s", sep,
+                    n % 2 ? "true" : "null");
+            }
+        }
+        byte_c += snprintf(buf + byte_c, size - byte_c, "]");
+    }
+    snprintf(buf + byte_c, size - byte_c, "]");
+}
+
+// Getting elements from the tape in any order (which moves its cached cursors
+// backward, forward, and between arrays) must get the same as from the tree;
+// also after the tape got reused by parsing another text.
+static void test_tape(
+    jg_t * jg
+) {
+    jg_t * tape_jg = jg_init();
+    CHECK(tape_jg);
+    if (!tape_jg) {
+        return;
+    }
+    static char json_text[TEST_TAPE_ARR_C * TEST_TAPE_ELEM_C * 48];
+    static struct test_dump dump;
+    static struct test_dump tape_dump;
+    for (size_t seed = 0; seed < 2; seed++) {
+        print_tape_json_text(json_text, sizeof(json_text), seed);
+        CHECK_PARSE(parse_with_opt(jg, NULL, json_text));
+        CHECK_PARSE(parse_with_opt(tape_jg, &(jg_opt_parse){.tape = true},
+            json_text));
+        jg_arr_get_t * root = NULL;
+        jg_arr_get_t * tape_root = NULL;
+        CHECK_RET(jg_root_get_arr(jg, NULL, &root, NULL), JG_OK);
+        CHECK_RET(jg_root_get_arr(tape_jg, NULL, &tape_root, NULL), JG_OK);
+        uint32_t rand = 17;
+        for (size_t k = 0; k < TEST_TAPE_GET_C; k++) {
+            rand = rand * 1103515245 + 12345;
+            size_t i = (rand >> 8) % TEST_TAPE_ARR_C;
+            // Every other array in reverse, the rest randomly
+            size_t j = i % 2 ? TEST_TAPE_ELEM_C - 1 - k % TEST_TAPE_ELEM_C :
+                (rand >> 16) % TEST_TAPE_ELEM_C;
+            jg_arr_get_t * arr = NULL;
+            jg_arr_get_t * tape_arr = NULL;
+            CHECK_RET(jg_arr_get_arr(jg, root, i, NULL, &arr, NULL), JG_OK);
+            CHECK_RET(jg_arr_get_arr(tape_jg, tape_root, i, NULL, &tape_arr,
+                NULL), JG_OK);
+            dump.byte_c = 0;
+            tape_dump.byte_c = 0;
+            dump_val(jg, NULL, arr, j, &dump);
+            dump_val(tape_jg, NULL, tape_arr, j, &tape_dump);
+            if (strcmp(tape_dump.str, dump.str)) {
+                fprintf(stderr, "%s:%d: [%zu][%zu] from the tape: %s\n"
+                    "instead of: %s\n", __FILE__, __LINE__, i, j,
+                    tape_dump.str, dump.str);
+                fail_c++;
+                break;
+            }
+        }
+        CHECK_RET(jg_arr_get_arr(tape_jg, tape_root, TEST_TAPE_ARR_C, NULL,
+            &(jg_arr_get_t *){NULL}, NULL), JG_E_GET_ARR_INDEX_OVER);
+    }
+    jg_free(tape_jg);
+}
+
+//##############################################################################
+//## .max_depth ################################################################
+
+#define TEST_DEEP_DEPTH 100000 // Would overflow the C stack if recursed into
+
+// Nest arrays and objects in turn depth deep, around the number 7. Returns the
+// offset of the opener at depth max_depth + 1 (if any).
+static size_t print_nested_json_text(
+    char * buf,
+    size_t depth,
+    size_t max_depth
+) {
+    size_t byte_c = 0;
+    size_t err_i = 0;
+    for (size_t i = 0; i < depth; i++) {
+        if (i == max_depth) {
+            err_i = byte_c;
+        }
+        byte_c += sprintf(buf + byte_c, i % 2 ? "{\"k\": " : "[");
+    }
+    byte_c += sprintf(buf + byte_c, "7");
+    while (depth--) {
+        buf[byte_c++] = depth % 2 ? '}' : ']';
+    }
+    buf[byte_c] = '\0';
+    return err_i;
+}
+
+// Nesting up to .max_depth deep parses, and nesting any deeper is rejected at
+// the first opener too many, in every mode. Without a limit, nesting too deep
+// to recurse into parses (and gets freed) all the same.
+static void test_max_depth(
+    jg_t * jg
+) {
+    static char json_text[TEST_DEEP_DEPTH * 8];
+    jg_opt_parse opts[] = {{0}, {.tape = true}, {.lazy = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        for (size_t max_depth = 1; max_depth <= 4; max_depth++) {
+            opts[i].max_depth = max_depth;
+            for (size_t depth = 1; depth <= 6; depth++) {
+                size_t err_i = print_nested_json_text(json_text, depth,
+                    max_depth);
+                jg_ret ret = parse_with_opt(jg, opts + i, json_text);
+                if (depth <= max_depth) {
+                    CHECK_RET(ret, JG_OK);
+                    continue;
+                }
+                CHECK_RET(ret, JG_E_PARSE_MAX_DEPTH);
+                char where[64];
+                snprintf(where, sizeof(where), "[LINE 1, CHAR %zu] %.*s<%c>",
+                    err_i + 1, (int) err_i, json_text, json_text[err_i]);
+                CHECK(strstr(jg_get_err_str(jg, "<", ">"), where));
+            }
+        }
+        opts[i].max_depth = 0;
+        print_nested_json_text(json_text, TEST_DEEP_DEPTH, 0);
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        opts[i].max_depth = TEST_DEEP_DEPTH - 1;
+        CHECK_RET(parse_with_opt(jg, opts + i, json_text),
+            JG_E_PARSE_MAX_DEPTH);
+        opts[i].max_depth = 0;
+    }
+
+    // Getters can walk all the way down.
+    CHECK_PARSE(parse_with_opt(jg, NULL, json_text));
+    jg_arr_get_t * arr = NULL;
+    jg_obj_get_t * obj = NULL;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+    for (size_t i = 1; arr && i < TEST_DEEP_DEPTH; i++) {
+        if (i % 2) {
+            CHECK_RET(jg_arr_get_obj(jg, arr, 0, NULL, &obj), JG_OK);
+        } else {
+            CHECK_RET(jg_obj_get_arr(jg, obj, "k", NULL, &arr, NULL), JG_OK);
+        }
+    }
+    int v = 0; // TEST_DEEP_DEPTH being even, the innermost is an object.
+    CHECK_RET(jg_obj_get_int(jg, obj, "k", NULL, &v), JG_OK);
+    CHECK(v == 7);
+
+    // Feeding in chunks rejects nesting too deep the same.
+    print_nested_json_text(json_text, 6, 3);
+    CHECK_RET(parse_with_opt(jg, &(jg_opt_parse){.max_depth = 3}, json_text),
+        JG_E_PARSE_MAX_DEPTH);
+    char err_str[0x200];
+    snprintf(err_str, sizeof(err_str), "%s", jg_get_err_str(jg, "<", ">"));
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, &(jg_opt_parse){.max_depth = 3}), JG_OK);
+    CHECK_RET(jg_parse_begin(jg, 0), JG_OK);
+    jg_ret ret = JG_OK;
+    for (size_t i = 0; ret == JG_OK && json_text[i]; i += 2) {
+        ret = jg_parse_feed(jg, json_text + i, json_text[i + 1] ? 2 : 1);
+    }
+    if (ret == JG_OK) {
+        ret = jg_parse_end(jg);
+    }
+    CHECK_RET(ret, JG_E_PARSE_MAX_DEPTH);
+    // The same up to the error mark: what follows it may not be fed yet.
+    CHECK(!strncmp(jg_get_err_str(jg, "<", ">"), err_str,
+        strchr(err_str, '>') + 1 - err_str));
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+}
+
+//##############################################################################
+//## jg_arr_get_<type>_array() #################################################
+
+static void test_arr_get_array(
+    jg_t * jg
+) {
+    CHECK_PARSE(parse_with_opt(jg, NULL, "[1, 2, 3, \"4\", 5]"));
+    jg_arr_get_t * arr = NULL;
+    size_t elem_c = 0;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, &elem_c), JG_OK);
+    CHECK(elem_c == 5);
+    int v[3] = {0};
+    size_t c = 3;
+    CHECK_RET(jg_arr_get_int_array(jg, arr, 0, NULL, v, &c), JG_OK);
+    CHECK(c == 3 && v[0] == 1 && v[1] == 2 && v[2] == 3);
+    // The failing element is the one at index arr_i + *elem_c.
+    c = 3;
+    CHECK_RET(jg_arr_get_int_array(jg, arr, 1, NULL, v, &c),
+        JG_E_GET_NOT_NUM);
+    CHECK(c == 2 && v[0] == 2 && v[1] == 3);
+    // Nothing is gotten if the range exceeds the array.
+    c = 3;
+    CHECK_RET(jg_arr_get_int_array(jg, arr, 7, NULL, v, &c),
+        JG_E_GET_ARR_INDEX_OVER);
+    CHECK(c == 0);
+    c = 3;
+    CHECK_RET(jg_arr_get_int_array(jg, arr, 3, NULL, v, &c),
+        JG_E_GET_ARR_INDEX_OVER);
+    CHECK(c == 0);
+    c = 3;
+    CHECK_RET(jg_arr_get_double_array(jg, arr, 0, NULL, &c),
+        JG_E_GET_ARG_IS_NULL);
+    CHECK(c == 0);
+}
+
+//##############################################################################
+//## jg_[root|arr]_get_[float|double|long_double]() ############################
+
+// Hard cases for the Eisel-Lemire fast path and its strto[f|d|ld]() fallback
+static char const * const flo_json_texts[] = {
+    "0", "-0", "1", "-1", "0.1", "1e23", "-1e23", "123456789e-300",
+    // Exactly halfway between 2 doubles: round to even
+    "9007199254740993", "9007199254740995", "4503599627370496.5",
+    "4503599627370497.5",
+    "1.00000000000000011102230246251565404236316680908203125",
+    // Just below and above halfway
+    "9007199254740992.9999", "9007199254740993.0001",
+    // Exactly halfway between 2 floats
+    "16777217", "16777219", "33554434", "33554438",
+    // Double boundaries
+    "2.2250738585072014e-308", // The smallest normal
+    "2.2250738585072009e-308", // The largest subnormal
+    "2.2250738585072011e-308", "2.225073858507201136057409796709131975934e-308",
+    "4.9406564584124654e-324", // The smallest subnormal
+    "5e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+    "1e-323", "-4.9406564584124654e-324",
+    "1.7976931348623157e308", // The largest
+    "1.7976931348623158e308", "1.7976931348623159e308",
+    // Float boundaries
+    "1.17549435e-38", "1.1754942e-38", "1.4e-45", "7e-46", "7.1e-46",
+    "3.4028235e38", "3.40282356e38", "3.4028236e38",
+    // Underflow and overflow
+    "1e-400", "-1e-400", "1e400", "-1e400", "0e400", "1e-999999999",
+    "1e999999999", "0.0000000000000000000000000000000000000001e-300",
+    // More significant digits (19+) than fit in 64 bits: the fallback path
+    "12345678901234567890", "123456789012345678901234567890",
+    "1.2345678901234567890123e-5", "9007199254740993.00000000000000000001",
+    "0.30000000000000000000000000000000000000000000000001",
+    "18446744073709551615", "18446744073709551616", "18446744073709551617",
+    "9999999999999999999", "99999999999999999999e-20",
+    "1.00000005960464477550", "1.0000000596046447755000000000000001",
+    "2.4703282292062327208828439643411068618252990130716238221279284125033775"
+        "3635104375932649918180817996189898282347722858865463328355177969898199"
+        "3873980053909390631503565951557022639229085839244910518443593180284993"
+        "6536152500319370457678249219365623669863658480757001585769269903706311"
+        "9282795585513329278343384093519780155312465972635795746227664652728272"
+        "2005637400648549997709659947045402082816622623785739345073633900796776"
+        "1930577506740176324673600968951340535537458516661134223766678604162159"
+        "6804619144672918403005300575308490487653917113865916462395249126236538"
+        "8187963623937328042389101867234849766823508986338858792562830275599565"
+        "7524455507255189313690836254779186948667994968324049705821028513185451"
+        "3962138377228261454376934125320985913276672363281255e-324"
+};
+
+// Compare each getter's result bit for bit with strto[f|d|ld]() of the same
+// text, which is what the getters used to return; including a range error.
+#define CHECK_FLO(_get_call, _str_to_flo_func, _type, _e_out_of_range) do { \
+    _type expected = 0; \
+    _type v = 0; \
+    errno = 0; \
+    expected = _str_to_flo_func(num, NULL); \
+    if (errno) { \
+        CHECK_RET(_get_call, _e_out_of_range); \
+    } else { \
+        CHECK_RET(_get_call, JG_OK); \
+        if (!is_same_##_str_to_flo_func(v, expected)) { \
+            fprintf(stderr, "%s:%d: %s of %s returned %La instead of %La\n", \
+                __FILE__, __LINE__, #_get_call, num, (long double) v, \
+                (long double) expected); \
+            fail_c++; \
+        } \
+    } \
+} while (0)
+
+static bool is_same_strtof(
+    float v,
+    float expected
+) {
+    return !memcmp(&v, &expected, sizeof(v));
+}
+
+static bool is_same_strtod(
+    double v,
+    double expected
+) {
+    return !memcmp(&v, &expected, sizeof(v));
+}
+
+// Don't memcmp() the padding of e.g. x87 long doubles.
+static bool is_same_strtold(
+    long double v,
+    long double expected
+) {
+    return v == expected && signbit(v) == signbit(expected);
+}
+
+static void test_get_flo(
+    jg_t * jg
+) {
+    jg_opt_parse const opts[] = {{0}, {.decode_numbers = true},
+        {.tape = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        for (size_t j = 0; j < sizeof(flo_json_texts) /
+            sizeof(*flo_json_texts); j++) {
+            char const * num = flo_json_texts[j];
+            char json_text[2048];
+            snprintf(json_text, sizeof(json_text), "[%s]", num);
+            CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+            jg_arr_get_t * arr = NULL;
+            CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+            CHECK_FLO(jg_arr_get_float(jg, arr, 0, &v), strtof, float,
+                JG_E_GET_NUM_FLOAT_OUT_OF_RANGE);
+            CHECK_FLO(jg_arr_get_double(jg, arr, 0, &v), strtod, double,
+                JG_E_GET_NUM_DOUBLE_OUT_OF_RANGE);
+            CHECK_FLO(jg_arr_get_long_double(jg, arr, 0, &v), strtold,
+                long double, JG_E_GET_NUM_LONG_DOUBLE_OUT_OF_RANGE);
+            CHECK_PARSE(parse_with_opt(jg, opts + i, num));
+            CHECK_FLO(jg_root_get_double(jg, &v), strtod, double,
+                JG_E_GET_NUM_DOUBLE_OUT_OF_RANGE);
+        }
+    }
+}
+
+//##############################################################################
+//## jg_[root|arr|obj]_get_<integer_type>() ####################################
+
+// Integers around the boundaries of each width, and numbers that aren't
+// integers (or whose exponent makes them ones)
+static char const * const int_json_texts[] = {
+    "0", "-0", "1", "-1", "127", "128", "-128", "-129", "255", "256",
+    "32767", "32768", "-32769", "65535", "65536", "2147483647", "2147483648",
+    "-2147483648", "-2147483649", "4294967295", "4294967296",
+    "99999999", "100000000", "1234567812345678", "9007199254740993",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+    "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+    "-18446744073709551616", "99999999999999999999", "1.0", "1.5",
+    "-0.0", "1e2", "1E+2", "1e-2", "10e-1", "1e400"
+};
+
+// The 64-bit getters around their boundaries, where the 8-digit steps of
+// skip_digits() overflow. Magnitudes saturate like strto[u]imax() results do,
+// so the extreme values themselves are out of range too.
+static struct {
+    char const * json_text;
+    jg_ret int64_ret;
+    int64_t int64;
+    jg_ret uint64_ret;
+    uint64_t uint64;
+} const int_bounds[] = {
+    {"12345678", JG_OK, 12345678, JG_OK, 12345678},
+    {"-1234567812345678", JG_OK, -1234567812345678,
+        JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"12345678123456789", JG_OK, 12345678123456789,
+        JG_OK, 12345678123456789},
+    {"9223372036854775806", JG_OK, INT64_MAX - 1, JG_OK, INT64_MAX - 1},
+    {"9223372036854775807", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_OK, INT64_MAX},
+    {"9223372036854775808", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_OK, (uint64_t) INT64_MAX + 1},
+    {"-9223372036854775807", JG_OK, INT64_MIN + 1,
+        JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"-9223372036854775808", JG_E_GET_NUM_SIGNED_TOO_SMALL, 0,
+        JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"-9223372036854775809", JG_E_GET_NUM_SIGNED_TOO_SMALL, 0,
+        JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"18446744073709551614", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_OK, UINT64_MAX - 1},
+    {"18446744073709551615", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_E_GET_NUM_UNSIGNED_TOO_LARGE, 0},
+    {"18446744073709551616", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_E_GET_NUM_UNSIGNED_TOO_LARGE, 0},
+    {"184467440737095516160000", JG_E_GET_NUM_SIGNED_TOO_LARGE, 0,
+        JG_E_GET_NUM_UNSIGNED_TOO_LARGE, 0},
+    {"-100000000000000000000000", JG_E_GET_NUM_SIGNED_TOO_SMALL, 0,
+        JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"-0", JG_OK, 0, JG_E_GET_NUM_NOT_UNSIGNED, 0},
+    {"1e3", JG_E_GET_NUM_NOT_INTEGER, 0, JG_E_GET_NUM_NOT_INTEGER, 0}
+};
+
+static void test_get_int_bounds(
+    jg_t * jg
+) {
+    jg_opt_parse const opts[] = {{0}, {.decode_numbers = true},
+        {.tape = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        for (size_t j = 0; j < sizeof(int_bounds) / sizeof(*int_bounds);
+            j++) {
+            CHECK_PARSE(parse_with_opt(jg, opts + i,
+                int_bounds[j].json_text));
+            int64_t i64 = 0;
+            uint64_t u64 = 0;
+            CHECK_RET(jg_root_get_int64(jg, NULL, &i64),
+                int_bounds[j].int64_ret);
+            CHECK(int_bounds[j].int64_ret || i64 == int_bounds[j].int64);
+            CHECK_RET(jg_root_get_uint64(jg, NULL, &u64),
+                int_bounds[j].uint64_ret);
+            CHECK(int_bounds[j].uint64_ret || u64 == int_bounds[j].uint64);
+        }
+    }
+}
+
+#define CHECK_SAME_INT(_suf, _type) do { \
+    _type v = 0; \
+    _type dec_v = 0; \
+    jg_ret ret = jg_arr_get##_suf(jg, arr, i, NULL, &v); \
+    CHECK_RET(jg_arr_get##_suf(dec_jg, dec_arr, i, NULL, &dec_v), ret); \
+    CHECK(v == dec_v); \
+    if (ret != JG_OK) { \
+        CHECK(!strcmp(jg_get_err_str(dec_jg, "<", ">"), \
+            jg_get_err_str(jg, "<", ">"))); \
+    } \
+} while (0)
+
+// The numbers that .decode_numbers decodes up front must get each integer
+// getter the same value or error as converting their JSON text does.
+static void test_decode_numbers(
+    jg_t * jg
+) {
+    jg_t * dec_jg = jg_init();
+    CHECK(dec_jg);
+    if (!dec_jg) {
+        return;
+    }
+    static char json_text[0x2000];
+    size_t byte_c = snprintf(json_text, sizeof(json_text), "[");
+    size_t int_c = sizeof(int_json_texts) / sizeof(*int_json_texts);
+    size_t flo_c = sizeof(flo_json_texts) / sizeof(*flo_json_texts);
+    for (size_t i = 0; i < int_c + flo_c; i++) {
+        byte_c += snprintf(json_text + byte_c, sizeof(json_text) - byte_c,
+            "%s%s", i ? ", " : "", i < int_c ? int_json_texts[i] :
+            flo_json_texts[i - int_c]);
+    }
+    snprintf(json_text + byte_c, sizeof(json_text) - byte_c, "]");
+    CHECK_PARSE(parse_with_opt(jg, NULL, json_text));
+    CHECK_PARSE(parse_with_opt(dec_jg, &(jg_opt_parse){.decode_numbers = true},
+        json_text));
+    jg_arr_get_t * arr = NULL;
+    jg_arr_get_t * dec_arr = NULL;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+    CHECK_RET(jg_root_get_arr(dec_jg, NULL, &dec_arr, NULL), JG_OK);
+    for (size_t i = 0; i < int_c + flo_c; i++) {
+        CHECK_SAME_INT(_int8, int8_t);
+        CHECK_SAME_INT(_short, short);
+        CHECK_SAME_INT(_int32, int32_t);
+        CHECK_SAME_INT(_long, long);
+        CHECK_SAME_INT(_int64, int64_t);
+        CHECK_SAME_INT(_intmax, intmax_t);
+        CHECK_SAME_INT(_uint8, uint8_t);
+        CHECK_SAME_INT(_unsigned_short, unsigned short);
+        CHECK_SAME_INT(_uint32, uint32_t);
+        CHECK_SAME_INT(_sizet, size_t);
+        CHECK_SAME_INT(_uint64, uint64_t);
+        CHECK_SAME_INT(_uintmax, uintmax_t);
+    }
+    jg_free(dec_jg);
+}
+
+//##############################################################################
+//## jg_parse_[begin|feed|end]() ###############################################
+
+// Whatever the chunk boundaries, feeding must give the same DOM as parsing the
+// whole text at once; including where a boundary splits an escape sequence
+// (e.g., between '\' and '"', or within "😀") or a number.
+static void test_feed(
+    jg_t * jg
+) {
+    char const * json_text =
+        "{\"esc\": \"a\\\"b\\\\c\\/d\\n\\t\", \"k\\u0065y\": \"v\",\n"
+        "  \"uni\": \"\\u00e9\\u4E2D\\ud83d\\ude00x\",\n"
+        "  \"nums\": [0, -12345678901234, 3.14159e-10, 1E+5, -0.0, 1e400],\n"
+        "  \"nested\": {\"arr\": [true, false, null, [], {}, [[1.5]]]},\n"
+        "  \"long\": \"0123456789abcdef0123456789abcdef0123456789abcdef"
+        "0123456789abcdef0123456789abcdef0123456789abcdef\"} // Done\n";
+    size_t byte_c = strlen(json_text);
+    size_t const chunk_byte_cs[] = {1, 7, byte_c};
+    jg_opt_parse const opts[] = {{0}, {.tape = true}};
+    static struct test_dump dump;
+    static struct test_dump fed_dump;
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        dump.byte_c = 0;
+        dump_val(jg, NULL, NULL, 0, &dump);
+        for (size_t j = 0; j < sizeof(chunk_byte_cs) / sizeof(*chunk_byte_cs);
+            j++) {
+            size_t chunk_byte_c = chunk_byte_cs[j];
+            jg_reinit(jg);
+            CHECK_RET(jg_parse_set_opt(jg, opts + i), JG_OK);
+            CHECK_RET(jg_parse_begin(jg, 0), JG_OK);
+            for (size_t k = 0; k < byte_c; k += chunk_byte_c) {
+                CHECK_RET(jg_parse_feed(jg, json_text + k, byte_c - k <
+                    chunk_byte_c ? byte_c - k : chunk_byte_c), JG_OK);
+            }
+            CHECK_PARSE(jg_parse_end(jg));
+            fed_dump.byte_c = 0;
+            dump_val(jg, NULL, NULL, 0, &fed_dump);
+            if (strcmp(fed_dump.str, dump.str)) {
+                fprintf(stderr, "%s:%d: fed in %zu-byte chunks: %s\n"
+                    "instead of: %s\n", __FILE__, __LINE__, chunk_byte_c,
+                    fed_dump.str, dump.str);
+                fail_c++;
+            }
+        }
+    }
+    // The split tokens really are what they seem (which the dump compares).
+    jg_obj_get_t * root = NULL;
+    CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+    jg_strview v = {0};
+    CHECK_RET(jg_obj_get_strview(jg, root, "esc", NULL, &v), JG_OK);
+    CHECK(v.byte_c == 9 && !memcmp(v.str, "a\"b\\c/d\n\t", 9));
+    CHECK_RET(jg_obj_get_strview(jg, root, "uni", NULL, &v), JG_OK);
+    CHECK(v.byte_c == 10 && !memcmp(v.str, "\xC3\xA9\xE4\xB8\xAD"
+        "\xF0\x9F\x98\x80x", 10));
+    CHECK_RET(jg_obj_get_strview(jg, root, "key", NULL, &v), JG_OK);
+    CHECK(v.byte_c == 1 && *v.str == 'v');
+}
+
+//##############################################################################
+//## jg_parse_ndjson_...() #####################################################
+
+#define TEST_NDJSON_LINE_C 300
+
+// Every 10th line (from the 3rd) is blank, every 10th (from the 6th) consists
+// of whitespace only, and every 17th (unless blank) is a malformed record.
+static size_t print_ndjson_text(
+    char * buf,
+    size_t size
+) {
+    size_t byte_c = 0;
+    for (size_t line_i = 1; line_i <= TEST_NDJSON_LINE_C; line_i++) {
+        char const * line = line_i % 10 == 3 ? "" :
+            line_i % 10 == 6 ? " \t " : line_i % 17 ? NULL : "{\"line\": }";
+        byte_c += line ? snprintf(buf + byte_c, size - byte_c, "%s\n", line) :
+            snprintf(buf + byte_c, size - byte_c, "{\"line\": %zu}\n", line_i);
+    }
+    return byte_c;
+}
+
+static bool is_ndjson_rec(
+    size_t line_i
+) {
+    return line_i % 10 != 3 && line_i % 10 != 6;
+}
+
+// Check that the record at line_i parsed (or failed to parse) as it should.
+static bool check_ndjson_rec(
+    jg_t * jg,
+    size_t line_i,
+    jg_ret ret
+) {
+    if (!is_ndjson_rec(line_i)) {
+        return false;
+    }
+    if (line_i % 17 == 0) {
+        char expected[64];
+        snprintf(expected, sizeof(expected), "[LINE %zu, CHAR 10]", line_i);
+        return ret == JG_E_PARSE_INVALID_TYPE &&
+            strstr(jg_get_err_str(jg, NULL, NULL), expected);
+    }
+    jg_obj_get_t * obj = NULL;
+    size_t v = 0;
+    return ret == JG_OK && jg_root_get_obj(jg, NULL, &obj) == JG_OK &&
+        jg_obj_get_sizet(jg, obj, "line", NULL, &v) == JG_OK && v == line_i;
+}
+
+// Per line: CRLF, whitespace-only and empty lines, a record broken over 2
+// lines (each failing on its own), and a final line without a newline
+static char const ndjson_lines_text[] =
+    "{\"a\": \"x\\ny\"}\r\n"
+    " \t\r\n"
+    "\n"
+    "[1,\n"
+    "2]\n"
+    "  7  \n"
+    "\"last\"";
+
+static void check_ndjson_lines(
+    jg_t * jg
+) {
+    size_t line_i = 0;
+    jg_obj_get_t * obj = NULL;
+    jg_strview v = {0};
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+    CHECK(line_i == 1);
+    CHECK_RET(jg_root_get_obj(jg, NULL, &obj), JG_OK);
+    CHECK_RET(jg_obj_get_strview(jg, obj, "a", NULL, &v), JG_OK);
+    CHECK(v.byte_c == 3 && !memcmp(v.str, "x\ny", 3));
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_E_PARSE_UNTERM_ARR);
+    CHECK(line_i == 4);
+    CHECK(strstr(jg_get_err_str(jg, "<", ">"), "[LINE 4, CHAR 1] <[>1,"));
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_E_PARSE_ROOT_SURPLUS);
+    CHECK(line_i == 5);
+    CHECK(strstr(jg_get_err_str(jg, "<", ">"), "[LINE 5, CHAR 2] 2<]>"));
+    int i = 0;
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+    CHECK(line_i == 6);
+    CHECK_RET(jg_root_get_int(jg, NULL, &i), JG_OK);
+    CHECK(i == 7);
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+    CHECK(line_i == 7);
+    CHECK_RET(jg_root_get_strview(jg, NULL, &v), JG_OK);
+    CHECK(v.byte_c == 4 && !memcmp(v.str, "last", 4));
+    for (size_t j = 0; j < 2; j++) { // Done, and stays done
+        CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+        CHECK(line_i == 0);
+    }
+}
+
+// Each of the 3 ways to start parsing NDJSON splits it into the same records,
+// with each record parsed with the options set for jg.
+static void test_ndjson_lines(
+    jg_t * jg
+) {
+    char const * filepath = "jg_test.ndjson";
+    size_t byte_c = sizeof(ndjson_lines_text) - 1;
+    if (!write_file(filepath, ndjson_lines_text, byte_c)) {
+        return;
+    }
+    jg_opt_parse const opts[] = {{0}, {.tape = true},
+        {.decode_numbers = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        for (size_t j = 0; j < 3; j++) {
+            jg_reinit(jg);
+            CHECK_RET(jg_parse_set_opt(jg, opts + i), JG_OK);
+            CHECK_PARSE(j == 0 ? jg_parse_ndjson_str(jg, ndjson_lines_text,
+                byte_c) : j == 1 ? jg_parse_ndjson_callerstr(jg,
+                ndjson_lines_text, byte_c) : jg_parse_ndjson_file(jg,
+                filepath));
+            check_ndjson_lines(jg);
+        }
+    }
+    remove(filepath);
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+    CHECK_PARSE(jg_parse_ndjson_str(jg, " \n\n", 3)); // No records at all
+    size_t line_i = 1;
+    CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+    CHECK(line_i == 0);
+    jg_reinit(jg);
+}
+
+struct test_ndjson_cb_arg {
+    // Written only by the thread that claimed the line
+    unsigned char cb_c[TEST_NDJSON_LINE_C + 1]; // Each line's callback count
+    bool is_bad[TEST_NDJSON_LINE_C + 1]; // Whether the line failed its check
+    // Only used if ordered, where callbacks are never concurrent
+    size_t last_line_i;
+    bool is_out_of_order;
+    bool is_ordered;
+    size_t stop_line_i; // Return false for this line (if nonzero)
+};
+
+static bool test_ndjson_cb(
+    jg_t * jg,
+    size_t line_i,
+    jg_ret ret,
+    void * arg
+) {
+    struct test_ndjson_cb_arg * cb_arg = arg;
+    if (line_i > TEST_NDJSON_LINE_C) {
+        return false;
+    }
+    cb_arg->cb_c[line_i]++;
+    cb_arg->is_bad[line_i] = !check_ndjson_rec(jg, line_i, ret);
+    if (cb_arg->is_ordered) {
+        cb_arg->is_out_of_order |= line_i <= cb_arg->last_line_i;
+        cb_arg->last_line_i = line_i;
+    }
+    return line_i != cb_arg->stop_line_i;
+}
+
+static void test_ndjson(
+    jg_t * jg
+) {
+    static char ndjson_text[TEST_NDJSON_LINE_C * 32];
+    size_t byte_c = print_ndjson_text(ndjson_text, sizeof(ndjson_text));
+    jg_reinit(jg);
+    CHECK_PARSE(jg_parse_ndjson_str(jg, ndjson_text, byte_c));
+    size_t expected_line_i = 0;
+    for (;;) {
+        while (!is_ndjson_rec(++expected_line_i));
+        size_t line_i = 0;
+        jg_ret ret = jg_parse_ndjson_next(jg, &line_i);
+        if (!line_i) {
+            break;
+        }
+        CHECK(line_i == expected_line_i);
+        CHECK(check_ndjson_rec(jg, line_i, ret));
+    }
+    CHECK(expected_line_i > TEST_NDJSON_LINE_C);
+
+    for (size_t i = 0; i < 4; i++) {
+        static struct test_ndjson_cb_arg cb_arg;
+        cb_arg = (struct test_ndjson_cb_arg) {.is_ordered = i % 2};
+        jg_opt_ndjson const opt = {.thread_c = i < 2 ? 1 : 4,
+            .is_ordered = cb_arg.is_ordered};
+        jg_reinit(jg);
+        CHECK_PARSE(jg_parse_ndjson_callerstr(jg, ndjson_text, byte_c));
+        CHECK_RET(jg_parse_ndjson_parallel(jg, &opt, NULL, NULL),
+            JG_E_GET_ARG_IS_NULL);
+        CHECK_RET(jg_parse_ndjson_parallel(jg, &opt, test_ndjson_cb, &cb_arg),
+            JG_OK);
+        CHECK(!cb_arg.is_out_of_order);
+        for (size_t line_i = 1; line_i <= TEST_NDJSON_LINE_C; line_i++) {
+            CHECK(cb_arg.cb_c[line_i] == is_ndjson_rec(line_i));
+            CHECK(!cb_arg.is_bad[line_i]);
+        }
+        size_t line_i = 1;
+        CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+        CHECK(!line_i);
+
+        // Stop at a line, then resume with jg_parse_ndjson_next() after the
+        // lines already handed out: each line gets parsed at most once.
+        cb_arg = (struct test_ndjson_cb_arg) {.is_ordered = i % 2,
+            .stop_line_i = 99};
+        jg_reinit(jg);
+        CHECK_PARSE(jg_parse_ndjson_callerstr(jg, ndjson_text, byte_c));
+        CHECK_RET(jg_parse_ndjson_parallel(jg, &opt, test_ndjson_cb, &cb_arg),
+            JG_OK);
+        CHECK(!cb_arg.is_out_of_order);
+        CHECK(cb_arg.cb_c[99] == 1);
+        for (size_t line_i = 1; line_i <= TEST_NDJSON_LINE_C; line_i++) {
+            CHECK(!cb_arg.is_bad[line_i]);
+        }
+        CHECK(!opt.is_ordered || cb_arg.last_line_i == 99);
+        size_t resume_line_i = 0;
+        for (;;) {
+            jg_ret ret = jg_parse_ndjson_next(jg, &line_i);
+            if (!line_i) {
+                break;
+            }
+            CHECK(line_i > 99 && !cb_arg.cb_c[line_i]);
+            CHECK(check_ndjson_rec(jg, line_i, ret));
+            resume_line_i = resume_line_i ? resume_line_i : line_i;
+        }
+        // With a single thread, the rest of the stopped batch is skipped:
+        // lines 97 to 128 if ordered, or the 256 lines of the batch if not.
+        if (opt.thread_c == 1) {
+            CHECK(resume_line_i == (opt.is_ordered ? 129 : 257));
+        }
+    }
+}
+
+//##############################################################################
+//## jg_obj_iter_[begin|next|get_key]() and jg_val_get_...() ###################
+
+static void test_obj_iter(
+    jg_t * jg
+) {
+    char const * json_text = "{\"i\": -7, \"f\": 2.5, \"s\\u00e9\": \"x\\ty\", "
+        "\"t\": true, \"n\": null, \"a\": [1, 2], \"o\": {\"k\": 3}, "
+        "\"q\": {}}";
+    jg_opt_parse const opts[] = {{0}, {.tape = true}, {.lazy = true},
+        {.decode_numbers = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        jg_obj_get_t * root = NULL;
+        CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+        jg_obj_iter it = {0};
+        CHECK_RET(jg_obj_iter_begin(jg, root, &it), JG_OK);
+        CHECK(it.pair_c == 8);
+        jg_strview key = {0};
+
+        CHECK(it.key.byte_c == 1 && *it.key.str == 'i');
+        int64_t i64 = 0;
+        CHECK_RET(jg_val_get_int64(jg, it.val, NULL, &i64), JG_OK);
+        CHECK(i64 == -7);
+        uint8_t u8 = 0;
+        CHECK_RET(jg_val_get_uint8(jg, it.val, NULL, &u8),
+            JG_E_GET_NUM_NOT_UNSIGNED);
+        enum jg_type type = JG_TYPE_NULL;
+        CHECK_RET(jg_val_get_json_type(jg, it.val, &type), JG_OK);
+        CHECK(type == JG_TYPE_NUM);
+
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        double d = 0.0;
+        CHECK_RET(jg_val_get_double(jg, it.val, &d), JG_OK);
+        CHECK(d == 2.5);
+        CHECK_RET(jg_val_get_int64(jg, it.val, NULL, &i64),
+            JG_E_GET_NUM_NOT_INTEGER);
+
+        // The key is viewed as is, or unescaped with jg_obj_iter_get_key().
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        CHECK(it.key.byte_c == 7 && !memcmp(it.key.str, "s\\u00e9", 7));
+        CHECK_RET(jg_obj_iter_get_key(jg, &it, &key), JG_OK);
+        CHECK(key.byte_c == 3 && !memcmp(key.str, "s\xC3\xA9", 3));
+        jg_strview sv = {0};
+        CHECK_RET(jg_val_get_strview(jg, it.val, NULL, &sv), JG_OK);
+        CHECK(sv.byte_c == 3 && !memcmp(sv.str, "x\ty", 3));
+        char * str = NULL;
+        CHECK_RET(jg_val_get_str(jg, it.val, NULL, &str), JG_OK);
+        CHECK(str && !strcmp(str, "x\ty"));
+        free(str);
+        str = NULL;
+        CHECK_RET(jg_val_get_json_str(jg, it.val, NULL, &str), JG_OK);
+        CHECK(str && !strcmp(str, "x\\ty"));
+        free(str);
+        CHECK_RET(jg_val_get_double(jg, it.val, &d), JG_E_GET_NOT_NUM);
+
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        CHECK_RET(jg_obj_iter_get_key(jg, &it, &key), JG_OK);
+        CHECK(key.byte_c == 1 && key.str == it.key.str); // Nothing to unescape
+        bool b = false;
+        CHECK_RET(jg_val_get_bool(jg, it.val, &b), JG_OK);
+        CHECK(b);
+        CHECK_RET(jg_val_get_null(jg, it.val), JG_E_GET_NOT_NULL);
+
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        CHECK_RET(jg_val_get_null(jg, it.val), JG_OK);
+
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        jg_arr_get_t * arr = NULL;
+        size_t elem_c = 0;
+        CHECK_RET(jg_val_get_arr(jg, it.val, &(jg_val_arr){.max_c = 1}, &arr,
+            &elem_c), JG_E_GET_ARR_TOO_LONG);
+        CHECK_RET(jg_val_get_arr(jg, it.val, NULL, &arr, &elem_c), JG_OK);
+        int v = 0;
+        CHECK(elem_c == 2);
+        CHECK_RET(jg_arr_get_int(jg, arr, 1, NULL, &v), JG_OK);
+        CHECK(v == 2);
+
+        // A value gotten from a pair remains valid as the iterator moves on.
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        jg_obj_get_t * obj = NULL;
+        CHECK_RET(jg_val_get_obj(jg, it.val, NULL, &obj), JG_OK);
+        jg_val_get_t * val = it.val;
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        jg_obj_iter child_it = {0};
+        CHECK_RET(jg_obj_iter_begin(jg, obj, &child_it), JG_OK);
+        CHECK(child_it.pair_c == 1);
+        CHECK_RET(jg_val_get_int(jg, child_it.val, NULL, &v), JG_OK);
+        CHECK(v == 3);
+        CHECK_RET(jg_val_get_obj(jg, val, NULL, &obj), JG_OK);
+
+        // An empty object's iterator begins past its last pair, as the
+        // iterator of any object ends up.
+        CHECK_RET(jg_val_get_obj(jg, it.val, NULL, &obj), JG_OK);
+        CHECK_RET(jg_obj_iter_begin(jg, obj, &child_it), JG_OK);
+        CHECK(!child_it.pair_c && !child_it.val && !child_it.key.byte_c);
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        CHECK(!it.val);
+        CHECK_RET(jg_obj_iter_next(jg, &it), JG_OK);
+        CHECK(!it.val);
+        CHECK_RET(jg_obj_iter_get_key(jg, &it, &key), JG_E_GET_ARG_IS_NULL);
+        CHECK_RET(jg_val_get_int(jg, it.val, NULL, &v), JG_E_GET_ARG_IS_NULL);
+    }
+}
+
+//##############################################################################
+//## .thread_c #################################################################
+
+#define TEST_PARALLEL_ELEM_C 40000 // Makes for well over 1 MiB of JSON text
+
+// Elements of every type, with strings and comments containing the brackets,
+// commas and quotes that the chunk scan of the root array must look past
+static size_t print_parallel_json_text(
+    char * buf,
+    size_t size
+) {
+    size_t byte_c = snprintf(buf, size, "[");
+    for (size_t i = 0; i < TEST_PARALLEL_ELEM_C; i++) {
+        char const * sep = i ? ",\n" : "";
+        switch (i % 5) {
+        case 0:
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                "%s{\"id\": %zu, \"name\": \"n\\\"%zu],\", \"tags\": [true, "
+                "false, null], \"k\\u00e9y\": -%zu.%zue-3}", sep, i, i, i, i);
+            break;
+        case 1:
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                "%s[%zu, [\"}\\\\\", {\"a\": [[]]}], {}] /* ], */", sep, i);
+            break;
+        case 2:
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                "%s\"str \\\\\\\"[%zu\"", sep, i);
+            break;
+        case 3:
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                "%s%zu.5 // , ]\n", sep, i);
+            break;
+        default:
+            byte_c += snprintf(buf + byte_c, size - byte_c,
+                "%s{\"deep\": {\"er\": {\"est\": [%zu, \"x\"]}}}", sep, i);
+        }
+    }
+    return byte_c + snprintf(buf + byte_c, size - byte_c, "]");
+}
+
+// Parse the same text with thread_c 0 and 4, and compare every root element.
+static void check_parallel_parse(
+    jg_t * jg,
+    jg_t * serial_jg,
+    jg_opt_parse opt,
+    char const * json_text,
+    size_t byte_c
+) {
+    opt.thread_c = 0;
+    jg_reinit(serial_jg);
+    CHECK_RET(jg_parse_set_opt(serial_jg, &opt), JG_OK);
+    jg_ret serial_ret = jg_parse_callerstr(serial_jg, json_text, byte_c);
+    opt.thread_c = 4;
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, &opt), JG_OK);
+    CHECK_RET(jg_parse_callerstr(jg, json_text, byte_c), serial_ret);
+    if (serial_ret != JG_OK) {
+        char const * err_str = jg_get_err_str(jg, "<", ">");
+        char const * serial_err_str = jg_get_err_str(serial_jg, "<", ">");
+        CHECK(!strcmp(err_str, serial_err_str));
+        return;
+    }
+    jg_arr_get_t * arr = NULL;
+    jg_arr_get_t * serial_arr = NULL;
+    size_t elem_c = 0;
+    size_t serial_elem_c = 0;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, &elem_c), JG_OK);
+    CHECK_RET(jg_root_get_arr(serial_jg, NULL, &serial_arr, &serial_elem_c),
+        JG_OK);
+    CHECK(elem_c == TEST_PARALLEL_ELEM_C && elem_c == serial_elem_c);
+    static struct test_dump dump;
+    static struct test_dump serial_dump;
+    for (size_t i = 0; i < elem_c && i < serial_elem_c; i++) {
+        dump.byte_c = 0;
+        serial_dump.byte_c = 0;
+        dump_val(jg, NULL, arr, i, &dump);
+        dump_val(serial_jg, NULL, serial_arr, i, &serial_dump);
+        if (dump.byte_c != serial_dump.byte_c ||
+            memcmp(dump.str, serial_dump.str, dump.byte_c)) {
+            fprintf(stderr, "%s:%d: element %zu differs: %s vs %s\n",
+                __FILE__, __LINE__, i, dump.str, serial_dump.str);
+            fail_c++;
+            return;
+        }
+    }
+}
+
+static void test_parallel(
+    jg_t * jg
+) {
+    jg_t * serial_jg = jg_init();
+    CHECK(serial_jg);
+    if (!serial_jg) {
+        return;
+    }
+    static char json_text[TEST_PARALLEL_ELEM_C * 128];
+    size_t byte_c = print_parallel_json_text(json_text, sizeof(json_text));
+    CHECK(byte_c > 0x100000);
+    // .thread_c is ignored in lazy mode, to the same effect.
+    jg_opt_parse const opts[] = {{0}, {.tape = true},
+        {.decode_numbers = true}, {.lazy = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        check_parallel_parse(jg, serial_jg, opts[i], json_text, byte_c);
+    }
+    // A syntax error deep inside one of the last chunks, which unlike a stray
+    // bracket (say) only a worker thread's parse of that chunk runs into
+    char * err = strstr(json_text + byte_c - byte_c / 8, "false");
+    CHECK(err);
+    if (err) {
+        err[3] = 'z';
+        for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+            check_parallel_parse(jg, serial_jg, opts[i], json_text, byte_c);
+        }
+        CHECK_RET(parse_with_opt(jg, &(jg_opt_parse){.thread_c = 4},
+            json_text), JG_E_PARSE_FALSE);
+    }
+    jg_free(serial_jg);
+}
+
+//##############################################################################
+//## jg_pool_...() #############################################################
+
+#define TEST_POOL_THREAD_C 4
+#define TEST_POOL_ROUND_C 200
+
+// Each round leaves the session in a different state for jg_pool_put(), after
+// having changed its parse options.
+static void * run_pool_thread(
+    void * arg
+) {
+    jg_pool_t * pool = arg;
+    for (size_t round = 0; round < TEST_POOL_ROUND_C; round++) {
+        jg_t * jg = jg_pool_get(pool);
+        CHECK(jg);
+        if (!jg) {
+            return NULL;
+        }
+        // Nothing is left of the previous parse, whichever it was.
+        int v = 0;
+        CHECK_RET(jg_root_get_int(jg, NULL, &v), JG_E_STATE_NOT_GET);
+        size_t line_i = 0;
+        CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_E_STATE_NOT_PARSE);
+        CHECK_RET(jg_parse_feed(jg, "1", 1), JG_E_STATE_NOT_PARSE);
+        // The pool's parse options apply again: .max_depth = 2
+        CHECK_RET(jg_parse_str(jg, "[[[1]]]", 7), JG_E_PARSE_MAX_DEPTH);
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, &(jg_opt_parse){.tape = round % 2,
+            .unescape_in_place = true}), JG_OK);
+        char json_text[64];
+        int byte_c = snprintf(json_text, sizeof(json_text),
+            "[[[%zu, \"\\u0041\"]]]", round);
+        switch (round % 4) {
+        case 0: { // Got
+            CHECK_RET(jg_parse_str(jg, json_text, byte_c), JG_OK);
+            jg_arr_get_t * arr = NULL;
+            CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+            CHECK_RET(jg_arr_get_arr(jg, arr, 0, NULL, &arr, NULL), JG_OK);
+            CHECK_RET(jg_arr_get_arr(jg, arr, 0, NULL, &arr, NULL), JG_OK);
+            CHECK_RET(jg_arr_get_int(jg, arr, 0, NULL, &v), JG_OK);
+            CHECK(v == (int) round);
+            break;
+        }
+        case 1: // Failed to parse
+            CHECK_RET(jg_parse_str(jg, json_text, byte_c - 1),
+                JG_E_PARSE_UNTERM_ARR);
+            CHECK(jg_get_err_str(jg, NULL, NULL));
+            break;
+        case 2: // Midway through feeding
+            CHECK_RET(jg_parse_begin(jg, 0), JG_OK);
+            CHECK_RET(jg_parse_feed(jg, json_text, 5), JG_OK);
+            break;
+        default: // Midway through NDJSON records
+            CHECK_RET(jg_parse_ndjson_str(jg, "[1]\n[2]\n", 8), JG_OK);
+            CHECK_RET(jg_parse_ndjson_next(jg, &line_i), JG_OK);
+            CHECK(line_i == 1);
+        }
+        jg_pool_put(pool, jg);
+    }
+    return NULL;
+}
+
+static void test_pool(
+    void
+) {
+    jg_pool_t * pool = jg_pool_init(&(jg_opt_pool){
+        .opt_parse = {.max_depth = 2},
+        .max_idle_c = 2
+    });
+    CHECK(pool);
+    if (!pool) {
+        return;
+    }
+    pthread_t threads[TEST_POOL_THREAD_C];
+    for (size_t i = 0; i < TEST_POOL_THREAD_C; i++) {
+        CHECK(!pthread_create(threads + i, NULL, run_pool_thread, pool));
+    }
+    for (size_t i = 0; i < TEST_POOL_THREAD_C; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    jg_pool_free(pool);
+}
+
+// The buffers jg_reinit() retained, as trim_retained() counts them
+static size_t get_retained_byte_c(
+    jg_t const * jg
+) {
+    size_t byte_c = jg->frame_size * sizeof(struct jg_frame) +
+        jg->stack_size * sizeof(struct jg_val_in) + jg->text_buf_byte_c +
+        jg->tape_size * sizeof(uint64_t) +
+        jg->obj_index_slot_c * sizeof(struct jg_obj_index_slot) +
+        jg->lazy_skip_size * sizeof(struct jg_lazy_skip);
+    for (struct jg_arena_chunk const * chunk = jg->arena_head; chunk;
+        chunk = chunk->next) {
+        byte_c += sizeof(struct jg_arena_chunk) + chunk->byte_c;
+    }
+    return byte_c;
+}
+
+#define TEST_RETAINED_BYTE_C 0x10000
+
+// What jg_reinit() retains of a large parse is trimmed to .max_retained_byte_c;
+// also when the text buffer retained from jg_parse_str() was left unused by a
+// jg_parse_callerstr() or jg_parse_file_mmap() in between.
+static void test_retention(
+    jg_t * jg
+) {
+    static char json_text[TEST_PARALLEL_ELEM_C * 128];
+    print_parallel_json_text(json_text, sizeof(json_text));
+    char const * small_json_text = "{\"a\": [1, 2, {\"b\": \"\\u0063\"}]}";
+    jg_opt_parse opts[] = {{0}, {.tape = true}, {.lazy = true},
+        {.decode_numbers = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        jg_reinit(jg);
+        CHECK(get_retained_byte_c(jg) > TEST_RETAINED_BYTE_C); // No cap yet
+        opts[i].max_retained_byte_c = TEST_RETAINED_BYTE_C;
+        CHECK_PARSE(parse_with_opt(jg, opts + i, json_text));
+        jg_reinit(jg);
+        CHECK(get_retained_byte_c(jg) <= TEST_RETAINED_BYTE_C);
+        CHECK_PARSE(parse_with_opt(jg, opts + i, small_json_text));
+        jg_obj_get_t * root = NULL;
+        CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+        jg_reinit(jg);
+        CHECK(get_retained_byte_c(jg) <= TEST_RETAINED_BYTE_C);
+        opts[i].max_retained_byte_c = 0;
+    }
+
+    char const * filepath = "jg_test.json";
+    FILE * f = fopen(filepath, "w");
+    CHECK(f);
+    if (!f) {
+        return;
+    }
+    fputs(small_json_text, f);
+    fclose(f);
+    for (size_t i = 0; i < 2; i++) {
+        CHECK_PARSE(parse_with_opt(jg, NULL, json_text));
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, &(jg_opt_parse){
+            .max_retained_byte_c = TEST_RETAINED_BYTE_C}), JG_OK);
+        if (i) {
+            CHECK_PARSE(jg_parse_file_mmap(jg, filepath));
+        } else {
+            CHECK_PARSE(jg_parse_callerstr(jg, small_json_text,
+                strlen(small_json_text)));
+        }
+        jg_reinit(jg); // Frees the unused text buffer
+        CHECK(get_retained_byte_c(jg) <= TEST_RETAINED_BYTE_C);
+        CHECK_PARSE(jg_parse_str(jg, small_json_text, strlen(small_json_text)));
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+    }
+    remove(filepath);
+}
+
+//##############################################################################
+//## .unescape_in_place ########################################################
+
+// Each bad string follows (and precedes) strings that would be unescaped in
+// place, had parsing succeeded.
+static struct {
+    char const * str;
+    jg_ret ret;
+} const bad_escs[] = {
+    {"\\x", JG_E_PARSE_STR_ESC_INVALID},
+    {"a\\'", JG_E_PARSE_STR_ESC_INVALID},
+    {"\\u12g4", JG_E_PARSE_STR_UTF16_INVALID},
+    {"\\udc00", JG_E_PARSE_STR_UTF16_UNPAIRED_LOW},
+    {"\\ud800x", JG_E_PARSE_STR_UTF16_UNPAIRED_HIGH},
+    {"\\ud800\\u0041", JG_E_PARSE_STR_UTF16_UNPAIRED_HIGH},
+    {"\t", JG_E_PARSE_STR_UNESC_CONTROL}
+};
+
+// A bad escape fails the same with or without .unescape_in_place, quoting the
+// JSON text as it was; after which the same jg parses and unescapes anew.
+static void test_unescape_in_place(
+    jg_t * jg
+) {
+    jg_t * ref_jg = jg_init();
+    CHECK(ref_jg);
+    if (!ref_jg) {
+        return;
+    }
+    jg_opt_parse const opt = {.unescape_in_place = true};
+    char json_text[128];
+    char ref_err_str[512];
+    for (size_t i = 0; i < sizeof(bad_escs) / sizeof(*bad_escs); i++) {
+        snprintf(json_text, sizeof(json_text), "[\"a\\n\", {\"k\\u0065y\": "
+            "\"b\\u00e9\"}, \"%s\", \"c\\t\"]", bad_escs[i].str);
+        CHECK_RET(parse_with_opt(ref_jg, NULL, json_text), bad_escs[i].ret);
+        snprintf(ref_err_str, sizeof(ref_err_str), "%s",
+            jg_get_err_str(ref_jg, "<", ">"));
+        CHECK_RET(parse_with_opt(jg, &opt, json_text), bad_escs[i].ret);
+        CHECK(!strcmp(jg_get_err_str(jg, "<", ">"), ref_err_str));
+    }
+    // Getters of the JSON string escape it anew, only where they must.
+    CHECK_PARSE(parse_with_opt(jg, &opt, "[\"a\\n\", {\"k\\u0065y\": "
+        "\"\\/\\u0041\\n\\\"\\\\\\u001f\\u00e9\"}]"));
+    jg_arr_get_t * arr = NULL;
+    CHECK_RET(jg_root_get_arr(jg, NULL, &arr, NULL), JG_OK);
+    char * str = NULL;
+    CHECK_RET(jg_arr_get_str(jg, arr, 0, NULL, &str), JG_OK);
+    CHECK(str && !strcmp(str, "a\n"));
+    free(str);
+    jg_obj_get_t * obj = NULL;
+    CHECK_RET(jg_arr_get_obj(jg, arr, 1, NULL, &obj), JG_OK);
+    CHECK_RET(jg_obj_get_str(jg, obj, "key", NULL, &str), JG_OK);
+    CHECK(str && !strcmp(str, "/A\n\"\\\x1F\xC3\xA9"));
+    free(str);
+    CHECK_RET(jg_obj_get_json_str(jg, obj, "key", NULL, &str), JG_OK);
+    CHECK(str && !strcmp(str, "/A\\n\\\"\\\\\\u001F\xC3\xA9"));
+    free(str);
+    jg_reinit(jg);
+    jg_free(ref_jg);
+}
+
+//##############################################################################
+//## jg_[root|arr|obj]_get_strview() ###########################################
+
+static char const strview_json_text[] = "{\"plain\": \"abc\", \"esc\": "
+    "\"a\\tb\\u00e9\", \"empty\": \"\", \"arr\": [\"x\\\"y\"], \"num\": 1}";
+
+// Views of strings without escapes point into the caller's JSON text itself;
+// those of escaped ones point to a fresh unescaped copy each time, unless the
+// strings were unescaped in place already.
+static void test_strview(
+    jg_t * jg
+) {
+    char const * text = strview_json_text;
+    size_t byte_c = sizeof(strview_json_text) - 1;
+    jg_opt_parse const opts[] = {{0}, {.tape = true},
+        {.unescape_in_place = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, opts + i), JG_OK);
+        bool is_in_place = opts[i].unescape_in_place;
+        CHECK_PARSE(is_in_place ? jg_parse_str(jg, text, byte_c) :
+            jg_parse_callerstr(jg, text, byte_c));
+        jg_obj_get_t * root = NULL;
+        CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+        jg_strview v = {0};
+        CHECK_RET(jg_obj_get_strview(jg, root, "plain", NULL, &v), JG_OK);
+        CHECK(v.byte_c == 3 && !memcmp(v.str, "abc", 3));
+        CHECK(is_in_place || v.str == strstr(text, "abc"));
+        jg_strview esc = {0};
+        CHECK_RET(jg_obj_get_strview(jg, root, "esc", NULL, &esc), JG_OK);
+        CHECK(esc.byte_c == 5 && !memcmp(esc.str, "a\tb\xC3\xA9", 5));
+        CHECK(is_in_place || esc.str < text || esc.str > text + byte_c);
+        CHECK_RET(jg_obj_get_strview(jg, root, "esc", NULL, &v), JG_OK);
+        CHECK(v.byte_c == 5 && !memcmp(v.str, "a\tb\xC3\xA9", 5));
+        CHECK(is_in_place ? v.str == esc.str : v.str != esc.str);
+        CHECK(!memcmp(esc.str, "a\tb\xC3\xA9", 5)); // Still valid
+        jg_arr_get_t * arr = NULL;
+        CHECK_RET(jg_obj_get_arr(jg, root, "arr", NULL, &arr, NULL), JG_OK);
+        CHECK_RET(jg_arr_get_strview(jg, arr, 0, NULL, &v), JG_OK);
+        CHECK(v.byte_c == 3 && !memcmp(v.str, "x\"y", 3));
+        CHECK_RET(jg_obj_get_strview(jg, root, "empty", NULL, &v), JG_OK);
+        CHECK(v.byte_c == 0 && v.str);
+        CHECK_RET(jg_obj_get_strview(jg, root, "empty",
+            &(jg_obj_strview){.nullify_empty_str = true}, &v), JG_OK);
+        CHECK(v.byte_c == 0 && !v.str);
+        char const * defa = "default";
+        CHECK_RET(jg_obj_get_strview(jg, root, "absent",
+            &(jg_obj_strview){.defa = defa}, &v), JG_OK);
+        CHECK(v.byte_c == 7 && v.str == defa);
+        size_t esc_byte_c = 0;
+        CHECK_RET(jg_obj_get_strview(jg, root, "esc", &(jg_obj_strview){
+            .byte_c = &esc_byte_c, .max_byte_c = 4}, &v),
+            JG_E_GET_STR_BYTE_C_TOO_MANY);
+        CHECK_RET(jg_obj_get_strview(jg, root, "esc", &(jg_obj_strview){
+            .byte_c = &esc_byte_c, .max_byte_c = 5}, &v), JG_OK);
+        CHECK(esc_byte_c == 5);
+        CHECK_RET(jg_obj_get_strview(jg, root, "num", NULL, &v),
+            JG_E_GET_NOT_STR);
+    }
+    jg_reinit(jg);
+}
+
+//##############################################################################
+//## jg_save_image() and jg_load_image() #######################################
+
+#define TEST_IMAGE_FILEPATH "jg_test.image"
+
+// Escaped keys stay escaped in an image, whereas escaped string values are
+// unescaped in place: also those nested inside arrays.
+static char const * const image_json_texts[] = {
+    "{\"k\\\"ey\": [\"a\\nb\", [\"\\u00e9\\t\", {\"\\u0078\": \"\\/\"}]],"
+    " \"plain\": [[[\"c\\\\d\"]], 1.5, true, null], \"e\\u0073c\": \"\\\"\"}",
+    "[\"\\ud83d\\ude00\", [], {}, [[\"x\\ry\"]]]",
+    "\"a\\nb\"",
+    "-12.5e3",
+    "true",
+    "null"
+};
+
+// Load the image saved from each text, and get the same values out of it as
+// out of the tape it was saved from.
+static void test_image(
+    jg_t * jg
+) {
+    static struct test_dump dump;
+    static struct test_dump image_dump;
+    size_t text_c = sizeof(image_json_texts) / sizeof(*image_json_texts);
+    for (size_t i = 0; i < text_c; i++) {
+        CHECK_PARSE(parse_with_opt(jg, &(jg_opt_parse){.tape = true},
+            image_json_texts[i]));
+        dump.byte_c = 0;
+        dump_val(jg, NULL, NULL, 0, &dump);
+        CHECK_PARSE(jg_save_image(jg, TEST_IMAGE_FILEPATH));
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+        CHECK_PARSE(jg_load_image(jg, TEST_IMAGE_FILEPATH));
+        image_dump.byte_c = 0;
+        dump_val(jg, NULL, NULL, 0, &image_dump);
+        if (strcmp(image_dump.str, dump.str)) {
+            fprintf(stderr, "%s:%d: loaded image: %s\ninstead of: %s\n",
+                __FILE__, __LINE__, image_dump.str, dump.str);
+            fail_c++;
+        }
+    }
+
+    // Lookups by unescaped key find the escaped keys of the first text's image.
+    jg_reinit(jg);
+    CHECK_PARSE(parse_with_opt(jg, &(jg_opt_parse){.tape = true},
+        image_json_texts[0]));
+    CHECK_PARSE(jg_save_image(jg, TEST_IMAGE_FILEPATH));
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+    CHECK_PARSE(jg_load_image(jg, TEST_IMAGE_FILEPATH));
+    jg_obj_get_t * root = NULL;
+    CHECK_RET(jg_root_get_obj(jg, NULL, &root), JG_OK);
+    jg_arr_get_t * arr = NULL;
+    CHECK_RET(jg_obj_get_arr(jg, root, "k\"ey", NULL, &arr, NULL), JG_OK);
+    jg_strview v = {0};
+    CHECK_RET(jg_arr_get_strview(jg, arr, 0, NULL, &v), JG_OK);
+    CHECK(v.byte_c == 3 && !memcmp(v.str, "a\nb", 3));
+    CHECK_RET(jg_obj_get_strview(jg, root, "esc", NULL, &v), JG_OK);
+    CHECK(v.byte_c == 1 && *v.str == '"');
+    jg_reinit(jg);
+}
+
+// A file that is truncated, isn't an image, or whose trailer doesn't add up is
+// rejected before anything it points to is read.
+static void test_image_invalid(
+    jg_t * jg
+) {
+    static uint8_t image[0x1000];
+    CHECK_PARSE(parse_with_opt(jg, &(jg_opt_parse){.tape = true},
+        image_json_texts[0]));
+    CHECK_PARSE(jg_save_image(jg, TEST_IMAGE_FILEPATH));
+    jg_reinit(jg);
+    FILE * f = fopen(TEST_IMAGE_FILEPATH, "rb");
+    CHECK(f);
+    if (!f) {
+        return;
+    }
+    size_t byte_c = fread(image, 1, sizeof(image), f);
+    fclose(f);
+    CHECK(byte_c > 3 * sizeof(uint64_t) && byte_c < sizeof(image));
+    size_t const truncated_byte_cs[] = {0, 4, 3 * sizeof(uint64_t),
+        byte_c - sizeof(uint64_t), byte_c - 1};
+    for (size_t i = 0;
+        i < sizeof(truncated_byte_cs) / sizeof(*truncated_byte_cs); i++) {
+        if (write_file(TEST_IMAGE_FILEPATH, image, truncated_byte_cs[i])) {
+            CHECK_RET(jg_load_image(jg, TEST_IMAGE_FILEPATH),
+                JG_E_IMAGE_INVALID);
+        }
+        jg_reinit(jg);
+    }
+    // Corrupt the trailer's magic, text_byte_c and tape_c in turn, and then the
+    // root entry's count of tape entries.
+    uint64_t text_byte_c = 0;
+    memcpy(&text_byte_c, image + byte_c - 3 * sizeof(uint64_t),
+        sizeof(text_byte_c));
+    size_t const corrupt_is[] = {byte_c - 1, byte_c - 3 * sizeof(uint64_t) +
+        3, byte_c - 2 * sizeof(uint64_t) + 3, (text_byte_c + 7) / 8 * 8 +
+        sizeof(uint64_t)};
+    for (size_t i = 0; i < sizeof(corrupt_is) / sizeof(*corrupt_is); i++) {
+        image[corrupt_is[i]] ^= 0x40;
+        if (write_file(TEST_IMAGE_FILEPATH, image, byte_c)) {
+            CHECK_RET(jg_load_image(jg, TEST_IMAGE_FILEPATH),
+                JG_E_IMAGE_INVALID);
+        }
+        jg_reinit(jg);
+        image[corrupt_is[i]] ^= 0x40;
+    }
+    if (write_file(TEST_IMAGE_FILEPATH, image, byte_c)) { // Intact again
+        CHECK_PARSE(jg_load_image(jg, TEST_IMAGE_FILEPATH));
+    }
+    jg_reinit(jg);
+    remove(TEST_IMAGE_FILEPATH);
+}
+
+//##############################################################################
+//## jg_freeze() and jg_parse_doc() ############################################
+
+#define TEST_DOC_OBJ_C 64
+#define TEST_DOC_KEY_C 20 // At least JG_INDEX_MIN_KEY_C, so as to be indexed
+#define TEST_DOC_READER_C 4
+
+// An array of objects with enough keys to be indexed
+static size_t print_doc_json_text(
+    char * buf,
+    size_t size
+) {
+    size_t byte_c = snprintf(buf, size, "[");
+    for (size_t i = 0; i < TEST_DOC_OBJ_C; i++) {
+        byte_c += snprintf(buf + byte_c, size - byte_c, "%s{", i ? ", " : "");
+        for (size_t j = 0; j < TEST_DOC_KEY_C; j++) {
+            byte_c += snprintf(buf + byte_c, size - byte_c, "%s\"k%zu\": %zu",
+                j ? ", " : "", j, i * TEST_DOC_KEY_C + j);
+        }
+        byte_c += snprintf(buf + byte_c, size - byte_c, "}");
+    }
+    return byte_c + snprintf(buf + byte_c, size - byte_c, "]");
+}
+
+// Get every value of the document from several readers in turn
+static void check_doc_readers(
+    jg_doc_t * doc
+) {
+    for (size_t r = 0; r < TEST_DOC_READER_C; r++) {
+        jg_t * reader = jg_init();
+        CHECK(reader);
+        if (!reader) {
+            return;
+        }
+        CHECK_RET(jg_parse_doc(reader, doc), JG_OK);
+        jg_arr_get_t * arr = NULL;
+        size_t elem_c = 0;
+        CHECK_RET(jg_root_get_arr(reader, NULL, &arr, &elem_c), JG_OK);
+        CHECK(elem_c == TEST_DOC_OBJ_C);
+        for (size_t i = 0; arr && i < elem_c; i++) {
+            jg_obj_get_t * obj = NULL;
+            CHECK_RET(jg_arr_get_obj(reader, arr, i, NULL, &obj), JG_OK);
+            for (size_t j = TEST_DOC_KEY_C; j--;) {
+                char key[32];
+                snprintf(key, sizeof(key), "k%zu", j);
+                size_t v = 0;
+                CHECK_RET(jg_obj_get_sizet(reader, obj, key, NULL, &v), JG_OK);
+                CHECK(v == i * TEST_DOC_KEY_C + j);
+            }
+        }
+        jg_free(reader);
+    }
+}
+
+// Feeding in small chunks regrows the feed buffer several times.
+static void test_freeze_fed_tape(
+    jg_t * jg
+) {
+    static char json_text[TEST_DOC_OBJ_C * TEST_DOC_KEY_C * 16];
+    size_t byte_c = print_doc_json_text(json_text, sizeof(json_text));
+    jg_opt_parse const opts[] = {{.tape = true},
+        {.tape = true, .trust_unique_keys = true}};
+    for (size_t i = 0; i < sizeof(opts) / sizeof(*opts); i++) {
+        jg_reinit(jg);
+        CHECK_RET(jg_parse_set_opt(jg, opts + i), JG_OK);
+        CHECK_RET(jg_parse_begin(jg, 0), JG_OK);
+        for (size_t j = 0; j < byte_c; j += 100) {
+            CHECK_RET(jg_parse_feed(jg, json_text + j,
+                byte_c - j < 100 ? byte_c - j : 100), JG_OK);
+        }
+        CHECK_PARSE(jg_parse_end(jg));
+        jg_doc_t * doc = NULL;
+        CHECK_PARSE(jg_freeze(jg, &doc));
+        check_doc_readers(doc);
+        jg_doc_release(doc);
+    }
+}
+
+// jg_load_image() indexes no objects, so jg_freeze() has to.
+static void test_freeze_image(
+    jg_t * jg
+) {
+    static char json_text[TEST_DOC_OBJ_C * TEST_DOC_KEY_C * 16];
+    size_t byte_c = print_doc_json_text(json_text, sizeof(json_text));
+    char const * filepath = "jg_test.image";
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, &(jg_opt_parse){.tape = true}), JG_OK);
+    CHECK_PARSE(jg_parse_callerstr(jg, json_text, byte_c));
+    CHECK_PARSE(jg_save_image(jg, filepath));
+    jg_reinit(jg);
+    CHECK_RET(jg_parse_set_opt(jg, NULL), JG_OK);
+    jg_ret ret = jg_load_image(jg, filepath);
+    remove(filepath); // The mapping outlives the file's directory entry.
+    CHECK_PARSE(ret);
+    jg_doc_t * doc = NULL;
+    CHECK_PARSE(jg_freeze(jg, &doc));
+    check_doc_readers(doc);
+    jg_doc_release(doc);
+}
+
+//##############################################################################
+//## jg_watch_...() ############################################################
+
+#define TEST_WATCH_FILEPATH "jg_test_watch.json"
+
+// Write the text to a temporary file, then rename that over filepath (or keep
+// it under its temporary name if filepath is NULL), the way editors save.
+static bool save_file(
+    char const * filepath,
+    char const * json_text
+) {
+    char const * tmp_filepath = TEST_WATCH_FILEPATH ".tmp";
+    FILE * f = fopen(tmp_filepath, "w");
+    CHECK(f);
+    if (!f) {
+        return false;
+    }
+    fputs(json_text, f);
+    fclose(f);
+    return !filepath || !rename(tmp_filepath, filepath);
+}
+
+// The "v" of the document published last, or -1 if it can't be gotten
+static int get_watched_v(
+    jg_watch_t * watch
+) {
+    jg_doc_t * doc = jg_watch_get_doc(watch);
+    jg_t * reader = jg_init();
+    int v = -1;
+    jg_obj_get_t * obj = NULL;
+    if (reader && jg_parse_doc(reader, doc) == JG_OK &&
+        jg_root_get_obj(reader, NULL, &obj) == JG_OK &&
+        jg_obj_get_int(reader, obj, "v", NULL, &v) != JG_OK) {
+        v = -1;
+    }
+    jg_free(reader);
+    jg_doc_release(doc);
+    return v;
+}
+
+// Each (atomic) save publishes exactly one new document, unless it fails to
+// parse; and on Linux, writes to other files in the directory are ignored.
+static void test_watch(
+    jg_t * jg
+) {
+    if (!save_file(TEST_WATCH_FILEPATH, "{\"v\": 1}")) {
+        return;
+    }
+    jg_reinit(jg);
+    jg_watch_t * watch = NULL;
+    CHECK_PARSE(jg_watch_init(jg, TEST_WATCH_FILEPATH, &watch));
+    CHECK(get_watched_v(watch) == 1);
+    bool is_updated = true;
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_OK);
+    CHECK(!is_updated);
+#ifdef __linux__
+    // Were the temporary file's events heeded, the watched file would be read,
+    // and found missing.
+    remove(TEST_WATCH_FILEPATH);
+    save_file(NULL, "{\"v\": 0}");
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_OK);
+    CHECK(!is_updated);
+    CHECK(get_watched_v(watch) == 1);
+#endif
+    CHECK(save_file(TEST_WATCH_FILEPATH, "{\"v\": 2}"));
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_OK);
+    CHECK(is_updated);
+    CHECK(get_watched_v(watch) == 2);
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_OK);
+    CHECK(!is_updated);
+
+    CHECK(save_file(TEST_WATCH_FILEPATH, "{\"v\": 3"));
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_E_PARSE_UNTERM_OBJ);
+    CHECK(!is_updated);
+    CHECK(get_watched_v(watch) == 2);
+    CHECK(save_file(TEST_WATCH_FILEPATH, "{\"v\": 4}"));
+    CHECK_RET(jg_watch_update(jg, watch, &is_updated), JG_OK);
+    CHECK(is_updated);
+    CHECK(get_watched_v(watch) == 4);
+    jg_watch_free(watch);
+    remove(TEST_WATCH_FILEPATH);
+}
+
+int main(
+    void
+) {
+    jg_t * jg = jg_init();
+    if (!jg) {
+        fprintf(stderr, "jg_init() failed\n");
+        return 1;
+    }
+    test_scan();
+    test_utf8(jg);
+    test_unterm_str(jg);
+    test_parse_file_mmap(jg);
+    test_lazy(jg);
+    test_lazy_errors(jg);
+    test_nested_same_key(jg);
+    test_key_index(jg);
+    test_dup_keys(jg);
+    test_arena(jg);
+    test_tape(jg);
+    test_max_depth(jg);
+    test_arr_get_array(jg);
+    test_obj_iter(jg);
+    test_get_flo(jg);
+    test_get_int_bounds(jg);
+    test_decode_numbers(jg);
+    test_parallel(jg);
+    test_ndjson_lines(jg);
+    test_ndjson(jg);
+    test_feed(jg);
+    test_pool();
+    test_retention(jg);
+    test_unescape_in_place(jg);
+    test_strview(jg);
+    test_image(jg);
+    test_image_invalid(jg);
+    test_freeze_fed_tape(jg);
+    test_freeze_image(jg);
+    test_watch(jg);
+    jg_free(jg);
+    if (fail_c) {
+        fprintf(stderr, "%d check(s) failed\n", fail_c);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
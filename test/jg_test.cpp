@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT
+// Copyright © 2021 MetaWord Inc
+// Copyright © 2019-2021 William Budd
+
+#include <jgrandson.h>
+#include <iostream>
+
+static int fail_c = 0;
+
+#define CHECK(_cond) do { \
+    if (!(_cond)) { \
+        std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #_cond \
+            ") failed\n"; \
+        fail_c++; \
+    } \
+} while (0)
+
+#define CHECK_THROW(_expr, _err) do { \
+    try { \
+        _expr; \
+        std::cerr << __FILE__ << ":" << __LINE__ << ": " #_expr \
+            " did not throw " #_err "\n"; \
+        fail_c++; \
+    } catch (_err const &) {} \
+} while (0)
+
+//##############################################################################
+//## jg::ObjGet ################################################################
+
+// Keys are gotten and looked up unescaped, whereas values are gotten by the
+// position of their pair.
+static void test_obj_get_key() {
+    jg::Root root;
+    root.parse_str("{\"a\\\"b\": 1, \"c\": {\"d\\u00e9\": [2, 3]}, \"e\": 4}");
+    auto obj = root.get_obj();
+    CHECK(obj.get_keys() == (std::vector<std::string>{"a\"b", "c", "e"}));
+    CHECK(obj["a\"b"].get_int() == 1);
+    CHECK(obj.get_key() == "a\"b");
+    CHECK(obj.get_keyview() == "a\"b");
+    CHECK_THROW(obj["a\\\"b"], jg::ErrGetKey);
+    CHECK(obj["e"].get_int() == 4);
+    CHECK(obj[0].get_key() == "a\"b"); // Rewinds
+    auto child = obj["c"].get_obj();
+    CHECK(child.get_key() == "d\xC3\xA9");
+    CHECK(child["d\xC3\xA9"].get_arr()[1].get_int() == 3);
+    std::vector<std::string> keys;
+    for (auto const & pair : root.get_obj()) {
+        keys.push_back(pair.get_key());
+    }
+    CHECK(keys == obj.get_keys());
+
+    // Only an empty default object makes the ..._defa() getters return defa.
+    root = jg::Root();
+    root.parse_str("{\"a\": {\"b\": 5}}");
+    obj = root.get_obj();
+    CHECK(obj["a"].get_obj_defa()["b"].get_int_defa(6) == 5);
+    root = jg::Root();
+    root.parse_str("{\"a\": {}}");
+    auto empty = root.get_obj()["a"].get_obj_defa();
+    CHECK(empty.get_keys().empty());
+    CHECK(empty.get_int_defa(6) == 6);
+}
+
+int main() {
+    try {
+        test_obj_get_key();
+    } catch (jg::Err const & e) {
+        std::cerr << "Uncaught: " << e.what() << "\n";
+        fail_c++;
+    }
+    if (fail_c) {
+        std::cerr << fail_c << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}